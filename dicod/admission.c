@@ -0,0 +1,313 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <dicod.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+/* Admission control.
+
+   Connection and command rates are limited using token buckets.  Each
+   source address has a bucket for connections and another one for
+   commands.  Once the client authenticates, its commands are charged
+   to a bucket keyed by the user name instead.
+
+   The buckets live in a table shared between the master and its
+   children: the master charges connections before forking, the children
+   charge commands.  The table is kept in a memory-mapped temporary file,
+   whose descriptor also serves for locking it.  Statistics are kept in
+   the same region, so that any child can report the server-wide state. */
+
+unsigned int accept_queue_size;
+unsigned int accept_queue_timeout = 10;
+unsigned int connection_rate;
+unsigned int connection_burst;
+unsigned int command_rate;
+unsigned int command_burst;
+unsigned int user_command_rate;
+unsigned int user_command_burst;
+unsigned int command_delay = 2;
+int shed_policy = SHED_EXPENSIVE;
+
+#define ADMISSION_TABLE_SIZE 1021
+#define ADMISSION_PROBE 8
+#define ADMISSION_KEY_MAX 64
+
+struct token_bucket {
+    double tokens;            /* Tokens available */
+    struct timeval stamp;     /* Time of the last refill */
+};
+
+struct admission_entry {
+    char key[ADMISSION_KEY_MAX];
+    struct token_bucket conn; /* Connections */
+    struct token_bucket cmd;  /* Commands */
+    time_t atime;             /* Time of the last access */
+};
+
+struct admission_table {
+    struct dicod_admission_stat stat;
+    struct admission_entry ent[ADMISSION_TABLE_SIZE];
+};
+
+static struct admission_table *adm;
+static int adm_fd = -1;
+
+void
+dicod_admission_init(void)
+{
+    FILE *fp;
+
+    if (adm)
+	return;
+    fp = tmpfile();
+    if (!fp)
+	dico_log(L_ERR, errno, _("cannot create admission table"));
+    else {
+	int fd = dup(fileno(fp));
+	fclose(fp);
+	if (fd == -1)
+	    dico_log(L_ERR, errno, _("cannot create admission table"));
+	else if (ftruncate(fd, sizeof(*adm))) {
+	    dico_log(L_ERR, errno, _("cannot create admission table"));
+	    close(fd);
+	} else {
+	    void *p = mmap(NULL, sizeof(*adm), PROT_READ|PROT_WRITE,
+			   MAP_SHARED, fd, 0);
+	    if (p == MAP_FAILED) {
+		dico_log(L_ERR, errno, _("cannot map admission table"));
+		close(fd);
+	    } else {
+		adm = p;
+		adm_fd = fd;
+		return;
+	    }
+	}
+    }
+    dico_log(L_WARN, 0,
+	     _("admission limits will not be shared between sessions"));
+    adm = xzalloc(sizeof(*adm));
+}
+
+static void
+admission_lock(int type)
+{
+    struct flock lk;
+
+    if (adm_fd == -1)
+	return;
+    lk.l_type = type;
+    lk.l_whence = SEEK_SET;
+    lk.l_start = 0;
+    lk.l_len = 0;
+    while (fcntl(adm_fd, F_SETLKW, &lk) == -1 && errno == EINTR)
+	;
+}
+
+#define admission_unlock() admission_lock(F_UNLCK)
+
+struct dicod_admission_stat *
+dicod_admission_stat(void)
+{
+    if (!adm)
+	dicod_admission_init();
+    return &adm->stat;
+}
+
+static size_t
+key_hash(const char *key)
+{
+    size_t h = 5381;
+    while (*key)
+	h = h * 33 + (unsigned char) *key++;
+    return h % ADMISSION_TABLE_SIZE;
+}
+
+/* Find the table entry for KEY.  If there is none, take over the empty
+   or least recently used slot in its probe sequence.  Must be called
+   with the table locked. */
+static struct admission_entry *
+admission_lookup(const char *key, time_t now)
+{
+    size_t i, h = key_hash(key);
+    struct admission_entry *victim = NULL;
+
+    for (i = 0; i < ADMISSION_PROBE; i++) {
+	struct admission_entry *ent =
+	    &adm->ent[(h + i) % ADMISSION_TABLE_SIZE];
+	if (strcmp(ent->key, key) == 0) {
+	    ent->atime = now;
+	    return ent;
+	}
+	if (!victim || ent->atime < victim->atime)
+	    victim = ent;
+    }
+    memset(victim, 0, sizeof(*victim));
+    strncpy(victim->key, key, sizeof(victim->key) - 1);
+    victim->atime = now;
+    return victim;
+}
+
+/* Refill the bucket B and take one token from it.  RATE is the number of
+   tokens added per minute, BURST is the bucket capacity.  Return 0 on
+   success.  Otherwise, store in *WAIT the number of seconds until the
+   next token becomes available and return 1. */
+static int
+bucket_take(struct token_bucket *b, unsigned rate, unsigned burst,
+	    struct timeval *now, double *wait)
+{
+    if (burst == 0)
+	burst = rate;
+    if (b->stamp.tv_sec == 0)
+	b->tokens = burst;
+    else {
+	double elapsed = (now->tv_sec - b->stamp.tv_sec)
+	                 + (now->tv_usec - b->stamp.tv_usec) / 1e6;
+	if (elapsed > 0)
+	    b->tokens += elapsed * rate / 60;
+	if (b->tokens > burst)
+	    b->tokens = burst;
+    }
+    b->stamp = *now;
+    if (b->tokens >= 1) {
+	b->tokens -= 1;
+	return 0;
+    }
+    *wait = (1 - b->tokens) * 60 / rate;
+    return 1;
+}
+
+/* Format the address part of SA into BUF.  Return NULL if connections
+   from this address family are not subject to rate limiting. */
+static char *
+addr_key(struct sockaddr *sa, char *buf, size_t size)
+{
+    char addrstr[INET6_ADDRSTRLEN];
+    void *ap;
+
+    switch (sa->sa_family) {
+    case AF_INET:
+	ap = &((struct sockaddr_in*)sa)->sin_addr;
+	break;
+
+    case AF_INET6:
+	ap = &((struct sockaddr_in6*)sa)->sin6_addr;
+	break;
+
+    default:
+	return NULL;
+    }
+    if (!inet_ntop(sa->sa_family, ap, addrstr, sizeof(addrstr)))
+	return NULL;
+    snprintf(buf, size, "addr:%s", addrstr);
+    return buf;
+}
+
+int
+dicod_admission_connection(struct sockaddr *sa)
+{
+    char key[ADMISSION_KEY_MAX];
+    struct timeval now;
+    double wait;
+    int rc;
+
+    if (connection_rate == 0 || !addr_key(sa, key, sizeof(key)))
+	return 0;
+    if (!adm)
+	dicod_admission_init();
+    gettimeofday(&now, NULL);
+    admission_lock(F_WRLCK);
+    rc = bucket_take(&admission_lookup(key, now.tv_sec)->conn,
+		     connection_rate, connection_burst, &now, &wait);
+    if (rc)
+	adm->stat.conn_limited++;
+    admission_unlock();
+    return rc;
+}
+
+static void
+delay(double t)
+{
+    struct timeval tv;
+
+    tv.tv_sec = (time_t) t;
+    tv.tv_usec = (t - tv.tv_sec) * 1000000;
+    select(0, NULL, NULL, NULL, &tv);
+}
+
+int
+dicod_admission_command(dico_stream_t str, struct dicod_command *cmd)
+{
+    char key[ADMISSION_KEY_MAX];
+    unsigned rate, burst;
+    double waited = 0;
+
+    if (shed_policy == SHED_EXPENSIVE && !(cmd->flags & DICOD_CMD_EXPENSIVE))
+	return 0;
+    if (user_name && user_command_rate) {
+	snprintf(key, sizeof(key), "user:%s", user_name);
+	rate = user_command_rate;
+	burst = user_command_burst;
+    } else if (command_rate
+	       && addr_key((struct sockaddr *)&client_addr, key, sizeof(key))) {
+	rate = command_rate;
+	burst = command_burst;
+    } else
+	return 0;
+
+    if (!adm)
+	dicod_admission_init();
+    for (;;) {
+	struct timeval now;
+	double wait;
+	int rc;
+
+	gettimeofday(&now, NULL);
+	admission_lock(F_WRLCK);
+	rc = bucket_take(&admission_lookup(key, now.tv_sec)->cmd,
+			 rate, burst, &now, &wait);
+	if (rc) {
+	    if (waited + wait > command_delay)
+		adm->stat.cmd_shed++;
+	    else if (waited == 0)
+		adm->stat.cmd_delayed++;
+	}
+	admission_unlock();
+	if (rc == 0)
+	    return 0;
+	if (waited + wait > command_delay)
+	    break;
+	delay(wait);
+	waited += wait;
+    }
+
+    dico_log(L_NOTICE, 0, _("%s: command rate limit exceeded"), key + 5);
+    stream_writez(str, "420 Too many requests, try again later\n");
+    return 1;
+}
+
+void
+dicod_admission_format(dico_stream_t str)
+{
+    struct dicod_admission_stat *st = dicod_admission_stat();
+
+    stream_printf(str,
+		  "admission: %lu queued (%lu waiting, %lu timed out), "
+		  "%lu connections refused, "
+		  "%lu commands delayed, %lu refused",
+		  st->queued, st->queue_length, st->queue_timeouts,
+		  st->conn_limited, st->cmd_delayed, st->cmd_shed);
+}
@@ -186,6 +186,11 @@ dicod_show_server(dico_stream_t str, int argc, char **argv)
 	}
     }
     stream_writez(str, "\n");
+    if (timing_option && show_sys_info_p()
+	&& mode == MODE_DAEMON && !single_process) {
+	dicod_admission_format(str);
+	stream_writez(str, "\n");
+    }
     if (server_info) {
 	stream_write_multiline(ostr, server_info);
 	stream_writez(ostr, "\n");
@@ -233,18 +238,23 @@ dicod_match(dico_stream_t str, int argc, char **argv)
     if (!strat) 
 	stream_writez(str,
 		      "551 Invalid strategy, use SHOW STRAT for a list\n");
-    else if (strcmp(dbname, "!") == 0) 
-	dicod_match_word_first(str, strat, word);
-    else if (strcmp(dbname, "*") == 0) 
-	dicod_match_word_all(str, strat, word);
     else {
-	dicod_database_t *db = find_database(dbname);
+	dicod_match_budget_start(strat);
+	if (strcmp(dbname, "!") == 0) 
+	    dicod_match_word_first(str, strat, word);
+	else if (strcmp(dbname, "*") == 0) 
+	    dicod_match_word_all(str, strat, word);
+	else {
+	    dicod_database_t *db = find_database(dbname);
     
-	if (!db) 
-	    stream_writez(str,
-			  "550 invalid database, use SHOW DB for a list\n");
-	else
-	    dicod_match_word_db(db, str, strat, word);
+	    if (!db) 
+		stream_writez(str,
+			      "550 invalid database, use SHOW DB for a list\n");
+	    else
+		dicod_match_word_db(db, str, strat, word);
+	}
+	dico_budget_stop();
+	dico_result_limit_set(0);
     }
     access_log(argc, argv);
 }
@@ -275,10 +285,10 @@ dicod_define(dico_stream_t str, int argc, char **argv)
 
 struct dicod_command command_tab[] = {
     { "DEFINE", 3, 3, "database word", "look up word in database",
-      dicod_define },
+      dicod_define, DICOD_CMD_EXPENSIVE },
     { "MATCH", 4, 4, "database strategy word",
       "match word in database using strategy",
-      dicod_match },
+      dicod_match, DICOD_CMD_EXPENSIVE },
     { "SHOW DB", 2, 2, NULL, "list all accessible databases",
       dicod_show_databases, },
     { "SHOW DATABASES", 2, 2, NULL, "list all accessible databases",
@@ -422,6 +432,8 @@ dicod_handle_command(dico_stream_t str, int argc, char **argv)
 	stream_writez(str, "501 wrong number of arguments\n");
     else if (!cmd->handler)
 	stream_writez(str, "502 command is not yet implemented, sorry\n");
+    else if (dicod_admission_command(str, cmd))
+	/* Reply already sent */;
     else
 	cmd->handler(str, argc, argv);
 
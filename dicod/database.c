@@ -200,4 +200,15 @@ dicod_database_flags(dicod_database_t const *db)
 	return mod->dico_db_flags(db->mod_handle) & DICO_DBF_MASK;
     return DICO_DBF_DEFAULT;
 }
+
+/* Let the module bring the in-memory data of DB up to date.  This is
+   called in the main process before serving a connection, so that the
+   connection inherits the fresh data. */
+void
+dicod_database_refresh(dicod_database_t *db)
+{
+    struct dico_database_module *mod = db->instance->module;
+    if (db->mod_handle && mod->dico_version > 3 && mod->dico_db_refresh)
+	mod->dico_db_refresh(db->mod_handle);
+}
     
@@ -58,22 +58,16 @@ output_capabilities(dico_stream_t str)
 static void
 initial_banner(dico_stream_t str)
 {
-    dico_stream_write(str, "220 ", 4);
-    stream_writez(str, hostname);
-    dico_stream_write(str, " ", 1);
-    if (initial_banner_text)
-	stream_writez(str, initial_banner_text);
-    else
-	stream_writez(str, (char*) program_version);
-    dico_stream_write(str, " ", 1);
+    stream_writezv(str, "220 ", hostname, " ",
+		   initial_banner_text ? initial_banner_text
+		                       : (char*) program_version,
+		   " ", NULL);
     output_capabilities(str);
-    dico_stream_write(str, " ", 1);
     asprintf(&msg_id, "<%lu.%lu@%s>",
 	     (unsigned long) getpid(),
 	     (unsigned long) time(NULL),
 	     hostname);
-    stream_writez(str, msg_id);
-    dico_stream_write(str, "\n", 1);
+    stream_writezv(str, " ", msg_id, "\n", NULL);
 }
 
 int
@@ -81,6 +75,9 @@ get_input_line(dico_stream_t str, char **buf, size_t *size, size_t *rdbytes)
 {
     int rc;
     alarm(inactivity_timeout);
+    /* Replies are buffered: send them out before waiting for input.
+       The alarm is already set, in case the client does not read them. */
+    dico_stream_flush(str);
     rc = dico_stream_getline(str, buf, size, rdbytes);
     alarm(0);
     return rc;
@@ -256,6 +253,18 @@ soundex_sel(int cmd, dico_key_t key, const char *dict_word)
     }
     return 0;
 }
+
+/* Soundex key derivation function */
+static int
+soundex_key(const char *word, char **keys)
+{
+    char code[DICO_SOUNDEX_SIZE];
+
+    if (dico_soundex(word, code))
+	return -1;
+    keys[0] = strdup(code);
+    return keys[0] ? 1 : -1;
+}
 	    
 void
 dicod_init_strategies(void)
@@ -264,7 +273,10 @@ dicod_init_strategies(void)
 	{ "exact", "Match words exactly", exact_sel },
 	{ "prefix", "Match word prefixes", prefix_sel },
 	{ "suffix", "Match word suffixes", suffix_sel },
-	{ "soundex", "Match using SOUNDEX algorithm", soundex_sel, NULL },
+	{ .name = "soundex",
+	  .descr = "Match using SOUNDEX algorithm",
+	  .sel = soundex_sel,
+	  .keyfn = soundex_key },
     };
     int i;
     for (i = 0; i < DICO_ARRAY_SIZE(defstrat); i++)
@@ -357,6 +369,7 @@ dicod_loop(dico_stream_t str)
 	dicod_handle_command(iostr, tb.tb_tokc, tb.tb_tokv);
     }
     dico_tokenize_end(&tb);
+    dico_stream_flush(iostr);
     close_databases();    
     init_auth_data();
     access_log_free_cache();
@@ -386,11 +399,29 @@ dicod_inetd(void)
 dico_stream_t
 dicod_iostream(int ifd, int ofd)
 {
-    dico_stream_t str = dico_fd_io_stream_create(ifd, ofd);
-	
-    if (!str)
+    dico_stream_t in, out, str;
+
+    /* Both directions of the connection are fully buffered, so that
+       each request is read and each reply is sent with as few system
+       calls as possible.  Output is flushed before reading the next
+       request (see get_input_line).  The I/O stream itself needs no
+       buffer. */
+    in = dico_fd_stream_create(ifd, DICO_STREAM_READ, 0);
+    if (!in)
+	return NULL;
+    out = dico_fd_stream_create(ofd, DICO_STREAM_WRITE, 0);
+    if (!out) {
+	dico_stream_destroy(&in);
+	return NULL;
+    }
+    dico_stream_set_buffer(in, dico_buffer_full, DICO_MAX_BUFFER);
+    dico_stream_set_buffer(out, dico_buffer_full, DICO_MAX_BUFFER);
+    str = dico_io_stream(in, out);
+    if (!str) {
+	dico_stream_destroy(&in);
+	dico_stream_destroy(&out);
         return NULL;
-    dico_stream_set_buffer(str, dico_buffer_line, DICO_MAX_BUFFER);
+    }
     if (!isatty(ifd)) {
 	dico_stream_t s = dico_crlf_stream(str,
 					   DICO_STREAM_READ|DICO_STREAM_WRITE,
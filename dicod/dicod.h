@@ -65,6 +65,8 @@ extern dico_list_t /* of gid_t */ group_list;
 extern unsigned int max_children;
 extern unsigned int shutdown_timeout;
 extern unsigned int inactivity_timeout;
+extern unsigned int query_time_limit;
+extern size_t query_compare_limit;
 extern char *hostname;
 extern const char *program_version;
 extern char *initial_banner_text;
@@ -226,10 +228,14 @@ struct dicod_command {
     char *param;
     char *help;
     dicod_cmd_fn handler;
+    int flags;
 };
 
 #define DICOD_MAXPARAM_INF (-1)
 
+/* Command flags */
+#define DICOD_CMD_EXPENSIVE 0x01  /* Command searches databases */
+
 void dicod_handle_command(dico_stream_t str, int argc, char **argv);
 void dicod_init_command_tab(void);
 void dicod_add_command(struct dicod_command *cmd);
@@ -251,6 +257,13 @@ int dicod_lang_check(dico_list_t list[2]);
 extern int option_mime;
 void register_mime(void);
 
+/* limit.c */
+extern size_t match_limit;
+extern size_t match_total_limit;
+void register_limit(void);
+size_t dicod_match_limit(void);
+size_t dicod_match_total_limit(void);
+
 /* markup.c */
 void register_markup(void);
 void markup_flush_capa(void);
@@ -281,6 +294,7 @@ int dicod_load_module(dicod_module_instance_t *hptr);
 
 dico_list_t dicod_langlist_copy(dico_list_t src);
 
+void dicod_match_budget_start(const dico_strategy_t strat);
 void dicod_match_word_db(dicod_database_t *db, dico_stream_t stream,
 			 const dico_strategy_t strat, const char *word);
 void dicod_match_word_first(dico_stream_t stream,
@@ -309,6 +323,7 @@ dicod_db_result_t *dicod_db_result_alloc(dicod_database_t *db,
 					 dico_result_t res);
 void dicod_db_result_free(dicod_db_result_t *dbr);
 size_t dicod_db_result_count(dicod_db_result_t *dbr);
+void dicod_db_result_truncate(dicod_db_result_t *dbr, size_t n);
 size_t dicod_db_result_compare_count(dicod_db_result_t *dbr);
 int dicod_db_result_output(dicod_db_result_t *dbr, size_t n, dico_stream_t str);
 dico_assoc_list_t dicod_db_result_mime_header(dicod_db_result_t *dbr, size_t n);
@@ -349,6 +364,7 @@ char *dicod_database_get_descr(dicod_database_t *db);
 void dicod_database_free_descr(dicod_database_t *db, char *descr);
 
 int dicod_database_flags(dicod_database_t const *db);
+void dicod_database_refresh(dicod_database_t *db);
 
 void dicod_database_print_definitions(const char *word,
 				      dicod_db_result_t *res, size_t count,
@@ -359,6 +375,36 @@ extern off_t total_bytes_out;
 dico_stream_t dicod_ostream_create(dico_stream_t str,
 				   dico_assoc_list_t headers);
 
+/* admission.c */
+#define SHED_EXPENSIVE 0  /* Limit only expensive commands */
+#define SHED_ALL       1  /* Limit all commands */
+
+extern unsigned int accept_queue_size;
+extern unsigned int accept_queue_timeout;
+extern unsigned int connection_rate;
+extern unsigned int connection_burst;
+extern unsigned int command_rate;
+extern unsigned int command_burst;
+extern unsigned int user_command_rate;
+extern unsigned int user_command_burst;
+extern unsigned int command_delay;
+extern int shed_policy;
+
+struct dicod_admission_stat {
+    unsigned long queued;         /* Connections put on the accept queue */
+    unsigned long queue_length;   /* Connections waiting in the queue now */
+    unsigned long queue_timeouts; /* Connections dropped from the queue */
+    unsigned long conn_limited;   /* Connections refused by rate limit */
+    unsigned long cmd_delayed;    /* Commands delayed by rate limit */
+    unsigned long cmd_shed;       /* Commands refused by rate limit */
+};
+
+void dicod_admission_init(void);
+struct dicod_admission_stat *dicod_admission_stat(void);
+int dicod_admission_connection(struct sockaddr *sa);
+int dicod_admission_command(dico_stream_t str, struct dicod_command *cmd);
+void dicod_admission_format(dico_stream_t str);
+
 /* stat.c */
 void begin_timing(const char *name);
 void report_timing(dico_stream_t stream, xdico_timer_t t,
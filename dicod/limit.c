@@ -0,0 +1,102 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <dicod.h>
+
+/* Limits set in the configuration file. */
+size_t match_limit;
+size_t match_total_limit;
+
+/* Limits requested by the client. */
+static size_t option_match_limit;
+static size_t option_match_total_limit;
+
+/* Return the lesser of two limits, zero meaning no limit. */
+static size_t
+limit_min(size_t a, size_t b)
+{
+    if (a == 0)
+	return b;
+    if (b == 0)
+	return a;
+    return a < b ? a : b;
+}
+
+size_t
+dicod_match_limit(void)
+{
+    return limit_min(match_limit, option_match_limit);
+}
+
+size_t
+dicod_match_total_limit(void)
+{
+    return limit_min(match_total_limit, option_match_total_limit);
+}
+
+static int
+parse_limit(const char *arg, size_t *ret)
+{
+    char *p;
+    unsigned long n;
+
+    errno = 0;
+    n = strtoul(arg, &p, 10);
+    if (*p || errno || arg[0] == '-')
+	return 1;
+    *ret = n;
+    return 0;
+}
+
+static void
+print_limit(dico_stream_t str, size_t n)
+{
+    if (n)
+	stream_printf(str, "%lu", (unsigned long) n);
+    else
+	stream_writez(str, "unlimited");
+}
+
+static void
+dicod_option_limit(dico_stream_t str, int argc, char **argv)
+{
+    size_t n, total = 0;
+
+    if (parse_limit(argv[2], &n)
+	|| (argc > 3 && parse_limit(argv[3], &total))) {
+	stream_writez(str, "501 invalid limit\n");
+	return;
+    }
+    option_match_limit = n;
+    option_match_total_limit = total;
+    stream_writez(str, "250 ok - match limit ");
+    print_limit(str, dicod_match_limit());
+    stream_writez(str, " per database, ");
+    print_limit(str, dicod_match_total_limit());
+    stream_writez(str, " in total\n");
+}
+
+void
+register_limit(void)
+{
+    static struct dicod_command cmd[] = {
+	{ "OPTION LIMIT", 3, 4, "count [total]",
+	  "limit the number of matches",
+	  dicod_option_limit },
+	{ NULL }
+    };
+    dicod_capa_register("limit", cmd, NULL, NULL);
+}
@@ -182,6 +182,123 @@ dicod_any_lang_list_p(dico_list_t list)
 static char nomatch[] = "552 No match";
 static size_t nomatch_len = (sizeof(nomatch)-1);
 
+static char aborted[] = "553 Query aborted: execution budget exhausted";
+static size_t aborted_len = (sizeof(aborted)-1);
+
+/* Start execution budget for a MATCH using strategy STRAT. */
+void
+dicod_match_budget_start(const dico_strategy_t strat)
+{
+    dico_budget_start(strat->time_limit ? strat->time_limit
+		                        : query_time_limit,
+		      strat->compare_limit ? strat->compare_limit
+		                           : query_compare_limit);
+}
+
+/* If the execution budget of the current query is exhausted, log the
+   partial counts, send the 553 reply and return 1.  Otherwise, return 0. */
+static int
+budget_abort(dico_stream_t stream, const dico_strategy_t strat,
+	     const char *word, size_t count)
+{
+    if (!strat || !dico_budget_exhausted())
+	return 0;
+    dico_log(L_NOTICE, 0,
+	     _("MATCH %s \"%s\" aborted: budget exhausted after %lu compares, "
+	       "%lu matches"),
+	     strat->name, word,
+	     (unsigned long) dico_budget_compare_count(),
+	     (unsigned long) count);
+    access_log_status(aborted, aborted);
+    dico_stream_writeln(stream, aborted, aborted_len);
+    return 1;
+}
+
+/* Result count limits for MATCH. */
+struct match_limit {
+    size_t db_limit;      /* Maximum number of matches per database */
+    size_t total_limit;   /* Maximum number of matches in total */
+    size_t total;         /* Number of matches collected so far */
+    int truncated;        /* Some matches were dropped */
+};
+
+static void
+match_limit_init(struct match_limit *ml, const dico_strategy_t strat)
+{
+    if (strat) {
+	ml->db_limit = dicod_match_limit();
+	ml->total_limit = dicod_match_total_limit();
+    } else {
+	ml->db_limit = 0;
+	ml->total_limit = 0;
+    }
+    ml->total = 0;
+    ml->truncated = 0;
+}
+
+/* Set result limit for the next database.  Return 1 if the total
+   limit has already been reached. */
+static int
+match_limit_next(struct match_limit *ml)
+{
+    size_t n = ml->db_limit;
+
+    if (ml->total_limit) {
+	size_t rest;
+	
+	if (ml->total >= ml->total_limit)
+	    return 1;
+	rest = ml->total_limit - ml->total;
+	if (n == 0 || n > rest)
+	    n = rest;
+    }
+    dico_result_limit_set(n);
+    return 0;
+}
+
+/* Account for the matches in RES, dropping the ones above the limit.
+   Return the number of matches to output. */
+static size_t
+match_limit_account(struct match_limit *ml, dicod_db_result_t *res)
+{
+    size_t count = dicod_db_result_count(res);
+    size_t n = dico_result_limit_clip(count);
+
+    if (n < count)
+	dicod_db_result_truncate(res, n);
+    if (dico_result_truncated())
+	ml->truncated = 1;
+    ml->total += n;
+    return n;
+}
+
+/* The total limit has been reached.  Mark the result as truncated if
+   database DB has at least one match that would be dropped.  Return 1
+   if the result is truncated. */
+static int
+match_limit_probe(struct match_limit *ml, dicod_database_t *db,
+		  const dico_strategy_t strat, const char *word)
+{
+    dicod_db_result_t *res;
+
+    if (ml->truncated)
+	return 1;
+    dico_result_limit_set(1);
+    res = dicod_database_match(db, strat, word);
+    if (res) {
+	if (dicod_db_result_count(res))
+	    ml->truncated = 1;
+	dicod_db_result_free(res);
+    }
+    return ml->truncated;
+}
+
+static inline char const *
+match_limit_note(struct match_limit *ml)
+{
+    return ml->truncated ? " (truncated)" : "";
+}
+
 
 typedef void (*outproc_t)(dicod_db_result_t *res,
 			  const char *word, dico_stream_t stream,
@@ -196,6 +313,7 @@ dicod_word_first(dico_stream_t stream, const char *word,
 {
     dicod_database_t *db;
     dico_iterator_t itr;
+    struct match_limit ml;
 
     begin_timing(tid);
 
@@ -205,17 +323,28 @@ dicod_word_first(dico_stream_t stream, const char *word,
 	return;
     }
 
+    match_limit_init(&ml, strat);
     itr = xdico_list_iterator(database_list);
     for (db = dico_iterator_first(itr); db; db = dico_iterator_next(itr)) {
 	if (database_is_visible(db) && !database_is_virtual(db)) {
-	    dicod_db_result_t *res = strat
-		? dicod_database_match(db, strat, word)
-		: dicod_database_define(db, word);
+	    dicod_db_result_t *res;
 	    size_t count;
 
-	    if (!res)
+	    match_limit_next(&ml);
+	    res = strat
+		? dicod_database_match(db, strat, word)
+		: dicod_database_define(db, word);
+	    if (!res) {
+		if (budget_abort(stream, strat, word, 0))
+		    break;
 		continue;
-	    count = dicod_db_result_count(res);
+	    }
+	    count = match_limit_account(&ml, res);
+
+	    if (budget_abort(stream, strat, word, count)) {
+		dicod_db_result_free(res);
+		break;
+	    }
 
 	    if (count) {
 		if (strat)
@@ -223,7 +352,8 @@ dicod_word_first(dico_stream_t stream, const char *word,
 		else
 		    current_stat.defines = count;
 		current_stat.compares = dicod_db_result_compare_count(res);
-		stream_printf(stream, begfmt, (unsigned long) count);
+		stream_printf(stream, begfmt, (unsigned long) count,
+			      match_limit_note(&ml));
 		proc(res, word, stream, data, count);
 		stream_writez(stream, (char*) endmsg);
 		report_current_timing(stream, tid);
@@ -242,6 +372,13 @@ dicod_word_first(dico_stream_t stream, const char *word,
     }
 }
 
+static int
+free_db_result(void *item, void *data)
+{
+    dicod_db_result_free(item);
+    return 0;
+}
+
 void
 dicod_word_all(dico_stream_t stream, const char *word,
 	       const dico_strategy_t strat,
@@ -253,6 +390,7 @@ dicod_word_all(dico_stream_t stream, const char *word,
     dico_list_t reslist = xdico_list_create();
     size_t total = 0;
     dicod_db_result_t *rp;
+    struct match_limit ml;
 
     begin_timing(tid);
 
@@ -262,17 +400,28 @@ dicod_word_all(dico_stream_t stream, const char *word,
 	return;
     }
 
+    match_limit_init(&ml, strat);
     itr = xdico_list_iterator(database_list);
     for (db = dico_iterator_first(itr); db; db = dico_iterator_next(itr)) {
 	if (database_is_visible(db) && !database_is_virtual(db)) {
-	    dicod_db_result_t *res = strat
-		? dicod_database_match(db, strat, word)
-		: dicod_database_define(db, word);
+	    dicod_db_result_t *res;
 	    size_t count;
 
-	    if (!res)
+	    if (match_limit_next(&ml)) {
+		if (match_limit_probe(&ml, db, strat, word)
+		    || dico_budget_exhausted())
+		    break;
 		continue;
-	    count = dicod_db_result_count(res);
+	    }
+	    res = strat
+		? dicod_database_match(db, strat, word)
+		: dicod_database_define(db, word);
+	    if (!res) {
+		if (strat && dico_budget_exhausted())
+		    break;
+		continue;
+	    }
+	    count = match_limit_account(&ml, res);
 	    if (!count) {
 		dicod_db_result_free(res);
 		continue;
@@ -281,12 +430,16 @@ dicod_word_all(dico_stream_t stream, const char *word,
 	    total += count;
 	    current_stat.compares += dicod_db_result_compare_count(res);
 	    xdico_list_append(reslist, res);
+	    if (strat && dico_budget_exhausted())
+		break;
 	}
     }
 
     dico_iterator_destroy(&itr);
 
-    if (total == 0) {
+    if (budget_abort(stream, strat, word, total)) {
+	dico_list_set_free_item(reslist, free_db_result, NULL);
+    } else if (total == 0) {
 	access_log_status(nomatch, nomatch);
 	dico_stream_writeln(stream, nomatch, nomatch_len);
     } else {
@@ -296,7 +449,8 @@ dicod_word_all(dico_stream_t stream, const char *word,
 	    current_stat.matches = total;
 	else
 	    current_stat.defines = total;
-	stream_printf(stream, begfmt, (unsigned long) total);
+	stream_printf(stream, begfmt, (unsigned long) total,
+		      match_limit_note(&ml));
 	for (rp = dico_iterator_first(itr); rp; rp = dico_iterator_next(itr)) {
 	    proc(rp, word, stream, data, dicod_db_result_count(rp));
 	    dicod_db_result_free(rp);
@@ -320,8 +474,7 @@ print_matches(dicod_db_result_t *res,
 
     for (i = 0; i < count; i++) {
 	dicod_database_t *db = dicod_db_result_db(res, i, result_db_visible);
-	stream_writez(ostr, db->name);
-	dico_stream_write(ostr, " \"", 2);
+	stream_writezv(ostr, db->name, " \"", NULL);
 	dicod_db_result_output(res, i, ostr);
 	dico_stream_write(ostr, "\"\n", 2);
     }
@@ -333,18 +486,28 @@ dicod_match_word_db(dicod_database_t *db, dico_stream_t stream,
 {
     dicod_db_result_t *res;
     size_t count;
+    struct match_limit ml;
 
     begin_timing("match");
 
+    match_limit_init(&ml, strat);
+    match_limit_next(&ml);
     res = dicod_database_match(db, strat, word);
 
     if (!res) {
-	access_log_status(nomatch, nomatch);
-	dico_stream_writeln(stream, nomatch, nomatch_len);
+	if (!budget_abort(stream, strat, word, 0)) {
+	    access_log_status(nomatch, nomatch);
+	    dico_stream_writeln(stream, nomatch, nomatch_len);
+	}
+	return;
+    }
+
+    count = match_limit_account(&ml, res);
+    if (budget_abort(stream, strat, word, count)) {
+	dicod_db_result_free(res);
 	return;
     }
 
-    count = dicod_db_result_count(res);
     if (count == 0) {
 	access_log_status(nomatch, nomatch);
 	dico_stream_writeln(stream, nomatch, nomatch_len);
@@ -353,8 +516,8 @@ dicod_match_word_db(dicod_database_t *db, dico_stream_t stream,
 
 	current_stat.matches = count;
 	current_stat.compares = dicod_db_result_compare_count(res);
-	stream_printf(stream, "152 %lu matches found: list follows\n",
-		      (unsigned long) count);
+	stream_printf(stream, "152 %lu matches found%s: list follows\n",
+		      (unsigned long) count, match_limit_note(&ml));
 	ostr = dicod_ostream_create(stream, NULL);
 	print_matches(res, word, stream, ostr, count);
 	total_bytes_out += dico_stream_bytes_out(ostr);
@@ -376,7 +539,7 @@ dicod_match_word_first(dico_stream_t stream,
 {
     dico_stream_t ostr = dicod_ostream_create(stream, NULL);
     dicod_word_first(stream, word, strat,
-		     "152 %lu matches found: list follows\n",
+		     "152 %lu matches found%s: list follows\n",
 		     ".\n250 Command complete",
 		     print_matches, ostr, "match");
     total_bytes_out += dico_stream_bytes_out(ostr);
@@ -390,7 +553,7 @@ dicod_match_word_all(dico_stream_t stream,
 {
     dico_stream_t ostr = dicod_ostream_create(stream, NULL);
     dicod_word_all(stream, word, strat,
-		   "152 %lu matches found: list follows\n",
+		   "152 %lu matches found%s: list follows\n",
 		   ".\n250 Command complete",
 		   print_matches, ostr, "match");
     total_bytes_out += dico_stream_bytes_out(ostr);
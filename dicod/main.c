@@ -41,6 +41,10 @@ unsigned int max_children = 64;
 unsigned int shutdown_timeout = 5;
 /* Inactivity timeout */
 unsigned int inactivity_timeout = 0;
+/* Default execution budget for a MATCH command: wall time in milliseconds
+   and number of compares.  Zero means unlimited. */
+unsigned int query_time_limit = 0;
+size_t query_compare_limit = 0;
 
 /* Syslog parameters: */
 int log_to_stderr;  /* Log to stderr */
@@ -472,6 +476,73 @@ set_mode(enum grecs_callback_command cmd,
     return 0;
 }
 
+static int
+set_shed_policy(enum grecs_callback_command cmd,
+		grecs_locus_t *locus,
+		void *varptr,
+		grecs_value_t *value,
+		void *cb_data)
+{
+    static struct xlat_tab tab[] = {
+	{ "expensive", SHED_EXPENSIVE },
+	{ "all", SHED_ALL },
+	{ NULL }
+    };
+
+    if (cmd != grecs_callback_set_value) {
+	grecs_error(locus, 0, _("Unexpected block statement"));
+	return 1;
+    }
+
+    if (value->type != GRECS_TYPE_STRING) {
+	grecs_error(locus, 0, _("expected scalar value but found list"));
+	return 1;
+    }
+    if (xlat_c_string(tab, value->v.string, 0, &shed_policy)) {
+	grecs_error(locus, 0, _("unknown shedding policy"));
+	return 1;
+    }
+    return 0;
+}
+
+struct grecs_keyword kwd_admission[] = {
+    { "accept-queue-size", N_("number"),
+      N_("Number of connections to keep waiting when all children are "
+	 "busy."),
+      grecs_type_uint, GRECS_DFLT, &accept_queue_size },
+    { "accept-queue-timeout", N_("seconds"),
+      N_("Refuse queued connections that were not served within this "
+	 "number of seconds."),
+      grecs_type_uint, GRECS_DFLT, &accept_queue_timeout },
+    { "connection-rate", N_("number"),
+      N_("Maximum number of connections per minute from a single address."),
+      grecs_type_uint, GRECS_DFLT, &connection_rate },
+    { "connection-burst", N_("number"),
+      N_("Number of connections a single address can open at once."),
+      grecs_type_uint, GRECS_DFLT, &connection_burst },
+    { "command-rate", N_("number"),
+      N_("Maximum number of commands per minute from a single address."),
+      grecs_type_uint, GRECS_DFLT, &command_rate },
+    { "command-burst", N_("number"),
+      N_("Number of commands a single address can issue at once."),
+      grecs_type_uint, GRECS_DFLT, &command_burst },
+    { "user-command-rate", N_("number"),
+      N_("Maximum number of commands per minute from an authenticated "
+	 "user."),
+      grecs_type_uint, GRECS_DFLT, &user_command_rate },
+    { "user-command-burst", N_("number"),
+      N_("Number of commands an authenticated user can issue at once."),
+      grecs_type_uint, GRECS_DFLT, &user_command_burst },
+    { "command-delay", N_("seconds"),
+      N_("Delay rate-limited commands for at most this number of seconds "
+	 "before refusing them."),
+      grecs_type_uint, GRECS_DFLT, &command_delay },
+    { "shed-policy", N_("arg: expensive|all"),
+      N_("Select commands subject to rate limiting."),
+      grecs_type_string, GRECS_DFLT, NULL, 0, set_shed_policy },
+    { NULL }
+};
+
 static struct xlat_tab syslog_facility_tab[] = {
     { "USER",    LOG_USER },
     { "DAEMON",  LOG_DAEMON },
@@ -1040,9 +1111,13 @@ flush_strat_forward_fn(void *item, void *data)
 {
     dico_strategy_t strat = item;
     dico_strategy_t p = dico_list_locate(strat_forward, strat->name);
-    if (p && p->stratcl) {
-	strat->stratcl = p->stratcl;
-	p->stratcl = NULL;
+    if (p) {
+	if (p->stratcl) {
+	    strat->stratcl = p->stratcl;
+	    p->stratcl = NULL;
+	}
+	strat->time_limit = p->time_limit;
+	strat->compare_limit = p->compare_limit;
     }
     return 0;
 }
@@ -1294,6 +1369,16 @@ struct grecs_keyword kwd_strategy[] = {
       grecs_type_string, GRECS_DFLT,
       NULL, offsetof(struct dico_strategy, stratcl),
       strategy_deny_length_ne_cb, },
+    { "time-limit", N_("msec"),
+      N_("Abort MATCH requests using this strategy after <msec> "
+	 "milliseconds."),
+      grecs_type_uint, GRECS_DFLT,
+      NULL, offsetof(struct dico_strategy, time_limit) },
+    { "compare-limit", N_("number"),
+      N_("Abort MATCH requests using this strategy after <number> "
+	 "compares."),
+      grecs_type_size, GRECS_DFLT,
+      NULL, offsetof(struct dico_strategy, compare_limit) },
     { NULL }
 };
 
@@ -1354,6 +1439,21 @@ struct grecs_keyword keywords[] = {
     { "inactivity-timeout", N_("seconds"),
       N_("Set inactivity timeout."),
       grecs_type_uint, GRECS_DFLT, &inactivity_timeout },
+    { "query-time-limit", N_("msec"),
+      N_("Abort MATCH requests that run longer than <msec> milliseconds."),
+      grecs_type_uint, GRECS_DFLT, &query_time_limit },
+    { "query-compare-limit", N_("number"),
+      N_("Abort MATCH requests after <number> compares."),
+      grecs_type_size, GRECS_DFLT, &query_compare_limit },
+    { "match-limit", N_("number"),
+      N_("Return at most <number> matches from each database."),
+      grecs_type_size, GRECS_DFLT, &match_limit },
+    { "match-total-limit", N_("number"),
+      N_("Return at most <number> matches in total."),
+      grecs_type_size, GRECS_DFLT, &match_total_limit },
+    { "admission", NULL,
+      N_("Control admission of connections and commands."),
+      grecs_type_section, GRECS_DFLT, NULL, 0, NULL, NULL, kwd_admission },
     { "listen", N_("addr"), N_("Listen on these addresses."),
       grecs_type_sockaddr, GRECS_LIST, &listen_addr, 0, cb_dico_sockaddr_list },
     { "initial-banner-text", N_("text"),
@@ -1743,6 +1843,7 @@ main(int argc, char **argv)
     udb_init();
     register_auth();
     register_mime();
+    register_limit();
     register_lang();
     register_markup();
     register_xidle();
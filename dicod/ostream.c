@@ -21,11 +21,36 @@ off_t total_bytes_out;
 #define OSTREAM_INITIALIZED       0x01
 #define OSTREAM_DESTROY_TRANSPORT 0x02
 
+/* Maximum length of an output line in MIME mode */
+#define OSTREAM_MAXLEN   1024
+/* Maximum number of pieces collected before writing them out */
+#define OSTREAM_IOV_MAX  32
+
+/* Output stream for textual responses.
+
+   Each line of text is written out in a single pass, which does line
+   trimming, dot-stuffing and, if the transport is a CRLF stream that
+   has no pending output, CRLF translation.  In the latter case the
+   result goes directly to the transport of the CRLF stream.  The output
+   is collected in a vector of pieces of the caller's buffer interleaved
+   with the inserted characters, which is written with a single call.
+
+   Transfer encodings other than 8bit are handled by a filter stream
+   installed over the transport. */
 struct ostream {
     dico_stream_t transport;
     off_t nout;
     int flags;
     dico_assoc_list_t headers;
+    
+    dico_stream_t bypass;    /* Transport of the CRLF stream, or NULL */
+    const char *eol;         /* End of line sequence used with bypass */
+    size_t maxlen;           /* Maximum line length, 0 if unlimited */
+    size_t linelen;          /* Length of the current line, in characters */
+    int bol;                 /* At the beginning of a line */
+    int cr;                  /* Last character written was CR */
+    struct iovec iov[OSTREAM_IOV_MAX];
+    int iovcnt;
 };
 
 static int
@@ -39,58 +64,171 @@ print_headers(struct ostream *ostr)
 	struct dico_assoc *p;
 	
 	itr = dico_assoc_iterator(ostr->headers);
-	for (p = dico_iterator_first(itr); p; p = dico_iterator_next(itr)) {
-	    dico_stream_write(ostr->transport, p->key, strlen(p->key));
-	    dico_stream_write(ostr->transport, ": ", 2);
-	    dico_stream_write(ostr->transport, p->value, strlen(p->value));
-	    dico_stream_write(ostr->transport, "\n", 1);
-	}
+	for (p = dico_iterator_first(itr); p; p = dico_iterator_next(itr))
+	    stream_writezv(ostr->transport, p->key, ": ", p->value, "\n",
+			   NULL);
 	dico_iterator_destroy(&itr);
     }
     
     rc = dico_stream_write(ostr->transport, "\n", 1);
     
     if (rc == 0) {
-	dico_stream_t str;
-	
 	if ((enc = dico_assoc_find(ostr->headers,
 				   CONTENT_TRANSFER_ENCODING_HEADER))
 	    && strcmp(enc, "8bit")) {
-	    str = dico_codec_stream_create(enc, FILTER_ENCODE,
-					   ostr->transport);
-	} else {
-	    str = dico_linetrim_stream(ostr->transport, 1024, 1);
-	}
-	if (str) {
-	    ostr->transport = str;
-	    ostr->flags |= OSTREAM_DESTROY_TRANSPORT;
-	}    
+	    dico_stream_t str = dico_codec_stream_create(enc, FILTER_ENCODE,
+							 ostr->transport);
+	    if (str) {
+		ostr->transport = str;
+		ostr->flags |= OSTREAM_DESTROY_TRANSPORT;
+	    }
+	} else
+	    ostr->maxlen = OSTREAM_MAXLEN;
     }
     return rc;
 }
 
+/* Select the stream to write the encoded output to. */
+static void
+ostream_init_output(struct ostream *ostr)
+{
+    dico_stream_t next;
+    
+    if (!(ostr->flags & OSTREAM_DESTROY_TRANSPORT)
+	&& dico_stream_ioctl(ostr->transport, DICO_IOCTL_GET_EOL,
+			     &ostr->eol) == 0
+	&& dico_stream_ioctl(ostr->transport, DICO_IOCTL_GET_TRANSPORT,
+			     &next) == 0
+	&& next)
+	ostr->bypass = next;
+}
+
+static int
+ostream_flush_iov(struct ostream *ostr, dico_stream_t out)
+{
+    int n = ostr->iovcnt;
+    
+    ostr->iovcnt = 0;
+    if (n && dico_stream_writev(out, ostr->iov, n))
+	return dico_stream_last_error(out);
+    return 0;
+}
+
+static int
+ostream_put(struct ostream *ostr, dico_stream_t out,
+	    const char *buf, size_t size)
+{
+    int rc;
+    
+    if (size == 0)
+	return 0;
+    if (ostr->iovcnt == OSTREAM_IOV_MAX
+	&& (rc = ostream_flush_iov(ostr, out)))
+	return rc;
+    ostr->iov[ostr->iovcnt].iov_base = (void*) buf;
+    ostr->iov[ostr->iovcnt].iov_len = size;
+    ostr->iovcnt++;
+    return 0;
+}
+
+/* Count the characters of the line segment [BUF, END) in the current
+   line length.  If the line becomes too long, return the position to
+   break it at: the start of the last word, if it begins past BUF, or
+   the character which would exceed the limit otherwise.  Return NULL if
+   the segment fits. */
+static const char *
+ostream_line_break(struct ostream *ostr, const char *buf, const char *end)
+{
+    const char *p, *word = NULL;
+    int inword = 0;
+    
+    for (p = buf; p < end; ) {
+	size_t n = utf8_char_width(p);
+	int ws = *p == ' ' || *p == '\t';
+
+	if (!ws && !inword)
+	    word = p;
+	inword = !ws;
+	if (++ostr->linelen >= ostr->maxlen)
+	    return word && word > buf ? word : p;
+	p += n ? n : 1;
+    }
+    return NULL;
+}
+
+static int
+ostream_encode(struct ostream *ostr, dico_stream_t out, const char *eol,
+	       const char *buf, size_t size)
+{
+    const char *end = buf + size;
+    int rc;
+    
+    while (buf < end) {
+	const char *nl = memchr(buf, '\n', end - buf);
+	const char *p = nl ? nl : end;
+	const char *brk = NULL;
+	
+	if (ostr->bol && *buf == '.' && (rc = ostream_put(ostr, out, ".", 1)))
+	    return rc;
+	if (ostr->maxlen
+	    && (!nl || ostr->linelen + (p - buf) >= ostr->maxlen))
+	    brk = ostream_line_break(ostr, buf, p);
+	if (brk)
+	    p = brk;
+	if ((rc = ostream_put(ostr, out, buf, p - buf)))
+	    return rc;
+	if (p > buf)
+	    ostr->cr = p[-1] == '\r';
+	if (brk || nl) {
+	    /* A newline preceded by CR is left as is, as the CRLF stream
+	       does. */
+	    if ((rc = ostream_put(ostr, out, ostr->cr ? "\n" : eol,
+				  ostr->cr ? 1 : strlen(eol))))
+		return rc;
+	    ostr->bol = 1;
+	    ostr->cr = 0;
+	    ostr->linelen = 0;
+	    buf = brk ? brk : nl + 1;
+	} else {
+	    ostr->bol = 0;
+	    buf = p;
+	}
+    }
+    return ostream_flush_iov(ostr, out);
+}
 
 static int
 ostream_write(void *data, const char *buf, size_t size, size_t *pret)
 {
     struct ostream *ostr = data;
+    int rc;
     
     if (!(ostr->flags & OSTREAM_INITIALIZED)) {
 	if (option_mime && print_headers(ostr))
 	    return dico_stream_last_error(ostr->transport);
+	ostream_init_output(ostr);
 	ostr->flags |= OSTREAM_INITIALIZED;
     }
-    if (buf[0] == '.' && dico_stream_write(ostr->transport, ".", 1))
-	return dico_stream_last_error(ostr->transport);
-    *pret = size;
-    return dico_stream_write(ostr->transport, buf, size);
+    /* Bypass the CRLF stream only if that does not reorder the output */
+    if (ostr->bypass && dico_stream_pending(ostr->transport) == 0)
+	rc = ostream_encode(ostr, ostr->bypass, ostr->eol, buf, size);
+    else
+	rc = ostream_encode(ostr, ostr->transport, "\n", buf, size);
+    if (rc == 0)
+	*pret = size;
+    return rc;
 }
 
 static int
 ostream_flush(void *data)
 {
     struct ostream *ostr = data;
-    return dico_stream_flush(ostr->transport);
+    /* The transport is flushed only if it is a filter installed by this
+       stream.  Otherwise, buffered output is sent before reading the
+       next request. */
+    if (ostr->flags & OSTREAM_DESTROY_TRANSPORT)
+	return dico_stream_flush(ostr->transport);
+    return 0;
 }
 
 static int
@@ -117,7 +255,7 @@ ostream_ioctl(void *data, int code, void *call_data)
 	break;
 
     case DICO_IOCTL_BYTES_OUT:
-	dico_stream_flush(ostr->transport);
+	ostream_flush(ostr);
 	*(off_t*)call_data = dico_stream_bytes_out(ostr->transport) -
 	                       ostr->nout;
 	break;
@@ -141,6 +279,13 @@ dicod_ostream_create(dico_stream_t str, dico_assoc_list_t headers)
     ostr->nout = dico_stream_bytes_out(str);
     ostr->flags = 0;
     ostr->headers = headers;
+    ostr->bypass = NULL;
+    ostr->eol = NULL;
+    ostr->maxlen = 0;
+    ostr->linelen = 0;
+    ostr->bol = 1;
+    ostr->cr = 0;
+    ostr->iovcnt = 0;
     dico_stream_set_write(stream, ostream_write);
     dico_stream_set_flush(stream, ostream_flush);
     dico_stream_set_destroy(stream, ostream_destroy);
@@ -18,11 +18,13 @@
 #include <regex.h>
 
 struct regex_flags {
-    int flags;
+    int flags;              /* Flags for regcomp */
+    int pflags;             /* Flags for the prefilter */
 };
     
 struct regex_data {
     regex_t reg;
+    struct dico_regex_prefilter pf;
 };
 
 static int
@@ -44,16 +46,22 @@ regex_sel(int cmd, dico_key_t key, const char *dict_word)
 	    char errbuf[512];
 	    regerror(rc, &rp->reg, errbuf, sizeof(errbuf));
 	    dico_log(L_ERR, 0, _("Regex error: %s"), errbuf);
-	}
+	} else if (dico_regex_prefilter_init(&rp->pf, word, fp->pflags)) {
+	    regfree(&rp->reg);
+	    rc = 1;
+	} else
+	    key->prefix = rp->pf.prefix;
 	break;
 
     case DICO_SELECT_RUN:
-	rc = regexec(&rp->reg, dict_word, 0, NULL, 0) == 0;
+	rc = dico_regex_prefilter_match(&rp->pf, dict_word)
+	      && regexec(&rp->reg, dict_word, 0, NULL, 0) == 0;
 	break;
 	
     case DICO_SELECT_END:
 	rc = 0;
 	regfree(&rp->reg);
+	dico_regex_prefilter_free(&rp->pf);
 	free(rp);
 	break;
     }
@@ -61,11 +69,13 @@ regex_sel(int cmd, dico_key_t key, const char *dict_word)
 }
 
 static struct regex_flags ext_flags = {
-    REG_EXTENDED|REG_ICASE
+    REG_EXTENDED|REG_ICASE,
+    DICO_REGEX_EXTENDED|DICO_REGEX_ICASE
 };
 
 static struct regex_flags basic_flags = {
-    REG_ICASE
+    REG_ICASE,
+    DICO_REGEX_ICASE
 };
 
 static struct dico_strategy re_strat = {
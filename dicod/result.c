@@ -58,6 +58,14 @@ dicod_db_result_count(dicod_db_result_t *dbr)
     return dbr->rcount;
 }
 
+/* Limit the number of results in DBR to N. */
+void
+dicod_db_result_truncate(dicod_db_result_t *dbr, size_t n)
+{
+    if (dicod_db_result_count(dbr) > n)
+	dbr->rcount = n;
+}
+
 size_t
 dicod_db_result_compare_count(dicod_db_result_t *dbr)
 {
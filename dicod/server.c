@@ -373,40 +373,129 @@ socklen_t client_addrlen;
 #define TEMP_FAIL_MSG "420 Server temporarily unavailable\n"
 #define SWRITE(fd, s) write(fd, s, sizeof(s)-1)
 
-int
-handle_connection(int n)
+/* Accept queue.
+
+   When all child slots are busy, accepted connections are kept in this
+   queue until a slot becomes free.  Connections that are not served
+   within accept_queue_timeout seconds are refused. */
+struct pending_conn {
+    int fd;                            /* Connection socket */
+    int srv;                           /* Index of the server in srvtab */
+    struct sockaddr_storage addr;      /* Client address */
+    socklen_t addrlen;
+    time_t expire;                     /* Refuse after this moment */
+};
+
+static struct pending_conn *pendq;
+static size_t pend_head;
+static size_t pend_count;
+
+static int
+pending_enqueue(int n, int fd)
 {
-    int status = 0;
-    int connfd;
-    int listenfd = srvtab[n].fd;
+    struct pending_conn *p;
 
-    server_addr = *srvtab[n].addr;
-    server_addrlen = srvtab[n].addrlen;
-    
-    client_addrlen = sizeof(client_addr);
-    connfd = accept(listenfd, (struct sockaddr*) &client_addr,
-		    &client_addrlen);
+    if (pend_count >= accept_queue_size)
+	return 1;
+    if (!pendq)
+	pendq = xcalloc(accept_queue_size, sizeof(pendq[0]));
+    p = &pendq[(pend_head + pend_count) % accept_queue_size];
+    p->fd = fd;
+    p->srv = n;
+    p->addr = client_addr;
+    p->addrlen = client_addrlen;
+    p->expire = time(NULL) + accept_queue_timeout;
+    pend_count++;
+    dicod_admission_stat()->queued++;
+    dicod_admission_stat()->queue_length = pend_count;
+    return 0;
+}
 
-    if (connfd == -1) {
-	if (errno == EINTR)
-	    return -1;
-	dico_log(L_ERR, errno, "accept");
-	return -1;
-	/*exit (EXIT_FAILURE);*/
-    }
+static struct pending_conn *
+pending_dequeue(void)
+{
+    struct pending_conn *p = &pendq[pend_head];
+    pend_head = (pend_head + 1) % accept_queue_size;
+    pend_count--;
+    dicod_admission_stat()->queue_length = pend_count;
+    return p;
+}
 
-    if (dicod_acl_check(connect_acl, 1) == 0) {
-	char *p = sockaddr_to_astr((struct sockaddr *)&client_addr,
-				   client_addrlen);
-	dico_log(L_NOTICE, 0,
-		 _("connection from %s denied"),
-		 p);
-	free(p);
-	SWRITE(connfd, ACCESS_DENIED_MSG);
-	close(connfd);
-	return 0;
+/* Close queued connections in the child process. */
+static void
+pending_close(void)
+{
+    size_t i;
+
+    for (i = 0; i < pend_count; i++)
+	close(pendq[(pend_head + i) % accept_queue_size].fd);
+}
+
+/* Compute time left until the oldest queued connection expires. */
+static struct timeval *
+pending_timeout(struct timeval *tv)
+{
+    time_t now;
+
+    if (pend_count == 0)
+	return NULL;
+    now = time(NULL);
+    tv->tv_sec = pendq[pend_head].expire > now
+	          ? pendq[pend_head].expire - now : 0;
+    tv->tv_usec = 0;
+    return tv;
+}
+
+static int serve_connection(int n, int connfd);
+
+static int
+refresh_database(void *item, void *data)
+{
+    dicod_database_refresh(item);
+    return 0;
+}
+
+/* Serve queued connections while there are free child slots, and refuse
+   the ones that have waited too long. */
+static void
+pending_dispatch(void)
+{
+    time_t now = time(NULL);
+
+    while (pend_count) {
+	struct pending_conn *p = &pendq[pend_head];
+
+	if (p->expire <= now) {
+	    char *s;
+	    
+	    p = pending_dequeue();
+	    s = sockaddr_to_astr((struct sockaddr *)&p->addr, p->addrlen);
+	    dico_log(L_NOTICE, 0,
+		     _("connection from %s timed out in accept queue"), s);
+	    free(s);
+	    SWRITE(p->fd, TEMP_FAIL_MSG);
+	    close(p->fd);
+	    dicod_admission_stat()->queue_timeouts++;
+	} else if (num_children < max_children) {
+	    p = pending_dequeue();
+	    client_addr = p->addr;
+	    client_addrlen = p->addrlen;
+	    serve_connection(p->srv, p->fd);
+	} else
+	    break;
     }
+}
 
+static int
+serve_connection(int n, int connfd)
+{
+    int status = 0;
+
+    server_addr = *srvtab[n].addr;
+    server_addrlen = srvtab[n].addrlen;
+
+    database_iterate(refresh_database, NULL);
+    
     if (single_process) {
 	dico_stream_t str = dicod_iostream(connfd, connfd);
 	if (str) {
@@ -424,7 +513,8 @@ handle_connection(int n)
 	    /* Child.  */
 	    dico_stream_t str;
 	    
-	    close(listenfd);
+	    close(srvtab[n].fd);
+	    pending_close();
 	    
 	    signal(SIGTERM, SIG_DFL);
 	    signal(SIGQUIT, SIG_DFL);
@@ -447,6 +537,58 @@ handle_connection(int n)
     return status;
 }
 
+int
+handle_connection(int n)
+{
+    int connfd;
+    int listenfd = srvtab[n].fd;
+
+    client_addrlen = sizeof(client_addr);
+    connfd = accept(listenfd, (struct sockaddr*) &client_addr,
+		    &client_addrlen);
+
+    if (connfd == -1) {
+	if (errno == EINTR)
+	    return -1;
+	dico_log(L_ERR, errno, "accept");
+	return -1;
+	/*exit (EXIT_FAILURE);*/
+    }
+
+    server_addr = *srvtab[n].addr;
+    server_addrlen = srvtab[n].addrlen;
+    
+    if (dicod_acl_check(connect_acl, 1) == 0) {
+	char *p = sockaddr_to_astr((struct sockaddr *)&client_addr,
+				   client_addrlen);
+	dico_log(L_NOTICE, 0,
+		 _("connection from %s denied"),
+		 p);
+	free(p);
+	SWRITE(connfd, ACCESS_DENIED_MSG);
+	close(connfd);
+	return 0;
+    }
+
+    if (dicod_admission_connection((struct sockaddr *)&client_addr)) {
+	char *p = sockaddr_to_astr((struct sockaddr *)&client_addr,
+				   client_addrlen);
+	dico_log(L_NOTICE, 0,
+		 _("connection from %s refused: rate limit exceeded"),
+		 p);
+	free(p);
+	SWRITE(connfd, TEMP_FAIL_MSG);
+	close(connfd);
+	return 0;
+    }
+
+    if (!single_process && num_children >= max_children
+	&& pending_enqueue(n, connfd) == 0)
+	return 0;
+    
+    return serve_connection(n, connfd);
+}
+
 static int
 pre_restart_lint_internal(void)
 {
@@ -529,20 +671,28 @@ server_loop(void)
     for (;;) {
 	int rc;
 	fd_set rdset;
+	struct timeval tv;
 
 	if (need_cleanup) {
 	    cleanup_children(0);
 	    need_cleanup = 1;
 	}
 
-	if (num_children > max_children) {
-	    dico_log(L_ERR, 0, _("too many children (%lu)"), num_children);
-	    pause();
-	    continue;
-	}
-
-	rdset = fdset;
-	rc = select (fdmax + 1, &rdset, NULL, NULL, NULL);
+	pending_dispatch();
+	
+	if (num_children >= max_children && pend_count >= accept_queue_size) {
+	    /* Stop accepting connections until a child slot becomes free
+	       or a queued connection expires. */
+	    if (pend_count == 0) {
+		dico_log(L_ERR, 0, _("too many children (%lu)"),
+			 num_children);
+		pause();
+		continue;
+	    }
+	    FD_ZERO(&rdset);
+	} else
+	    rdset = fdset;
+	rc = select (fdmax + 1, &rdset, NULL, NULL, pending_timeout(&tv));
 	if (rc == -1 && errno == EINTR) {
 	    if (stop)
 		break;
@@ -620,6 +770,7 @@ dicod_server(int argc, char **argv)
     open_sockets();
     if (!single_process) 
 	childtab = xcalloc(max_children, sizeof(childtab[0]));
+    dicod_admission_init();
 			   
     rc = server_loop();
 
@@ -0,0 +1,260 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+
+/* Scripted DICT client for testing the admission control of dicod.
+
+   Usage: dictconn -port
+          dictconn PORT < SCRIPT
+
+   The first form prints a free TCP port on the loopback interface.
+   The second one connects to dicod listening on 127.0.0.1:PORT and
+   executes the commands read from the standard input, one per line:
+
+     open N          open connection N
+     send N TEXT     send TEXT followed by CRLF over connection N
+     read N          read a line from connection N and print it
+     reply N         read and print lines from connection N up to and
+                     including the first one with a status code other
+                     than 1xx
+     wait N SECS     read a line, or print "no reply" if none arrives
+                     within SECS seconds
+     close N         close connection N
+
+   Each printed line is prefixed with the connection number. */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+#include <dico.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define MAX_CONN 16
+/* Time to wait for a server reply, in seconds */
+#define REPLY_TIMEOUT 10
+
+struct conn {
+    int fd;
+    char buf[1024];
+    size_t level;
+};
+
+static struct conn conntab[MAX_CONN];
+
+static void
+init_addr(struct sockaddr_in *sa, int port)
+{
+    memset(sa, 0, sizeof(*sa));
+    sa->sin_family = AF_INET;
+    sa->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sa->sin_port = htons(port);
+}
+
+static int
+free_port(void)
+{
+    struct sockaddr_in sa;
+    socklen_t len = sizeof(sa);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (fd == -1) {
+	dico_log(L_ERR, errno, "socket");
+	return 1;
+    }
+    init_addr(&sa, 0);
+    if (bind(fd, (struct sockaddr *) &sa, sizeof(sa))
+	|| getsockname(fd, (struct sockaddr *) &sa, &len)) {
+	dico_log(L_ERR, errno, "bind");
+	return 1;
+    }
+    printf("%d\n", ntohs(sa.sin_port));
+    close(fd);
+    return 0;
+}
+
+/* Connect to the server, retrying for a while if it has not started
+   listening yet. */
+static int
+conn_open(struct conn *conn, int port)
+{
+    struct sockaddr_in sa;
+    int i;
+
+    init_addr(&sa, port);
+    for (i = 0; i < REPLY_TIMEOUT * 10; i++) {
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd == -1) {
+	    dico_log(L_ERR, errno, "socket");
+	    return 1;
+	}
+	if (connect(fd, (struct sockaddr *) &sa, sizeof(sa)) == 0) {
+	    conn->fd = fd;
+	    conn->level = 0;
+	    return 0;
+	}
+	close(fd);
+	if (errno != ECONNREFUSED)
+	    break;
+	usleep(100000);
+    }
+    dico_log(L_ERR, errno, "connect");
+    return 1;
+}
+
+/* Read a line from CONN into BUF, waiting at most TIMEOUT seconds for
+   it.  Return 0 on success, 1 on timeout and -1 on error or EOF. */
+static int
+conn_getline(struct conn *conn, char *buf, size_t size, int timeout)
+{
+    for (;;) {
+	char *p = memchr(conn->buf, '\n', conn->level);
+	struct pollfd pfd;
+	ssize_t n;
+
+	if (p) {
+	    size_t len = p - conn->buf + 1;
+	    size_t k = len;
+	    
+	    while (k > 0 && (conn->buf[k-1] == '\n' || conn->buf[k-1] == '\r'))
+		k--;
+	    if (k >= size)
+		k = size - 1;
+	    memcpy(buf, conn->buf, k);
+	    buf[k] = 0;
+	    memmove(conn->buf, conn->buf + len, conn->level - len);
+	    conn->level -= len;
+	    return 0;
+	}
+	if (conn->level == sizeof(conn->buf)) {
+	    dico_log(L_ERR, 0, "line too long");
+	    return -1;
+	}
+	pfd.fd = conn->fd;
+	pfd.events = POLLIN;
+	n = poll(&pfd, 1, timeout * 1000);
+	if (n == -1) {
+	    if (errno == EINTR)
+		continue;
+	    dico_log(L_ERR, errno, "poll");
+	    return -1;
+	}
+	if (n == 0)
+	    return 1;
+	n = read(conn->fd, conn->buf + conn->level,
+		 sizeof(conn->buf) - conn->level);
+	if (n <= 0) {
+	    if (n == 0)
+		dico_log(L_ERR, 0, "connection closed by server");
+	    else
+		dico_log(L_ERR, errno, "read");
+	    return -1;
+	}
+	conn->level += n;
+    }
+}
+
+static int
+status_line_p(const char *s)
+{
+    return s[0] >= '2' && s[0] <= '5'
+	   && s[1] >= '0' && s[1] <= '9'
+	   && s[2] >= '0' && s[2] <= '9'
+	   && (s[3] == ' ' || s[3] == 0);
+}
+
+int
+main(int argc, char **argv)
+{
+    int port;
+    char cmd[1024];
+    unsigned line = 0;
+    
+    dico_set_program_name(argv[0]);
+
+    if (argc == 2 && strcmp(argv[1], "-port") == 0)
+	return free_port();
+    if (argc != 2) {
+	dico_log(L_ERR, 0, "usage: %s -port | PORT < SCRIPT",
+		 dico_program_name);
+	return 1;
+    }
+    port = atoi(argv[1]);
+
+    while (fgets(cmd, sizeof(cmd), stdin)) {
+	char buf[1024];
+	char verb[16];
+	int n, arg = 0, off = 0, rc;
+	struct conn *conn;
+
+	line++;
+	/* Leave room for the CRLF appended by send */
+	if (dico_trim_nl(cmd) > sizeof(cmd) - 3) {
+	    dico_log(L_ERR, 0, "%u: line too long", line);
+	    return 1;
+	}
+	if (cmd[0] == 0 || cmd[0] == '#')
+	    continue;
+	if (sscanf(cmd, "%15s %d %n", verb, &n, &off) < 2
+	    || n < 0 || n >= MAX_CONN) {
+	    dico_log(L_ERR, 0, "%u: malformed command", line);
+	    return 1;
+	}
+	conn = &conntab[n];
+
+	if (strcmp(verb, "open") == 0) {
+	    if (conn_open(conn, port))
+		return 2;
+	} else if (strcmp(verb, "close") == 0) {
+	    close(conn->fd);
+	} else if (strcmp(verb, "send") == 0) {
+	    size_t len = strlen(cmd + off);
+	    memcpy(cmd + off + len, "\r\n", 3);
+	    if (write(conn->fd, cmd + off, len + 2) != len + 2) {
+		dico_log(L_ERR, errno, "write");
+		return 2;
+	    }
+	} else if (strcmp(verb, "read") == 0
+		   || strcmp(verb, "reply") == 0) {
+	    int reply = verb[2] == 'p';
+	    do {
+		if (conn_getline(conn, buf, sizeof(buf), REPLY_TIMEOUT)) {
+		    dico_log(L_ERR, 0, "%u: no reply", line);
+		    return 2;
+		}
+		printf("%d: %s\n", n, buf);
+	    } while (reply && !status_line_p(buf));
+	} else if (strcmp(verb, "wait") == 0) {
+	    arg = atoi(cmd + off);
+	    rc = conn_getline(conn, buf, sizeof(buf), arg);
+	    if (rc == -1)
+		return 2;
+	    printf("%d: %s\n", n, rc ? "no reply" : buf);
+	} else {
+	    dico_log(L_ERR, 0, "%u: unknown command %s", line, verb);
+	    return 1;
+	}
+	fflush(stdout);
+    }
+    return 0;
+}
@@ -21,7 +21,12 @@
 #include <string.h>
 
 /* This module either returns query strings without any changes (echo mode),
-   or denies any queries (null mode). */
+   or denies any queries (null mode).
+
+   In split mode, each result is output twice, on separate lines.  The
+   second copy, except for its last character, is written directly to
+   the transport of the output stream, so that the rest of it is output
+   while the transport has pending data. */
 
 enum echo_mode {
     ECHO_ECHO, /* Operate in echo mode */
@@ -30,10 +35,16 @@ enum echo_mode {
 
 struct dico_handle_struct {
     enum echo_mode mode;
+    int split;
     char *prefix;
     size_t prefix_len;
 };
 
+struct echo_result {
+    int split;
+    char *word;
+};
+
 static int
 echo_init(int argc, char **argv)
 {
@@ -44,11 +55,13 @@ static dico_handle_t
 echo_init_db(const char *dbname, int argc, char **argv)
 {
     int null_mode = 0;
+    int split = 0;
     dico_handle_t hp;
     char *prefix = NULL;
     
     struct dico_option init_db_option[] = {
 	{ DICO_OPTSTR(null), dico_opt_bool, &null_mode },
+	{ DICO_OPTSTR(split), dico_opt_bool, &split },
 	{ DICO_OPTSTR(prefix), dico_opt_string, &prefix },
 	{ NULL }
     };
@@ -59,6 +72,7 @@ echo_init_db(const char *dbname, int argc, char **argv)
     hp = malloc(sizeof(*hp));
     if (hp) {
 	hp->mode = null_mode ? ECHO_NULL : ECHO_ECHO;
+	hp->split = split;
 	if (prefix) {
 	    hp->prefix = strdup(prefix);
 	    if (!hp->prefix) {
@@ -132,14 +146,21 @@ echo_descr(dico_handle_t ep)
 static dico_result_t
 new_result(dico_handle_t ep, char const *word)
 {
-    char *res = malloc(strlen(word) + ep->prefix_len + 1);
-    if (!res)
+    struct echo_result *res = malloc(sizeof(*res));
+    if (!res) {
 	dico_log(L_ERR, 0, "not enough memory");
-    else {
-	if (ep->prefix)
-	    memcpy(res, ep->prefix, ep->prefix_len);
-	strcpy(res + ep->prefix_len, word);
+	return NULL;
     }
+    res->split = ep->split;
+    res->word = malloc(strlen(word) + ep->prefix_len + 1);
+    if (!res->word) {
+	dico_log(L_ERR, 0, "not enough memory");
+	free(res);
+	return NULL;
+    }
+    if (ep->prefix)
+	memcpy(res->word, ep->prefix, ep->prefix_len);
+    strcpy(res->word + ep->prefix_len, word);
     return (dico_result_t) res;
 }
 
@@ -162,8 +183,19 @@ echo_define(dico_handle_t ep, const char *word)
 static int
 echo_output_result(dico_result_t rp, size_t n, dico_stream_t str)
 {
-    char *word = (char*)rp;
-    dico_stream_write(str, word, strlen(word));
+    struct echo_result *res = (struct echo_result *)rp;
+    size_t len = strlen(res->word);
+    
+    dico_stream_write(str, res->word, len);
+    if (res->split && len > 0) {
+	dico_stream_t transport;
+	
+	dico_stream_write(str, "\n", 1);
+	if (dico_stream_ioctl(str, DICO_IOCTL_GET_TRANSPORT, &transport))
+	    return 1;
+	dico_stream_write(transport, res->word, len - 1);
+	dico_stream_write(str, res->word + len - 1, 1);
+    }
     return 0;
 }
 
@@ -182,7 +214,9 @@ echo_compare_count(dico_result_t rp)
 static void
 echo_free_result(dico_result_t rp)
 {
-    free(rp);
+    struct echo_result *res = (struct echo_result *)rp;
+    free(res->word);
+    free(res);
 }
 
 static char *
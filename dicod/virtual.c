@@ -186,11 +186,16 @@ virtual_match(dico_handle_t vdb, const dico_strategy_t strat, const char *word)
     size_t i;
     size_t n = vdb->vdb_count;
     struct dico_result_struct *result = virtual_result_new(vdb);
+    size_t total = 0;
     
     for (i = 0; i < n; i++) {
+	if (dico_budget_exhausted() || dico_result_limit_reached(total))
+	    break;
 	if (vdb_member_ok(&vdb->vdb_memb[i])) {
 	    result->vdres[i] = dicod_database_match(vdb->vdb_memb[i].db,
 						    strat, word);
+	    if (result->vdres[i])
+		total += dicod_db_result_count(result->vdres[i]);
 	} else {
 	    result->vdres[i] = NULL;
 	}
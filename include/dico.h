@@ -24,6 +24,7 @@
 #include <dico/argcv.h>
 #include <dico/list.h>
 #include <dico/assoc.h>
+#include <dico/cache.h>
 #include <dico/stream.h>
 #include <dico/url.h>
 #include <dico/xlat.h>
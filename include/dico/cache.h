@@ -0,0 +1,31 @@
+/* This file is part of Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef __dico_cache_h
+#define __dico_cache_h
+
+#include <dico/types.h>
+
+/* Bounded LRU cache */
+dico_cache_t dico_cache_create(size_t max_size, void (*freefn)(void *));
+void dico_cache_destroy(dico_cache_t *pcache);
+int dico_cache_fits(dico_cache_t cache, size_t size);
+void *dico_cache_lookup(dico_cache_t cache, const void *key, size_t keylen);
+int dico_cache_insert(dico_cache_t cache, const void *key, size_t keylen,
+		      void *data, size_t size);
+
+#endif
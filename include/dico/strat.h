@@ -27,13 +27,29 @@ struct dico_strategy {
     void *closure;          /* Additional data for SEL */ 
     int is_default;         /* True, if this is a default strategy */
     dico_list_t stratcl;    /* Strategy access control list */  
+    unsigned time_limit;    /* Query time limit in milliseconds (0 - use
+			       the global default) */
+    size_t compare_limit;   /* Maximum number of compares per query (0 -
+			       use the global default) */
+    int flags;              /* Strategy flags (see below) */
+    dico_strat_keyfn_t keyfn; /* Key derivation function (can be NULL) */
 };
 
+/* Strategy flags */
+#define DICO_STRAT_PREFIX_PAGE 0x01 /* Paginated prefix search:
+				       [skip#count#]prefix */
+#define DICO_STRAT_SUBSTR      0x02 /* Substring search; modules may use
+				       a trigram index to find
+				       candidates */
+
 struct dico_key {
     char *word;
     void *call_data;
     dico_strategy_t strat;
     int flags;
+    const char *prefix;     /* If not NULL, all words selected by the key
+			       begin with this prefix (compared ignoring
+			       case).  Set by the selector. */
 };
 
 int dico_strat_name_cmp(const void *item, const void *data, void *closure);
@@ -56,5 +72,93 @@ int dico_key_init(struct dico_key *key, dico_strategy_t strat,
 		  const char *word);
 int dico_key_match(struct dico_key *key, const char *word);
 
+/* Query execution budget */
+void dico_budget_start(unsigned long time_limit, size_t compare_limit);
+void dico_budget_stop(void);
+int dico_budget_check(void);
+int dico_budget_exhausted(void);
+size_t dico_budget_compare_count(void);
+
+/* Paginated prefix search */
+struct dico_prefix_page {
+    char const *prefix;     /* Prefix to look for */
+    size_t skip;            /* Skip this number of unique matches */
+    size_t count;           /* Return at most this number of matches */
+    int lim;                /* If false, skip and count are not used */
+};
+
+int dico_prefix_page_parse(const dico_strategy_t strat, const char *word,
+			   struct dico_prefix_page *pg);
+int dico_prefix_page_full(struct dico_prefix_page const *pg, size_t count);
+size_t *dico_run_index_create(const void *base, size_t nelem, size_t elsize,
+			      int (*comp)(const void *, const void *, void *),
+			      void *closure);
+size_t dico_run_index_seek(const size_t *runs, size_t nelem, size_t start,
+			   size_t skip);
+
+/* Function returning Nth headword of a database */
+typedef const char *(*dico_index_word_t)(size_t, void *);
+
+/* Trigram index */
+typedef struct dico_trigram_index *dico_trigram_index_t;
+
+dico_trigram_index_t dico_trigram_index_create(size_t nelem,
+					       dico_index_word_t getword,
+					       void *closure);
+void dico_trigram_index_free(dico_trigram_index_t idx);
+int dico_trigram_index_lookup(dico_trigram_index_t idx, const char *word,
+			      size_t **pcand, size_t *pcount);
+
+/* Derived key index */
+typedef struct dico_key_index *dico_key_index_t;
+
+dico_key_index_t dico_key_index_create(dico_strat_keyfn_t keyfn,
+				       size_t nelem,
+				       dico_index_word_t getword,
+				       void *closure);
+void dico_key_index_free(dico_key_index_t idx);
+dico_strat_keyfn_t dico_key_index_keyfn(dico_key_index_t idx);
+int dico_key_index_lookup(dico_key_index_t idx, const char *word,
+			  size_t **pcand, size_t *pcount);
+
+/* Headword search index */
+typedef struct dico_search_index *dico_search_index_t;
+
+#define DICO_SEARCH_CI 0x01       /* Case-insensitive keys */
+
+dico_search_index_t dico_search_index_create(size_t nelem,
+					     dico_index_word_t getword,
+					     void *closure, int flags);
+void dico_search_index_free(dico_search_index_t idx);
+int dico_search_index_range(dico_search_index_t idx, const char *word,
+			    int prefix, size_t *pstart, size_t *pend);
+
+/* Regular expression prefilter */
+#define DICO_REGEX_EXTENDED 0x01  /* POSIX extended syntax */
+#define DICO_REGEX_PCRE     0x02  /* Perl-compatible syntax */
+#define DICO_REGEX_ICASE    0x04  /* Case-insensitive matching */
+#define DICO_REGEX_ANCHORED 0x08  /* Pattern is anchored at start */
+
+struct dico_regex_prefilter {
+    int flags;              /* Pattern flags (see above) */
+    char *prefix;           /* Literal prefix, or NULL */
+    size_t prefix_len;      /* Its length */
+    char *literal;          /* Longest required literal, or NULL */
+    size_t literal_len;     /* Its length */
+};
+
+int dico_regex_prefilter_init(struct dico_regex_prefilter *pf,
+			      const char *pattern, int flags);
+void dico_regex_prefilter_free(struct dico_regex_prefilter *pf);
+int dico_regex_prefilter_match(struct dico_regex_prefilter const *pf,
+			       const char *word);
+
+/* Result count limit */
+void dico_result_limit_set(size_t limit);
+size_t dico_result_limit(void);
+int dico_result_limit_reached(size_t count);
+size_t dico_result_limit_clip(size_t count);
+int dico_result_truncated(void);
+
 
 #endif
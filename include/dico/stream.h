@@ -17,6 +17,7 @@
 #ifndef __dico_stream_h
 #define __dico_stream_h
 
+#include <sys/uio.h>
 
 /* Streams */
 
@@ -46,6 +47,9 @@ void dico_stream_set_read(dico_stream_t stream,
 void dico_stream_set_write(dico_stream_t stream,    
 			   int (*writefn) (void *, const char *, size_t,
 					   size_t *));
+void dico_stream_set_writev(dico_stream_t stream,
+			    int (*writevfn) (void *, const struct iovec *, int,
+					     size_t *));
 void dico_stream_set_flush(dico_stream_t stream, int (*flushfn) (void *));
 void dico_stream_set_close(dico_stream_t stream, int (*closefn) (void *));
 void dico_stream_set_destroy(dico_stream_t stream, int (*destroyfn) (void *));
@@ -77,6 +81,8 @@ int dico_stream_getline(dico_stream_t stream, char **pbuf, size_t *psize,
 			size_t *pread);
 int dico_stream_write(dico_stream_t stream, const void *buf, size_t size);
 int dico_stream_writeln(dico_stream_t stream, const char *buf, size_t size);
+int dico_stream_writev(dico_stream_t stream, const struct iovec *iov,
+		       int iovcnt);
 
 const char *dico_stream_strerror(dico_stream_t stream, int rc);
 int dico_stream_last_error(dico_stream_t stream);
@@ -84,6 +90,7 @@ void dico_stream_clearerr(dico_stream_t stream);
 int dico_stream_eof(dico_stream_t stream);
 
 int dico_stream_flush(dico_stream_t stream);
+size_t dico_stream_pending(dico_stream_t stream);
 int dico_stream_close(dico_stream_t stream);
 void dico_stream_destroy(dico_stream_t *stream);
 
@@ -105,6 +112,7 @@ int dico_stream_ioctl(dico_stream_t stream, int code, void *ptr);
 #define DICO_IOCTL_BYTES_OUT     6
 #define DICO_IOCTL_SET_LINELEN   7
 #define DICO_IOCTL_GET_LINELEN   8
+#define DICO_IOCTL_GET_EOL       9
 
 
 /* FD streams */
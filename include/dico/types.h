@@ -45,6 +45,7 @@ typedef struct dico_line_buffer *dico_linebuf_t;
 typedef struct dico_stream *dico_stream_t;
 typedef struct dico_list *dico_list_t;
 typedef struct dico_assoc_list *dico_assoc_list_t;
+typedef struct dico_cache *dico_cache_t;
 typedef struct iterator *dico_iterator_t;
 
 typedef struct dico_handle_struct *dico_handle_t;
@@ -59,8 +60,13 @@ typedef struct dicod_database dicod_database_t;
 #define DICO_SELECT_RUN   1
 #define DICO_SELECT_END   2
 typedef int (*dico_select_t) (int, dico_key_t, const char *);
+/* Key derivation function.  Stores at most DICO_STRAT_MAX_KEYS
+   malloc'ed keys of the word in the array and returns their number, or
+   -1 on error.  Words selected by the strategy have a key in common. */
+#define DICO_STRAT_MAX_KEYS 2
+typedef int (*dico_strat_keyfn_t) (const char *, char **);
 
-#define DICO_MODULE_VERSION 3
+#define DICO_MODULE_VERSION 4
 
 #define DICO_CAPA_NONE       0
 #define DICO_CAPA_NODB       0x0001
@@ -98,6 +104,7 @@ struct dico_database_module {
 				       void *extra);
     int (*dico_db_flags) (dico_handle_t hp);
     dicod_database_t *(*dico_result_db)(dico_result_t rp, size_t n);
+    void (*dico_db_refresh) (dico_handle_t hp);
 };
 
 #endif
@@ -42,6 +42,7 @@ int utf8_iter_first(struct utf8_iterator *itr, char *ptr);
 int utf8_iter_next(struct utf8_iterator *itr);
 
 int utf8_mbtowc_internal (void *data, int (*read) (void*), unsigned int *pwc);
+int utf8_mbtowc (unsigned int *pwc, const char *r, size_t len);
 int utf8_wctomb (char *r, unsigned int wc);
 
 int utf8_symcmp(char *a, char *b);
@@ -65,6 +66,9 @@ unsigned utf8_wc_toupper (unsigned wc);
 int utf8_toupper (char *s);
 unsigned utf8_wc_tolower (unsigned wc);
 int utf8_tolower (char *s);
+unsigned utf8_wc_fold (unsigned wc);
+int utf8_casefold (const char *str, char **sptr);
+int utf8_casefold_wc (const char *str, unsigned **wptr, size_t *plen);
 size_t utf8_wc_strlen (const unsigned *s);
 unsigned *utf8_wc_strdup (const unsigned *s);
 size_t utf8_wc_hash_string (const unsigned *ws, size_t n_buckets);
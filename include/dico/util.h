@@ -24,6 +24,9 @@ size_t dico_trim_ws(char *buf);
 int dico_sort(void *base, size_t nmemb, size_t size,
 	      int (*comp)(const void *, const void *, void *),
 	      void *closure);
+int dico_psort(void *base, size_t nmemb, size_t size,
+	       int (*comp)(const void *, const void *, void *),
+	       void *closure);
 void *dico_bsearch(void *key, const void *base, size_t nelem, size_t elsize,
 		   int (*comp) (const void *, const void *, void *),
 		   void *closure);
@@ -79,6 +79,7 @@ dico_stream_t xdico_transcript_stream_create(dico_stream_t transport,
 
 /* xstream.c */
 int stream_writez(dico_stream_t str, const char *buf);
+int stream_writezv(dico_stream_t str, ...);
 int stream_printf(dico_stream_t str, const char *fmt, ...);
 void stream_write_multiline(dico_stream_t str, const char *text);
 
@@ -0,0 +1,159 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <config.h>
+#include <dico.h>
+#include <sys/time.h>
+#include <string.h>
+
+/* Query execution budget.
+
+   The server starts a budget before running a MATCH command.  Modules
+   that scan their indexes with a selector call dico_budget_check once
+   per headword and stop scanning as soon as it returns non-zero.
+   Checking the wall clock on each call would be too expensive, so the
+   time is sampled once per BUDGET_TIME_CHECK_INTERVAL calls. */
+
+#define BUDGET_TIME_CHECK_INTERVAL 128
+
+static struct dico_budget {
+    int active;                 /* Budget is in effect */
+    int exhausted;              /* Budget ran out */
+    unsigned long time_limit;   /* Wall time limit (milliseconds) */
+    size_t compare_limit;       /* Maximum number of compares */
+    struct timeval deadline;    /* Time when the budget expires */
+    size_t compares;            /* Compares done so far */
+    unsigned tick;              /* Calls since the last time check */
+} budget;
+
+void
+dico_budget_start(unsigned long time_limit, size_t compare_limit)
+{
+    memset(&budget, 0, sizeof(budget));
+    if (time_limit == 0 && compare_limit == 0)
+	return;
+    budget.active = 1;
+    budget.time_limit = time_limit;
+    budget.compare_limit = compare_limit;
+    if (time_limit) {
+	gettimeofday(&budget.deadline, NULL);
+	budget.deadline.tv_sec += time_limit / 1000;
+	budget.deadline.tv_usec += (time_limit % 1000) * 1000;
+	if (budget.deadline.tv_usec >= 1000000) {
+	    budget.deadline.tv_sec++;
+	    budget.deadline.tv_usec -= 1000000;
+	}
+    }
+}
+
+void
+dico_budget_stop(void)
+{
+    memset(&budget, 0, sizeof(budget));
+}
+
+static int
+budget_time_expired(void)
+{
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    return timercmp(&now, &budget.deadline, >=);
+}
+
+int
+dico_budget_check(void)
+{
+    if (!budget.active)
+	return 0;
+    if (budget.exhausted)
+	return 1;
+    budget.compares++;
+    if (budget.compare_limit && budget.compares > budget.compare_limit)
+	budget.exhausted = 1;
+    else if (budget.time_limit
+	     && ++budget.tick >= BUDGET_TIME_CHECK_INTERVAL) {
+	budget.tick = 0;
+	if (budget_time_expired())
+	    budget.exhausted = 1;
+    }
+    return budget.exhausted;
+}
+
+int
+dico_budget_exhausted(void)
+{
+    return budget.exhausted;
+}
+
+size_t
+dico_budget_compare_count(void)
+{
+    return budget.compares;
+}
+
+/* Result count limit.
+
+   Before running a MATCH against a database, the server sets the
+   maximum number of matches it is going to output.  Modules consult
+   the limit while collecting matches and stop as soon as it is
+   reached, so that broad queries do not materialize the whole index.
+   A zero limit means no limit. */
+
+static size_t result_limit;
+static int result_truncated;
+
+void
+dico_result_limit_set(size_t limit)
+{
+    result_limit = limit;
+    result_truncated = 0;
+}
+
+size_t
+dico_result_limit(void)
+{
+    return result_limit;
+}
+
+/* Return 1 if no more results can be added to a set of COUNT results.
+   Call this before adding a new match to the set. */
+int
+dico_result_limit_reached(size_t count)
+{
+    if (result_limit && count >= result_limit) {
+	result_truncated = 1;
+	return 1;
+    }
+    return 0;
+}
+
+/* Return the number of results to keep out of COUNT found. */
+size_t
+dico_result_limit_clip(size_t count)
+{
+    if (result_limit && count > result_limit) {
+	result_truncated = 1;
+	return result_limit;
+    }
+    return count;
+}
+
+int
+dico_result_truncated(void)
+{
+    return result_truncated;
+}
@@ -0,0 +1,208 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include <config.h>
+#include <dico.h>
+#include <string.h>
+#include <errno.h>
+
+/* Bounded cache with least-recently-used eviction.
+
+   Entries are kept in a hash table keyed by an arbitrary byte string,
+   and in a list, most recently used first.  Each entry is accounted
+   with the size given when it was inserted.  When the total size of
+   the entries exceeds the limit, the least recently used ones are
+   evicted.
+
+   Since dicod serves each connection in a separate process, a cache
+   kept by a module holds the data used in the current session and
+   needs no locking. */
+
+#define CACHE_BUCKETS 1021
+
+struct cache_entry {
+    struct cache_entry *prev, *next; /* Neighbors in the LRU list */
+    struct cache_entry *link;        /* Next entry in the hash bucket */
+    unsigned hash;                   /* Hash value of the key */
+    void *data;                      /* Cached data */
+    size_t size;                     /* Size accounted for the entry */
+    size_t keylen;                   /* Length of the key */
+    char key[1];                     /* Key */
+};
+
+struct dico_cache {
+    size_t max_size;                 /* Maximum size */
+    size_t size;                     /* Current size */
+    void (*freefn)(void *);          /* Function to free cached data */
+    struct cache_entry *head, *tail; /* LRU list, most recent first */
+    struct cache_entry **bucket;     /* Hash table */
+};
+
+dico_cache_t
+dico_cache_create(size_t max_size, void (*freefn)(void *))
+{
+    dico_cache_t cache = calloc(1, sizeof(*cache));
+    if (cache) {
+	cache->max_size = max_size;
+	cache->freefn = freefn;
+    }
+    return cache;
+}
+
+static unsigned
+cache_hash(const void *key, size_t keylen)
+{
+    const unsigned char *p = key;
+    unsigned h = 0;
+
+    while (keylen--)
+	h = h * 31 + *p++;
+    return h;
+}
+
+static void
+cache_unlink(dico_cache_t cache, struct cache_entry *ent)
+{
+    if (ent->prev)
+	ent->prev->next = ent->next;
+    else
+	cache->head = ent->next;
+    if (ent->next)
+	ent->next->prev = ent->prev;
+    else
+	cache->tail = ent->prev;
+}
+
+static void
+cache_remove(dico_cache_t cache, struct cache_entry *ent)
+{
+    struct cache_entry **pp;
+
+    for (pp = &cache->bucket[ent->hash % CACHE_BUCKETS]; *pp != ent;
+	 pp = &(*pp)->link)
+	;
+    *pp = ent->link;
+    cache_unlink(cache, ent);
+    cache->size -= ent->size;
+    if (cache->freefn)
+	cache->freefn(ent->data);
+    free(ent);
+}
+
+static struct cache_entry *
+cache_find(dico_cache_t cache, const void *key, size_t keylen)
+{
+    struct cache_entry *ent;
+    unsigned hash;
+
+    if (!cache->bucket)
+	return NULL;
+    hash = cache_hash(key, keylen);
+    for (ent = cache->bucket[hash % CACHE_BUCKETS]; ent; ent = ent->link)
+	if (ent->hash == hash && ent->keylen == keylen
+	    && memcmp(ent->key, key, keylen) == 0)
+	    return ent;
+    return NULL;
+}
+
+/* Return non-zero if an entry of SIZE bytes can be stored in CACHE. */
+int
+dico_cache_fits(dico_cache_t cache, size_t size)
+{
+    return cache && size <= cache->max_size;
+}
+
+/* Look up KEY in CACHE.  On success, make the entry the most recently
+   used one and return its data. */
+void *
+dico_cache_lookup(dico_cache_t cache, const void *key, size_t keylen)
+{
+    struct cache_entry *ent;
+
+    if (!cache || !(ent = cache_find(cache, key, keylen)))
+	return NULL;
+    if (ent != cache->head) {
+	cache_unlink(cache, ent);
+	ent->prev = NULL;
+	ent->next = cache->head;
+	cache->head->prev = ent;
+	cache->head = ent;
+    }
+    return ent->data;
+}
+
+/* Store DATA under KEY, evicting the least recently used entries as
+   needed.  SIZE is the size accounted for the entry.  On success, the
+   cache takes over DATA and will free it using the function given to
+   dico_cache_create.  Return 0 on success and -1 if DATA is too big
+   or there is not enough memory.  In the latter case, the caller
+   retains DATA. */
+int
+dico_cache_insert(dico_cache_t cache, const void *key, size_t keylen,
+		  void *data, size_t size)
+{
+    struct cache_entry *ent;
+
+    if (!dico_cache_fits(cache, size)) {
+	errno = E2BIG;
+	return -1;
+    }
+    if (!cache->bucket) {
+	cache->bucket = calloc(CACHE_BUCKETS, sizeof(cache->bucket[0]));
+	if (!cache->bucket)
+	    return -1;
+    }
+    if ((ent = cache_find(cache, key, keylen)) != NULL)
+	cache_remove(cache, ent);
+    ent = malloc(sizeof(*ent) + keylen);
+    if (!ent)
+	return -1;
+    while (cache->size + size > cache->max_size)
+	cache_remove(cache, cache->tail);
+
+    ent->hash = cache_hash(key, keylen);
+    ent->data = data;
+    ent->size = size;
+    ent->keylen = keylen;
+    memcpy(ent->key, key, keylen);
+    
+    ent->link = cache->bucket[ent->hash % CACHE_BUCKETS];
+    cache->bucket[ent->hash % CACHE_BUCKETS] = ent;
+    ent->prev = NULL;
+    ent->next = cache->head;
+    if (cache->head)
+	cache->head->prev = ent;
+    else
+	cache->tail = ent;
+    cache->head = ent;
+    cache->size += size;
+    return 0;
+}
+
+void
+dico_cache_destroy(dico_cache_t *pcache)
+{
+    dico_cache_t cache = *pcache;
+
+    if (!cache)
+	return;
+    while (cache->tail)
+	cache_remove(cache, cache->tail);
+    free(cache->bucket);
+    free(cache);
+    *pcache = NULL;
+}
@@ -0,0 +1,148 @@
+# This file is part of GNU Dico.
+# Copyright (C) 2021 Sergey Poznyakoff
+#
+# GNU Dico is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GNU Dico is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>.
+
+# Generate two-stage case mapping tables from the plane tables in utf8.c.
+#
+# The Basic Multilingual Plane is split into blocks of 128 characters.
+# For each case mapping, the first stage maps the block number to the
+# number of a block of the second stage, which keeps, for each character
+# of the block, the difference between its mapping and its code.
+# Identical blocks are stored once.
+#
+# Usage: awk -f casefold.awk utf8.c > casefold.h
+
+function hex(s,   i, v) {
+    s = tolower(substr(s, 3))
+    v = 0
+    for (i = 1; i <= length(s); i++)
+	v = v * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+    return v
+}
+
+function gen(name, tab,   b, k, p, wc, key, nblocks, id, idx, blk, line) {
+    nblocks = 0
+    for (b = 0; b < NBLOCKS; b++) {
+	p = map[int(b * BSIZE / 256)]
+	key = ""
+	for (k = 0; k < BSIZE; k++) {
+	    wc = b * BSIZE + k
+	    key = key (k ? "," : "") (p == "NULL" ? 0 : tab[p, wc % 256] - wc)
+	}
+	if (!(key in id)) {
+	    id[key] = nblocks
+	    blk[nblocks++] = key
+	}
+	idx[b] = id[key]
+    }
+    if (nblocks > 256) {
+	print "casefold.awk: too many blocks" > "/dev/stderr"
+	exit 1
+    }
+
+    printf "static const unsigned char casefold_%s_index[%d] = {\n", \
+	   name, NBLOCKS
+    line = ""
+    for (b = 0; b < NBLOCKS; b++) {
+	line = line sprintf("%3d,", idx[b])
+	if (b % 16 == 15) {
+	    print "   " line
+	    line = ""
+	}
+    }
+    print "};\n"
+
+    printf "static const short casefold_%s_delta[%d][%d] = {\n", \
+	   name, nblocks, BSIZE
+    for (b = 0; b < nblocks; b++) {
+	print "  {"
+	n = split(blk[b], d, ",")
+	line = ""
+	for (k = 1; k <= n; k++) {
+	    line = line sprintf("%6d,", d[k])
+	    if (k % 10 == 0 || k == n) {
+		print "   " line
+		line = ""
+	    }
+	}
+	print "  },"
+    }
+    print "};\n"
+}
+
+BEGIN {
+    BSIZE = 128
+    NBLOCKS = 65536 / BSIZE
+}
+
+/^static MY_UNICASE_INFO plane[0-9A-Fa-f][0-9A-Fa-f]\[\] = \{/ {
+    match($0, /plane[0-9A-Fa-f][0-9A-Fa-f]/)
+    plane = substr($0, RSTART, RLENGTH)
+    n = 0
+    inplane = 1
+    next
+}
+
+inplane && /^\};/ {
+    if (n != 256) {
+	print "casefold.awk: " plane ": wrong number of entries" > "/dev/stderr"
+	exit 1
+    }
+    inplane = 0
+    next
+}
+
+inplane {
+    line = $0
+    while (match(line, /\{0x[0-9A-Fa-f]+, 0x[0-9A-Fa-f]+, 0x[0-9A-Fa-f]+\}/)) {
+	split(substr(line, RSTART + 1, RLENGTH - 2), f, /, /)
+	line = substr(line, RSTART + RLENGTH)
+	upper[plane, n] = hex(f[1])
+	lower[plane, n] = hex(f[2])
+	n++
+    }
+    next
+}
+
+/^MY_UNICASE_INFO \*uni_plane\[256\] = \{/ {
+    inmap = 1
+    np = 0
+    next
+}
+
+inmap && /^\};/ {
+    inmap = 0
+    next
+}
+
+inmap {
+    line = $0
+    while (match(line, /plane[0-9A-Fa-f][0-9A-Fa-f]|NULL/)) {
+	map[np++] = substr(line, RSTART, RLENGTH)
+	line = substr(line, RSTART + RLENGTH)
+    }
+}
+
+END {
+    if (np != 256) {
+	print "casefold.awk: cannot parse uni_plane" > "/dev/stderr"
+	exit 1
+    }
+    print "/* This file is generated automatically by casefold.awk from utf8.c."
+    print "   Do not edit. */\n"
+    printf "#define CASEFOLD_BLOCK_BITS %d\n\n", log(BSIZE) / log(2) + 0.5
+    gen("upper", upper)
+    gen("lower", lower)
+}
@@ -0,0 +1,636 @@
+/* This file is generated automatically by casefold.awk from utf8.c.
+   Do not edit. */
+
+#define CASEFOLD_BLOCK_BITS 7
+
+static const unsigned char casefold_upper_index[512] = {
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 13, 14, 15, 16,
+    12, 12, 17, 12, 12, 12, 12, 12, 12, 18, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 19, 12,
+};
+
+static const short casefold_upper_delta[20][128] = {
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,
+      -32,   -32,   -32,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,   743,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,   -32,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,     0,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   121,
+  },
+  {
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,  -232,
+        0,    -1,     0,    -1,     0,    -1,     0,     0,    -1,     0,
+       -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,
+       -1,     0,    -1,     0,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,     0,    -1,     0,    -1,     0,    -1,  -300,
+  },
+  {
+        0,     0,     0,    -1,     0,    -1,     0,     0,    -1,     0,
+        0,     0,    -1,     0,     0,     0,     0,     0,    -1,     0,
+        0,    97,     0,     0,     0,    -1,     0,     0,     0,     0,
+        0,     0,     0,    -1,     0,    -1,     0,    -1,     0,     0,
+       -1,     0,     0,     0,     0,    -1,     0,     0,    -1,     0,
+        0,     0,    -1,     0,    -1,     0,     0,    -1,     0,     0,
+        0,    -1,     0,    56,     0,     0,     0,     0,     0,    -1,
+       -2,     0,    -1,    -2,     0,    -1,    -2,     0,    -1,     0,
+       -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,
+       -1,     0,    -1,   -79,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,     0,    -1,    -2,     0,    -1,     0,     0,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,
+  },
+  {
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,     0,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,  -210,  -206,     0,  -205,  -205,     0,  -202,
+        0,  -203,     0,     0,     0,     0,  -205,     0,     0,  -207,
+        0,     0,     0,     0,  -209,  -211,     0,     0,     0,     0,
+        0,  -211,     0,     0,  -213,     0,     0,  -214,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+     -218,     0,     0,  -218,     0,     0,     0,     0,  -218,     0,
+     -217,  -217,     0,     0,     0,     0,     0,     0,  -219,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,    84,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,   -38,   -37,   -37,   -37,     0,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -31,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -64,   -63,   -63,     0,
+      -62,   -57,     0,     0,     0,   -47,   -54,     0,     0,     0,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,   -86,   -80,   -79,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,
+      -80,   -80,   -80,   -80,   -80,   -80,   -80,   -80,   -80,   -80,
+      -80,   -80,   -80,   -80,   -80,   -80,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,
+  },
+  {
+        0,    -1,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,     0,    -1,     0,    -1,     0,
+        0,     0,    -1,     0,     0,     0,    -1,     0,     0,     0,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,     0,
+        0,    -1,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,   -48,   -48,   -48,
+      -48,   -48,   -48,   -48,   -48,   -48,   -48,   -48,   -48,   -48,
+      -48,   -48,   -48,   -48,   -48,   -48,   -48,   -48,   -48,   -48,
+      -48,   -48,   -48,   -48,   -48,   -48,   -48,   -48,
+  },
+  {
+      -48,   -48,   -48,   -48,   -48,   -48,   -48,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,
+  },
+  {
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,     0,     0,     0,     0,   -59,     0,     0,
+        0,     0,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,    -1,     0,    -1,     0,    -1,     0,    -1,
+        0,    -1,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        8,     8,     8,     8,     8,     8,     8,     8,     0,     0,
+        0,     0,     0,     0,     0,     0,     8,     8,     8,     8,
+        8,     8,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     8,     8,     8,     8,     8,     8,     8,     8,
+        0,     0,     0,     0,     0,     0,     0,     0,     8,     8,
+        8,     8,     8,     8,     8,     8,     0,     0,     0,     0,
+        0,     0,     0,     0,     8,     8,     8,     8,     8,     8,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     8,     0,     8,     0,     8,     0,     8,     0,     0,
+        0,     0,     0,     0,     0,     0,     8,     8,     8,     8,
+        8,     8,     8,     8,     0,     0,     0,     0,     0,     0,
+        0,     0,    74,    74,    86,    86,    86,    86,   100,   100,
+      128,   128,   112,   112,   126,   126,     0,     0,
+  },
+  {
+        8,     8,     8,     8,     8,     8,     8,     8,     0,     0,
+        0,     0,     0,     0,     0,     0,     8,     8,     8,     8,
+        8,     8,     8,     8,     0,     0,     0,     0,     0,     0,
+        0,     0,     8,     8,     8,     8,     8,     8,     8,     8,
+        0,     0,     0,     0,     0,     0,     0,     0,     8,     8,
+        0,     9,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0, -7205,     0,     0,     0,     0,     9,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        8,     8,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     8,     8,     0,     0,
+        0,     7,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     9,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,   -16,   -16,   -16,   -16,   -16,   -16,   -16,   -16,
+      -16,   -16,   -16,   -16,   -16,   -16,   -16,   -16,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+      -26,   -26,   -26,   -26,   -26,   -26,   -26,   -26,   -26,   -26,
+      -26,   -26,   -26,   -26,   -26,   -26,   -26,   -26,   -26,   -26,
+      -26,   -26,   -26,   -26,   -26,   -26,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,   -32,   -32,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,
+      -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,   -32,
+      -32,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+};
+
+static const unsigned char casefold_lower_index[512] = {
+     0,  1,  2,  3,  4,  5,  5,  6,  7,  8,  9,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5, 10, 11, 12, 13,
+     5,  5, 14,  5,  5,  5,  5,  5,  5, 15,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+     5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5, 16,  5,
+};
+
+static const short casefold_lower_delta[17][128] = {
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,    32,    32,    32,
+       32,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,    32,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,     0,    32,    32,
+       32,    32,    32,    32,    32,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,  -199,     0,
+        1,     0,     1,     0,     1,     0,     0,     1,     0,     1,
+        0,     1,     0,     1,     0,     1,     0,     1,     0,     1,
+        0,     1,     0,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+     -121,     1,     0,     1,     0,     1,     0,     0,
+  },
+  {
+        0,   210,     1,     0,     1,     0,   206,     1,     0,   205,
+      205,     1,     0,     0,    79,   202,   203,     1,     0,   205,
+      207,     0,   211,   209,     1,     0,     0,     0,   211,   213,
+        0,   214,     1,     0,     1,     0,     1,     0,   218,     1,
+        0,   218,     0,     0,     1,     0,   218,     1,     0,   217,
+      217,     1,     0,     1,     0,   219,     1,     0,     0,     0,
+        1,     0,     0,     0,     0,     0,     0,     0,     2,     1,
+        0,     2,     1,     0,     2,     1,     0,     1,     0,     1,
+        0,     1,     0,     1,     0,     1,     0,     1,     0,     1,
+        0,     1,     0,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     0,     2,     1,     0,     1,     0,   -97,   -56,
+        1,     0,     1,     0,     1,     0,     1,     0,
+  },
+  {
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     0,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,    38,     0,    37,    37,
+       37,     0,    64,     0,    63,    63,     0,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,     0,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+       80,    80,    80,    80,    80,    80,    80,    80,    80,    80,
+       80,    80,    80,    80,    80,    80,    32,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,    32,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,
+  },
+  {
+        1,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     0,     1,     0,     1,     0,     0,
+        0,     1,     0,     0,     0,     1,     0,     0,     0,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     0,     0,
+        1,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,    48,
+       48,    48,    48,    48,    48,    48,    48,    48,    48,    48,
+       48,    48,    48,    48,    48,    48,    48,    48,    48,    48,
+       48,    48,    48,    48,    48,    48,    48,    48,    48,    48,
+       48,    48,    48,    48,    48,    48,    48,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,
+  },
+  {
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     1,     0,     1,     0,     1,     0,     1,     0,
+        1,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,    -8,    -8,
+       -8,    -8,    -8,    -8,    -8,    -8,     0,     0,     0,     0,
+        0,     0,     0,     0,    -8,    -8,    -8,    -8,    -8,    -8,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       -8,    -8,    -8,    -8,    -8,    -8,    -8,    -8,     0,     0,
+        0,     0,     0,     0,     0,     0,    -8,    -8,    -8,    -8,
+       -8,    -8,    -8,    -8,     0,     0,     0,     0,     0,     0,
+        0,     0,    -8,    -8,    -8,    -8,    -8,    -8,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,    -8,
+        0,    -8,     0,    -8,     0,    -8,     0,     0,     0,     0,
+        0,     0,     0,     0,    -8,    -8,    -8,    -8,    -8,    -8,
+       -8,    -8,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,    -8,    -8,
+       -8,    -8,    -8,    -8,    -8,    -8,     0,     0,     0,     0,
+        0,     0,     0,     0,    -8,    -8,    -8,    -8,    -8,    -8,
+       -8,    -8,     0,     0,     0,     0,     0,     0,     0,     0,
+       -8,    -8,    -8,    -8,    -8,    -8,    -8,    -8,     0,     0,
+        0,     0,     0,     0,     0,     0,    -8,    -8,   -74,   -74,
+       -9,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,   -86,   -86,   -86,   -86,    -9,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,    -8,    -8,
+     -100,  -100,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,    -8,    -8,  -112,  -112,    -7,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+     -128,  -128,  -126,  -126,    -9,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0, -7517,     0,
+        0,     0, -8383, -8262,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,    16,    16,    16,    16,
+       16,    16,    16,    16,    16,    16,    16,    16,    16,    16,
+       16,    16,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,    26,    26,    26,    26,    26,    26,
+       26,    26,    26,    26,    26,    26,    26,    26,    26,    26,
+       26,    26,    26,    26,    26,    26,    26,    26,    26,    26,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+  {
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,    32,    32,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,    32,    32,    32,
+       32,    32,    32,    32,    32,    32,    32,    32,    32,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,
+  },
+};
+
@@ -35,11 +35,47 @@ struct _crlfstr {
     char cb;
 };
 
+/* Translated output is collected in a vector of pieces of the caller's
+   buffers interleaved with CRLF sequences, which is passed to the
+   transport in a single call. */
+#define CRLF_IOV_MAX 32
+
+struct crlf_vec {
+    dico_stream_t transport;
+    struct iovec iov[CRLF_IOV_MAX];
+    int cnt;
+};
+
 static int
-_crlfstr_write(void *data, const char *buf, size_t size, size_t *pret)
+crlf_vec_flush(struct crlf_vec *vec)
+{
+    int rc = 0;
+    if (vec->cnt) {
+	if (dico_stream_writev(vec->transport, vec->iov, vec->cnt))
+	    rc = dico_stream_last_error(vec->transport);
+	vec->cnt = 0;
+    }
+    return rc;
+}
+
+static int
+crlf_vec_add(struct crlf_vec *vec, const char *buf, size_t size)
+{
+    int rc;
+    if (vec->cnt == CRLF_IOV_MAX && (rc = crlf_vec_flush(vec)))
+	return rc;
+    vec->iov[vec->cnt].iov_base = (void*) buf;
+    vec->iov[vec->cnt].iov_len = size;
+    vec->cnt++;
+    return 0;
+}
+
+static int
+crlf_translate(struct _crlfstr *s, struct crlf_vec *vec,
+	       const char *buf, size_t size)
 {
-    struct _crlfstr *s = data;
     const char *p, *q;
+    int rc;
 
     for (p = buf, q = buf + size; p < q; p++) {
 	switch (*p) {
@@ -47,9 +83,10 @@ _crlfstr_write(void *data, const char *buf, size_t size, size_t *pret)
 	    if (s->state == state_cr)
 		s->state = state_init;
 	    else {
-		if (p > buf)
-		    dico_stream_write(s->transport, buf, p - buf);
-		dico_stream_write(s->transport, "\r\n", 2);
+		if (p > buf && (rc = crlf_vec_add(vec, buf, p - buf)))
+		    return rc;
+		if ((rc = crlf_vec_add(vec, "\r\n", 2)))
+		    return rc;
 		buf = p + 1;
 	    }
 	    break;
@@ -62,12 +99,46 @@ _crlfstr_write(void *data, const char *buf, size_t size, size_t *pret)
     }
 
     if (p > buf)
-	dico_stream_write(s->transport, buf, p - buf);
-    *pret = size;
-
+	return crlf_vec_add(vec, buf, p - buf);
     return 0;
 }
 
+static int
+_crlfstr_write(void *data, const char *buf, size_t size, size_t *pret)
+{
+    struct _crlfstr *s = data;
+    struct crlf_vec vec;
+    int rc;
+
+    vec.transport = s->transport;
+    vec.cnt = 0;
+    if ((rc = crlf_translate(s, &vec, buf, size)) == 0
+	&& (rc = crlf_vec_flush(&vec)) == 0)
+	*pret = size;
+    return rc;
+}
+
+static int
+_crlfstr_writev(void *data, const struct iovec *iov, int iovcnt,
+		size_t *pret)
+{
+    struct _crlfstr *s = data;
+    struct crlf_vec vec;
+    size_t size = 0;
+    int i, rc;
+
+    vec.transport = s->transport;
+    vec.cnt = 0;
+    for (i = 0; i < iovcnt; i++) {
+	if ((rc = crlf_translate(s, &vec, iov[i].iov_base, iov[i].iov_len)))
+	    return rc;
+	size += iov[i].iov_len;
+    }
+    if ((rc = crlf_vec_flush(&vec)) == 0)
+	*pret = size;
+    return rc;
+}
+
 static int
 _crlfstr_read(void *data, char *buf, size_t size, size_t *pret)
 {
@@ -167,6 +238,12 @@ _crlfstr_ioctl(void *data, int code, void *call_data)
 	*(off_t*)call_data = dico_stream_bytes_out(s->transport);
 	break;
 
+    case DICO_IOCTL_GET_EOL:
+	/* Newlines are written to the transport as this sequence, the
+	   rest of the data being passed unchanged. */
+	*(const char**)call_data = "\r\n";
+	break;
+
     default:
 	errno = EINVAL;
 	return -1;
@@ -194,6 +271,7 @@ dico_crlf_stream(dico_stream_t transport, int flags, int noclose)
     s->transport = transport;
     s->noclose = noclose;
     dico_stream_set_write(str, _crlfstr_write);
+    dico_stream_set_writev(str, _crlfstr_writev);
     dico_stream_set_read(str, _crlfstr_read);
     dico_stream_set_flush(str, _crlfstr_flush);
     dico_stream_set_close(str, _crlfstr_close);
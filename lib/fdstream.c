@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <unistd.h>
+#include <sys/uio.h>
 
 struct _stream {
     int fd;
@@ -47,6 +48,17 @@ fd_write(void *data, const char *buf, size_t size, size_t *pret)
     return 0;
 }
 
+static int
+fd_writev(void *data, const struct iovec *iov, int iovcnt, size_t *pret)
+{
+    struct _stream *p = data;
+    ssize_t n = writev(p->fd, iov, iovcnt);
+    if (n == -1)
+	return errno;
+    *pret = n;
+    return 0;
+}
+
 static int
 fd_close(void *data)
 {
@@ -103,6 +115,7 @@ dico_fd_stream_create(int fd, int flags, int noclose)
     dico_stream_set_seek(str, fd_seek);
     dico_stream_set_size(str, fd_size);
     dico_stream_set_write(str, fd_write);
+    dico_stream_set_writev(str, fd_writev);
     dico_stream_set_read(str, fd_read);
     if (!noclose)
 	dico_stream_set_close(str, fd_close);
@@ -48,6 +48,23 @@ io_write(void *data, const char *buf, size_t size, size_t *pret)
     return 0;
 }
 
+static int
+io_writev(void *data, const struct iovec *iov, int iovcnt, size_t *pret)
+{
+    struct _iostr *p = data;
+    int i;
+    size_t size = 0;
+
+    if (dico_stream_writev(p->out, iov, iovcnt)) {
+	p->last_err = p->out;
+	return dico_stream_last_error(p->out);
+    }
+    for (i = 0; i < iovcnt; i++)
+	size += iov[i].iov_len;
+    *pret = size;
+    return 0;
+}
+
 static int
 io_flush(void *data)
 {
@@ -112,6 +129,7 @@ dico_io_stream(dico_stream_t in, dico_stream_t out)
     s->out = out;
     s->last_err = NULL;
     dico_stream_set_write(str, io_write);
+    dico_stream_set_writev(str, io_writev);
     dico_stream_set_read(str, io_read);
     dico_stream_set_flush(str, io_flush);
     dico_stream_set_close(str, io_close);
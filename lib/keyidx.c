@@ -0,0 +1,234 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <config.h>
+#include <dico.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+
+/* Derived key index.
+
+   Strategies such as soundex or metaphone2 select headwords whose keys
+   (phonetic codes) coincide with those of the search word.  Such
+   strategies supply a key derivation function.  The index built with
+   it keeps the keys of all headwords of a database in a sorted array,
+   so that candidate headwords are found using a binary search instead
+   of encoding the entire database on each request.
+
+   All keys are kept in a single string pool.  Entries refer to them by
+   offset. */
+
+struct key_entry {
+    size_t off;             /* Offset of the key in the pool */
+    unsigned n;             /* Headword number */
+};
+
+struct dico_key_index {
+    dico_strat_keyfn_t keyfn; /* Key derivation function */
+    size_t count;             /* Number of entries */
+    struct key_entry *ent;    /* Entries, sorted by key */
+    char *pool;               /* String pool */
+};
+
+static int
+compare_key_entry(const void *a, const void *b, void *closure)
+{
+    struct key_entry const *ea = a;
+    struct key_entry const *eb = b;
+    char const *pool = closure;
+    int rc = strcmp(pool + ea->off, pool + eb->off);
+    if (rc == 0) {
+	if (ea->n < eb->n)
+	    rc = -1;
+	else if (ea->n > eb->n)
+	    rc = 1;
+    }
+    return rc;
+}
+
+/* Add KEY of Nth headword to the index being built. */
+static int
+key_index_add(struct dico_key_index *idx, const char *key, size_t n,
+	      size_t *maxent, size_t *poolsize, size_t *poolmax)
+{
+    size_t len = strlen(key) + 1;
+
+    if (idx->count == *maxent) {
+	size_t size = *maxent ? 2 * *maxent : 1024;
+	struct key_entry *p = realloc(idx->ent, size * sizeof(p[0]));
+	if (!p)
+	    return -1;
+	idx->ent = p;
+	*maxent = size;
+    }
+    if (*poolsize + len > *poolmax) {
+	size_t size = *poolmax ? *poolmax : 4096;
+	char *p;
+
+	while (*poolsize + len > size)
+	    size *= 2;
+	p = realloc(idx->pool, size);
+	if (!p)
+	    return -1;
+	idx->pool = p;
+	*poolmax = size;
+    }
+    memcpy(idx->pool + *poolsize, key, len);
+    idx->ent[idx->count].off = *poolsize;
+    idx->ent[idx->count].n = n;
+    idx->count++;
+    *poolsize += len;
+    return 0;
+}
+
+dico_key_index_t
+dico_key_index_create(dico_strat_keyfn_t keyfn, size_t nelem,
+		      dico_index_word_t getword, void *closure)
+{
+    struct dico_key_index *idx;
+    size_t i, maxent = 0;
+    size_t poolsize = 0, poolmax = 0;
+
+    if (nelem > UINT_MAX) {
+	errno = ERANGE;
+	return NULL;
+    }
+    idx = calloc(1, sizeof(*idx));
+    if (!idx)
+	return NULL;
+    idx->keyfn = keyfn;
+
+    for (i = 0; i < nelem; i++) {
+	char *keys[DICO_STRAT_MAX_KEYS];
+	int j, nkeys, rc = 0;
+
+	nkeys = keyfn(getword(i, closure), keys);
+	for (j = 0; j < nkeys; j++) {
+	    if (rc == 0 && (j == 0 || strcmp(keys[j], keys[0])))
+		rc = key_index_add(idx, keys[j], i,
+				   &maxent, &poolsize, &poolmax);
+	    free(keys[j]);
+	}
+	if (rc) {
+	    dico_key_index_free(idx);
+	    return NULL;
+	}
+    }
+
+    dico_psort(idx->ent, idx->count, sizeof(idx->ent[0]),
+	       compare_key_entry, idx->pool);
+    return idx;
+}
+
+void
+dico_key_index_free(dico_key_index_t idx)
+{
+    if (idx) {
+	free(idx->ent);
+	free(idx->pool);
+	free(idx);
+    }
+}
+
+dico_strat_keyfn_t
+dico_key_index_keyfn(dico_key_index_t idx)
+{
+    return idx->keyfn;
+}
+
+/* Return the index of the first entry with the given KEY. */
+static size_t
+key_lower_bound(dico_key_index_t idx, const char *key)
+{
+    size_t l = 0, u = idx->count;
+
+    while (l < u) {
+	size_t m = (l + u) / 2;
+	if (strcmp(idx->pool + idx->ent[m].off, key) < 0)
+	    l = m + 1;
+	else
+	    u = m;
+    }
+    return l;
+}
+
+static int
+compare_size(const void *a, const void *b)
+{
+    size_t const *pa = a;
+    size_t const *pb = b;
+    if (*pa < *pb)
+	return -1;
+    if (*pa > *pb)
+	return 1;
+    return 0;
+}
+
+/* Look up candidates for headwords having a key in common with WORD.
+
+   On success, store in *PCAND a malloc'ed array of headword numbers in
+   ascending order, store its size in *PCOUNT, and return 0.  Return -1
+   on error, leaving *PCAND and *PCOUNT untouched. */
+int
+dico_key_index_lookup(dico_key_index_t idx, const char *word,
+		      size_t **pcand, size_t *pcount)
+{
+    char *keys[DICO_STRAT_MAX_KEYS];
+    size_t first[DICO_STRAT_MAX_KEYS], last[DICO_STRAT_MAX_KEYS];
+    int i, nkeys;
+    size_t j, count = 0;
+    size_t *cand;
+
+    nkeys = idx->keyfn(word, keys);
+    if (nkeys < 0)
+	return -1;
+    for (i = 0; i < nkeys; i++) {
+	if (i > 0 && strcmp(keys[i], keys[0]) == 0)
+	    first[i] = last[i] = 0;
+	else {
+	    first[i] = last[i] = key_lower_bound(idx, keys[i]);
+	    while (last[i] < idx->count
+		   && strcmp(idx->pool + idx->ent[last[i]].off, keys[i]) == 0)
+		last[i]++;
+	    count += last[i] - first[i];
+	}
+    }
+    for (i = 0; i < nkeys; i++)
+	free(keys[i]);
+
+    cand = calloc(count ? count : 1, sizeof(cand[0]));
+    if (!cand)
+	return -1;
+    count = 0;
+    for (i = 0; i < nkeys; i++)
+	for (j = first[i]; j < last[i]; j++)
+	    cand[count++] = idx->ent[j].n;
+    if (nkeys > 1) {
+	/* Merge the runs and remove duplicates */
+	size_t k;
+
+	qsort(cand, count, sizeof(cand[0]), compare_size);
+	for (j = k = 0; j < count; j++)
+	    if (k == 0 || cand[k-1] != cand[j])
+		cand[k++] = cand[j];
+	count = k;
+    }
+    *pcand = cand;
+    *pcount = count;
+    return 0;
+}
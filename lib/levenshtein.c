@@ -49,6 +49,9 @@ dico_levenshtein_distance(const char *astr, const char *bstr, int flags)
 	free(a);
 	return -1;
     }
+    /* Fold the case once instead of doing so on each comparison */
+    utf8_wc_strupper(a);
+    utf8_wc_strupper(b);
     alen = utf8_wc_strlen(a);
     blen = utf8_wc_strlen(b);
     
@@ -76,14 +79,14 @@ dico_levenshtein_distance(const char *astr, const char *bstr, int flags)
 	for (j = 0; j < blen; j++) { 
 	    unsigned n, cost;
 	    
-	    cost = !(utf8_wc_toupper(a[i]) == utf8_wc_toupper(b[j]));
+	    cost = !(a[i] == b[j]);
 	    n = MIN(row[prev][j+1] + 1,   /* Deletion */
 		    row[idx][j] + 1);     /* Insertion */
 	    n = MIN(n, row[prev][j] + cost); /* Substitution */
 	    if (flags & DICO_LEV_DAMERAU) {
 		if (i > 0 && j > 0
-		    && utf8_wc_toupper(a[i]) == utf8_wc_toupper(b[j-1])
-		    && utf8_wc_toupper(a[i-1]) == utf8_wc_toupper(b[j]))
+		    && a[i] == b[j-1]
+		    && a[i-1] == b[j])
 		    /* Transposition */
 		    n = MIN(n, row[(idx + 1) % nrows][j - 1] + cost);
 	    }
@@ -421,6 +421,8 @@ _dico_list_prepend(struct dico_list *list, void *data)
     ep->data = data;
     ep->next = list->head;
     ep->prev = NULL;
+    if (list->head)
+	list->head->prev = ep;
     list->head = ep;
     if (!list->tail)
 	list->tail = list->head;
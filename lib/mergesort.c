@@ -16,7 +16,14 @@
 
 #include <config.h>
 #include "dico.h"
+#include <stdlib.h>
 #include <string.h>
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+# include <pthread.h>
+#endif
 
 static void *dico_mergesort(void *a, void *b, size_t nmemb, size_t size,
 		       int (*comp)(const void *, const void *, void *),
@@ -97,3 +104,169 @@ merge(void *source, void *work, size_t size,
 	}
     }
 }
+
+/* Parallel sort.
+
+   The array is split into chunks, which are sorted concurrently, one
+   thread per chunk.  Then adjacent chunks are merged pairwise, each
+   pair in its own thread, until a single run remains.  The number of
+   chunks depends only on the array size; at most one thread per
+   processor runs at a time.  Since both the chunk sort and the merge
+   are stable and the chunk boundaries depend neither on the timing nor
+   on the number of processors, the result is the same as that of
+   dico_sort.
+
+   The comparison function is called from several threads at once, so
+   it must not modify any shared data. */
+
+/* Arrays shorter than this are sorted in the calling thread */
+#define PSORT_MIN_NMEMB 16384
+/* Maximum number of chunks and threads */
+#define PSORT_MAX_THREADS 16
+
+struct psort_task {
+    char *a;              /* Source array */
+    char *b;              /* Work array */
+    size_t size;          /* Member size */
+    size_t left;          /* Start of the first run */
+    size_t right;         /* Start of the second run */
+    size_t end;           /* End of the second run */
+    int (*comp)(const void *, const void *, void *);
+    void *closure;
+};
+
+/* Sort members [left, end) of A, leaving the result in A. */
+static void *
+psort_sort_chunk(void *data)
+{
+    struct psort_task *t = data;
+    size_t n = t->end - t->left;
+    char *a = t->a + t->left * t->size;
+    char *b = t->b + t->left * t->size;
+
+    if (dico_mergesort(a, b, n, t->size, t->comp, t->closure) != a)
+	memcpy(a, b, n * t->size);
+    return NULL;
+}
+
+/* Merge runs [left, right) and [right, end) of A into B. */
+static void *
+psort_merge_runs(void *data)
+{
+    struct psort_task *t = data;
+
+    merge(t->a, t->b, t->size, t->left, t->right, t->end,
+	  t->comp, t->closure);
+    return NULL;
+}
+
+/* Return the number of threads to run at a time. */
+static int
+psort_nthreads(void)
+{
+    long n = 1;
+
+#if defined(HAVE_PTHREAD_H) && defined(_SC_NPROCESSORS_ONLN)
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > PSORT_MAX_THREADS)
+	n = PSORT_MAX_THREADS;
+#endif
+    return n < 1 ? 1 : n;
+}
+
+/* Run FN for each of the N tasks in T, at most NT of them at a time. */
+static void
+psort_run(void *(*fn)(void *), struct psort_task *t, int n, int nt)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_t tid[PSORT_MAX_THREADS];
+    int started[PSORT_MAX_THREADS];
+    int i, j;
+
+    for (i = 0; i < n; i += nt) {
+	int k = n - i < nt ? n - i : nt;
+	
+	/* Run the first task of the batch in the calling thread */
+	for (j = 1; j < k; j++)
+	    started[j] = pthread_create(&tid[j], NULL, fn, &t[i + j]) == 0;
+	fn(&t[i]);
+	for (j = 1; j < k; j++) {
+	    if (started[j])
+		pthread_join(tid[j], NULL);
+	    else
+		fn(&t[i + j]);
+	}
+    }
+#else
+    int i;
+    for (i = 0; i < n; i++)
+	fn(&t[i]);
+#endif
+}
+
+int
+dico_psort(void *base, size_t nmemb, size_t size,
+	   int (*comp)(const void *, const void *, void *),
+	   void *closure)
+{
+    struct psort_task task[PSORT_MAX_THREADS];
+    size_t bound[PSORT_MAX_THREADS + 1];
+    int i, nchunks, nthreads;
+    char *a, *b;
+
+    if (nmemb < PSORT_MIN_NMEMB)
+	return dico_sort(base, nmemb, size, comp, closure);
+
+    nchunks = nmemb / (PSORT_MIN_NMEMB / 2) < PSORT_MAX_THREADS
+	       ? nmemb / (PSORT_MIN_NMEMB / 2) : PSORT_MAX_THREADS;
+    nthreads = psort_nthreads();
+
+    b = calloc(nmemb, size);
+    if (!b)
+	return -1;
+    a = base;
+
+    for (i = 0; i <= nchunks; i++)
+	bound[i] = nmemb / nchunks * i + (i == nchunks ? nmemb % nchunks : 0);
+    for (i = 0; i < nchunks; i++) {
+	task[i].a = a;
+	task[i].b = b;
+	task[i].size = size;
+	task[i].left = bound[i];
+	task[i].end = bound[i + 1];
+	task[i].comp = comp;
+	task[i].closure = closure;
+    }
+    psort_run(psort_sort_chunk, task, nchunks, nthreads);
+
+    /* Merge adjacent runs until one remains */
+    while (nchunks > 1) {
+	int n = 0;
+	char *t;
+
+	for (i = 0; i + 1 < nchunks; i += 2, n++) {
+	    task[n].a = a;
+	    task[n].b = b;
+	    task[n].left = bound[i];
+	    task[n].right = bound[i + 1];
+	    task[n].end = bound[i + 2];
+	    bound[n] = bound[i];
+	}
+	if (i < nchunks) {
+	    /* Odd run out: copy it over */
+	    memcpy(b + bound[i] * size, a + bound[i] * size,
+		   (bound[i + 1] - bound[i]) * size);
+	    bound[n++] = bound[i];
+	}
+	bound[n] = nmemb;
+	psort_run(psort_merge_runs, task, nchunks / 2, nthreads);
+	nchunks = n;
+	t = a;
+	a = b;
+	b = t;
+    }
+    if (a != base)
+	memcpy(base, a, nmemb * size);
+    free(a == base ? b : a);
+    return 0;
+}
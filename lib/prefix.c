@@ -0,0 +1,118 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <config.h>
+#include <dico.h>
+#include <stdlib.h>
+#include <errno.h>
+
+/* Paginated prefix search.
+
+   Strategies flagged with DICO_STRAT_PREFIX_PAGE take a search word of
+   the form [SKIP#COUNT#]PREFIX and select at most COUNT unique headwords
+   beginning with PREFIX, skipping SKIP first ones.  Modules that keep a
+   sorted index implement such strategies natively: they locate the
+   prefix range with a binary search and seek to the SKIP-th unique
+   headword using a run index (see below), instead of scanning the whole
+   index with the strategy selector. */
+
+int
+dico_prefix_page_parse(const dico_strategy_t strat, const char *word,
+		       struct dico_prefix_page *pg)
+{
+    char *p;
+    size_t skip, count;
+
+    if (!(strat->flags & DICO_STRAT_PREFIX_PAGE))
+	return 1;
+    pg->prefix = word;
+    pg->skip = 0;
+    pg->count = 0;
+    pg->lim = 0;
+    skip = strtoul(word, &p, 10);
+    if (*p == '#') {
+	count = strtoul(p + 1, &p, 10);
+	if (*p == '#') {
+	    pg->prefix = p + 1;
+	    pg->skip = skip;
+	    pg->count = count;
+	    pg->lim = 1;
+	}
+    }
+    return 0;
+}
+
+/* Return true if no more matches can be added to a page having COUNT
+   matches. */
+int
+dico_prefix_page_full(struct dico_prefix_page const *pg, size_t count)
+{
+    if (pg->lim && count >= pg->count)
+	return 1;
+    return dico_result_limit_reached(count);
+}
+
+/* A run index of a sorted array is an array of NELEM counters.  Its Nth
+   element keeps the number of runs of equal elements in the subarray
+   [0, N].  Thus, all elements of the Kth run (counting from 0) have the
+   value K+1. */
+size_t *
+dico_run_index_create(const void *base, size_t nelem, size_t elsize,
+		      int (*comp)(const void *, const void *, void *),
+		      void *closure)
+{
+    size_t *runs;
+    size_t i, n;
+    char const *prev, *cur;
+
+    runs = calloc(nelem ? nelem : 1, sizeof(runs[0]));
+    if (!runs) {
+	DICO_LOG_ERRNO();
+	return NULL;
+    }
+    prev = NULL;
+    cur = base;
+    for (i = n = 0; i < nelem; i++, prev = cur, cur += elsize) {
+	if (!prev || comp(prev, cur, closure))
+	    n++;
+	runs[i] = n;
+    }
+    return runs;
+}
+
+/* Given the run index RUNS of NELEM elements, return the index of the
+   first element of the SKIPth run after the one START belongs to.
+   Return NELEM if there are not that many runs. */
+size_t
+dico_run_index_seek(const size_t *runs, size_t nelem, size_t start,
+		    size_t skip)
+{
+    size_t target, l, r;
+
+    if (start >= nelem)
+	return nelem;
+    target = runs[start] + skip;
+    l = start;
+    r = nelem;
+    while (l < r) {
+	size_t m = l + (r - l) / 2;
+	if (runs[m] < target)
+	    l = m + 1;
+	else
+	    r = m;
+    }
+    return l;
+}
@@ -0,0 +1,422 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <config.h>
+#include <dico.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* Regular expression prefilter.
+
+   Before a regular expression is matched against each headword, its
+   pattern is analyzed to find the literal strings any matching word
+   must contain: the anchored literal prefix (as in "^foo.*") and the
+   longest literal occurring outside of groups.  Words lacking them are
+   rejected without invoking the regex engine.
+
+   The analysis is conservative: whenever unsure, it discards the
+   literal in question, so that the prefilter never rejects a word the
+   regular expression would match.  Patterns with alternation give no
+   literals at all.
+
+   For case-insensitive patterns, only ASCII literals are used and they
+   are compared using ASCII case folding.  Since some non-ASCII
+   characters fold to ASCII ones (e.g. KELVIN SIGN), words containing
+   non-ASCII characters are never rejected in this case. */
+
+struct analysis {
+    int flags;
+    char *buf;          /* Literal characters collected so far */
+    size_t len;         /* Length of buf */
+    size_t run;         /* Start of the current run in buf */
+    int depth;          /* Group nesting depth */
+    int in_prefix;      /* Current run is the anchored prefix */
+    size_t prefix_len;  /* Length of the prefix (starts at buf[0]) */
+    size_t best;        /* Start of the longest run */
+    size_t best_len;    /* and its length */
+};
+
+#define IS_EXTENDED(a) ((a)->flags & (DICO_REGEX_EXTENDED|DICO_REGEX_PCRE))
+
+/* Finish the current run of literals. */
+static void
+end_run(struct analysis *a)
+{
+    size_t n = a->len - a->run;
+
+    if (a->in_prefix) {
+	a->prefix_len = n;
+	a->in_prefix = 0;
+    }
+    if (a->depth == 0 && n > a->best_len) {
+	a->best = a->run;
+	a->best_len = n;
+    }
+    a->run = a->len;
+}
+
+/* Handle a quantifier: the last literal becomes optional or repeated,
+   so remove it from the current run and finish the run. */
+static void
+quantifier(struct analysis *a)
+{
+    if (a->len > a->run) {
+	do
+	    a->len--;
+	while (a->len > a->run && (a->buf[a->len] & 0xc0) == 0x80);
+    }
+    end_run(a);
+}
+
+/* Skip the bracket expression starting at P.  Return pointer past
+   it. */
+static char const *
+skip_bracket(struct analysis *a, char const *p)
+{
+    p++;
+    if (*p == '^')
+	p++;
+    if (*p == ']')
+	p++;
+    while (*p && *p != ']') {
+	if (*p == '[' && (p[1] == ':' || p[1] == '=' || p[1] == '.')) {
+	    int c = p[1];
+	    p += 2;
+	    while (*p && !(*p == c && p[1] == ']'))
+		p++;
+	    if (*p)
+		p += 2;
+	} else if (*p == '\\' && (a->flags & DICO_REGEX_PCRE) && p[1])
+	    p += 2;
+	else
+	    p++;
+    }
+    return *p ? p + 1 : p;
+}
+
+/* Skip the interval expression starting at P ("{" or "\{").  Return
+   pointer past it. */
+static char const *
+skip_interval(char const *p)
+{
+    while (*p && *p != '}')
+	p++;
+    return *p ? p + 1 : p;
+}
+
+/* Skip the special escape sequence starting at P (a backslash followed
+   by an alphanumeric character).  Return pointer past it. */
+static char const *
+skip_escape(struct analysis *a, char const *p)
+{
+    int c = p[1];
+
+    p += 2;
+    if (!(a->flags & DICO_REGEX_PCRE))
+	return p;
+    switch (c) {
+    case 'c':
+	/* Control character */
+	if (*p)
+	    p++;
+	break;
+
+    case 'x':
+	if (isxdigit(*(unsigned char*)p)) {
+	    p++;
+	    if (isxdigit(*(unsigned char*)p))
+		p++;
+	}
+	break;
+
+    case 'g':
+    case 'k':
+	/* Back reference */
+	if (*p == '<' || *p == '\'') {
+	    int delim = *p == '<' ? '>' : *p;
+	    while (*++p && *p != delim)
+		;
+	    if (*p)
+		p++;
+	    break;
+	}
+	if (*p == '-' || *p == '+')
+	    p++;
+	/* FALLTHROUGH */
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+	while (isdigit(*(unsigned char*)p))
+	    p++;
+	break;
+
+    case 'p':
+    case 'P':
+	/* Unicode property with a single-letter name */
+	if (*p && *p != '{')
+	    p++;
+	break;
+    }
+    /* Braced arguments, as in \x{...}, are skipped as intervals. */
+    return p;
+}
+
+static void
+add_char(struct analysis *a, char const *p, size_t n)
+{
+    if ((a->flags & DICO_REGEX_ICASE) && (*(unsigned char*)p & 0x80)) {
+	/* Non-ASCII character in a case-insensitive pattern */
+	end_run(a);
+	return;
+    }
+    memcpy(a->buf + a->len, p, n);
+    a->len += n;
+}
+
+/* Scan the pattern.  Return 0 on success and 1 if the pattern cannot
+   be analyzed. */
+static int
+scan(struct analysis *a, char const *p)
+{
+    int ext = IS_EXTENDED(a);
+
+    if (*p == '^') {
+	a->in_prefix = 1;
+	p++;
+    }
+    while (*p) {
+	unsigned char c = *p;
+
+	if (c == '\\') {
+	    c = p[1];
+	    if (c == 0)
+		break;
+	    if (c == '|')
+		return 1;
+	    if (!ext && strchr("(){}+?", c)) {
+		/* BRE operator */
+		p++;
+	    } else if (c < 0x80 && !isalnum(c) && !strchr("<>`'", c)) {
+		add_char(a, p + 1, 1);
+		p += 2;
+		continue;
+	    } else {
+		/* Character class, anchor, back reference, etc. */
+		end_run(a);
+		p = skip_escape(a, p);
+		continue;
+	    }
+	} else if (c == '[') {
+	    end_run(a);
+	    p = skip_bracket(a, p);
+	    continue;
+	} else if (!ext && strchr("(){}+?|", c)) {
+	    /* An ordinary character in BRE */
+	    add_char(a, p, 1);
+	    p++;
+	    continue;
+	} else if (c & 0x80) {
+	    size_t n = 1;
+	    while ((p[n] & 0xc0) == 0x80)
+		n++;
+	    add_char(a, p, n);
+	    p += n;
+	    continue;
+	}
+
+	/* Now P points to a possible operator character. */
+	c = *p;
+	switch (c) {
+	case '*':
+	case '+':
+	case '?':
+	    quantifier(a);
+	    p++;
+	    break;
+
+	case '{':
+	    quantifier(a);
+	    p = skip_interval(p);
+	    break;
+
+	case '(':
+	    if ((a->flags & DICO_REGEX_PCRE) && p[1] == '?')
+		/* Option settings, lookaround assertions, etc. */
+		return 1;
+	    end_run(a);
+	    a->depth++;
+	    p++;
+	    break;
+
+	case ')':
+	    end_run(a);
+	    if (a->depth > 0)
+		a->depth--;
+	    p++;
+	    break;
+
+	case '|':
+	    return 1;
+
+	case '.':
+	case '^':
+	case '$':
+	    end_run(a);
+	    p++;
+	    break;
+
+	default:
+	    if (c == '}' && !ext && p[-1] == '\\') {
+		end_run(a);
+		p++;
+	    } else {
+		add_char(a, p, 1);
+		p++;
+	    }
+	}
+    }
+    end_run(a);
+    return 0;
+}
+
+static char *
+strndup_or_null(char const *s, size_t n)
+{
+    char *p;
+
+    if (n == 0)
+	return NULL;
+    p = malloc(n + 1);
+    if (p) {
+	memcpy(p, s, n);
+	p[n] = 0;
+    }
+    return p;
+}
+
+/* Analyze the regular expression PATTERN and initialize the prefilter
+   PF.  FLAGS is a bitwise OR of DICO_REGEX_ constants describing the
+   pattern syntax.  Return 0 on success and -1 on error (not enough
+   memory).  A pattern that cannot be analyzed yields a prefilter
+   accepting all words. */
+int
+dico_regex_prefilter_init(struct dico_regex_prefilter *pf,
+			  const char *pattern, int flags)
+{
+    struct analysis a;
+
+    memset(pf, 0, sizeof(*pf));
+    pf->flags = flags;
+    if ((flags & DICO_REGEX_PCRE) && strstr(pattern, "\\Q"))
+	return 0;
+
+    memset(&a, 0, sizeof(a));
+    a.flags = flags;
+    a.in_prefix = flags & DICO_REGEX_ANCHORED;
+    a.buf = malloc(strlen(pattern) + 1);
+    if (!a.buf)
+	return -1;
+    if (scan(&a, pattern) == 0) {
+	pf->prefix_len = a.prefix_len;
+	pf->prefix = strndup_or_null(a.buf, a.prefix_len);
+	/* Unless the longest literal is the prefix itself */
+	if (!(a.best == 0 && a.best_len == a.prefix_len)) {
+	    pf->literal_len = a.best_len;
+	    pf->literal = strndup_or_null(a.buf + a.best, a.best_len);
+	}
+	if ((pf->prefix_len && !pf->prefix)
+	    || (pf->literal_len && !pf->literal)) {
+	    free(a.buf);
+	    dico_regex_prefilter_free(pf);
+	    return -1;
+	}
+    }
+    free(a.buf);
+    return 0;
+}
+
+void
+dico_regex_prefilter_free(struct dico_regex_prefilter *pf)
+{
+    free(pf->prefix);
+    free(pf->literal);
+    memset(pf, 0, sizeof(*pf));
+}
+
+static inline int
+ascii_tolower(int c)
+{
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+static int
+ascii_strncasecmp(char const *a, char const *b, size_t n)
+{
+    for (; n; a++, b++, n--) {
+	int c = ascii_tolower(*(unsigned char*)a)
+	          - ascii_tolower(*(unsigned char*)b);
+	if (c || *a == 0)
+	    return c;
+    }
+    return 0;
+}
+
+/* Find the first occurrence of LIT (of length LEN > 0) in WORD, ignoring
+   the case of ASCII letters. */
+static char const *
+ascii_strcasestr(char const *word, char const *lit, size_t len)
+{
+    char set[3];
+
+    set[0] = ascii_tolower(lit[0]);
+    set[1] = (set[0] >= 'a' && set[0] <= 'z') ? set[0] - 'a' + 'A' : set[0];
+    set[2] = 0;
+    while ((word = strpbrk(word, set)) != NULL) {
+	if (ascii_strncasecmp(word + 1, lit + 1, len - 1) == 0)
+	    return word;
+	word++;
+    }
+    return NULL;
+}
+
+static int
+has_non_ascii(char const *word)
+{
+    for (; *word; word++)
+	if (*(unsigned char*)word & 0x80)
+	    return 1;
+    return 0;
+}
+
+/* Return 0 if WORD cannot match the regular expression PF was built
+   for, and 1 if it might. */
+int
+dico_regex_prefilter_match(struct dico_regex_prefilter const *pf,
+			   const char *word)
+{
+    if (pf->flags & DICO_REGEX_ICASE) {
+	if ((pf->prefix_len
+	     && ascii_strncasecmp(word, pf->prefix, pf->prefix_len))
+	    || (pf->literal_len
+		&& !ascii_strcasestr(word, pf->literal, pf->literal_len)))
+	    return has_non_ascii(word);
+    } else {
+	if ((pf->prefix_len && strncmp(word, pf->prefix, pf->prefix_len))
+	    || (pf->literal_len && !strstr(word, pf->literal)))
+	    return 0;
+    }
+    return 1;
+}
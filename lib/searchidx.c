@@ -0,0 +1,214 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <config.h>
+#include <dico.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+
+/* Headword search index.
+
+   A binary search over a database index compares the search word with
+   a headword at each step, which involves an indirect call and, for
+   large databases, a cache miss on each probe.  The search index keeps
+   instead a compact array of fixed-width keys, one per headword.  A key
+   is the first 8 bytes of the UTF-8 representation of the headword,
+   case-folded if so requested, packed into a 64-bit integer with the
+   first byte in its most significant position.  Since the order of
+   UTF-8 strings coincides with that of their code points, keys are
+   ordered the same way as headwords compared with utf8_compare.
+
+   The keys are stored in Eytzinger (BFS) order: the root of the
+   implicit search tree is at position 1 and the children of node k
+   are at 2k and 2k+1.  The search is branch-free, and the nodes a few
+   levels below the current one share a cache line, which is
+   prefetched in advance.
+
+   Lookups return the range of headwords whose keys match that of the
+   search word.  Words longer than a key may tie, so the caller
+   verifies the range using its comparison function. */
+
+#define KEY_SIZE sizeof(uint64_t)
+
+struct dico_search_index {
+    int flags;             /* DICO_SEARCH_ flags */
+    size_t count;          /* Number of headwords */
+    uint64_t *keys;        /* Keys in Eytzinger order, starting at 1 */
+    unsigned *rank;        /* rank[k] is the number of headword keys[k]
+			      was computed from */
+};
+
+#if defined(__GNUC__)
+# define PREFETCH(p) __builtin_prefetch(p)
+#else
+# define PREFETCH(p)
+#endif
+
+/* Compute the key of WORD.  Store the number of bytes it was computed
+   from (at most KEY_SIZE) in *PLEN.  Return 0 on success and -1 if
+   WORD is not a valid UTF-8 string. */
+static int
+word_key(const char *word, int flags, uint64_t *pkey, size_t *plen)
+{
+    char buf[KEY_SIZE + 6];
+    size_t i, n = 0;
+    uint64_t key = 0;
+
+    while (*word && n < KEY_SIZE) {
+	unsigned wc;
+	size_t len = utf8_char_width(word);
+
+	if (len == 0 || utf8_mbtowc(&wc, word, len) <= 0)
+	    return -1;
+	word += len;
+	if (flags & DICO_SEARCH_CI)
+	    wc = utf8_wc_fold(wc);
+	n += utf8_wctomb(buf + n, wc);
+    }
+    if (n > KEY_SIZE)
+	n = KEY_SIZE;
+    for (i = 0; i < KEY_SIZE; i++)
+	key = (key << 8) | (i < n ? (unsigned char) buf[i] : 0);
+    *pkey = key;
+    *plen = n;
+    return 0;
+}
+
+/* Fill in the subtree rooted at node K with the keys from SORTED,
+   starting at I.  Return the number of the first key not used. */
+static size_t
+eytzinger_fill(struct dico_search_index *idx, uint64_t const *sorted,
+	       size_t i, size_t k)
+{
+    if (k <= idx->count) {
+	i = eytzinger_fill(idx, sorted, i, 2 * k);
+	idx->keys[k] = sorted[i];
+	idx->rank[k] = i++;
+	i = eytzinger_fill(idx, sorted, i, 2 * k + 1);
+    }
+    return i;
+}
+
+/* Create the search index for NELEM headwords.  The Ith headword is
+   returned by GETWORD(I, CLOSURE).  The headwords must be sorted in
+   the order defined by utf8_compare, case-insensitive if FLAGS has the
+   DICO_SEARCH_CI bit set.
+
+   Return NULL and set errno on error.  EINVAL means that a headword is
+   not a valid UTF-8 string, or that the headwords are not sorted. */
+dico_search_index_t
+dico_search_index_create(size_t nelem, dico_index_word_t getword,
+			 void *closure, int flags)
+{
+    struct dico_search_index *idx;
+    uint64_t *sorted;
+    size_t i;
+
+    if (nelem >= UINT_MAX) {
+	errno = ERANGE;
+	return NULL;
+    }
+    sorted = calloc(nelem ? nelem : 1, sizeof(sorted[0]));
+    if (!sorted)
+	return NULL;
+    for (i = 0; i < nelem; i++) {
+	size_t len;
+
+	if (word_key(getword(i, closure), flags, &sorted[i], &len)
+	    || (i > 0 && sorted[i] < sorted[i-1])) {
+	    free(sorted);
+	    errno = EINVAL;
+	    return NULL;
+	}
+    }
+
+    idx = calloc(1, sizeof(*idx));
+    if (!idx) {
+	free(sorted);
+	return NULL;
+    }
+    idx->flags = flags;
+    idx->count = nelem;
+    idx->keys = calloc(nelem + 1, sizeof(idx->keys[0]));
+    idx->rank = calloc(nelem + 1, sizeof(idx->rank[0]));
+    if (!idx->keys || !idx->rank) {
+	free(sorted);
+	dico_search_index_free(idx);
+	return NULL;
+    }
+    eytzinger_fill(idx, sorted, 0, 1);
+    free(sorted);
+    return idx;
+}
+
+void
+dico_search_index_free(dico_search_index_t idx)
+{
+    if (idx) {
+	free(idx->keys);
+	free(idx->rank);
+	free(idx);
+    }
+}
+
+/* Return the number of the first headword whose key is not less than
+   KEY. */
+static size_t
+lower_bound(dico_search_index_t idx, uint64_t key)
+{
+    size_t k = 1;
+
+    while (k <= idx->count) {
+	/* Descendants of K four levels down occupy 16 consecutive
+	   keys, starting at 16k. */
+	PREFETCH(idx->keys + 16 * k);
+	k = 2 * k + (idx->keys[k] < key);
+    }
+    /* K went right (bit 1) after the last left turn, at the node which
+       is the lower bound.  Strip these right turns and the left one. */
+#if defined(__GNUC__)
+    k >>= __builtin_ctzl((unsigned long) ~k) + 1;
+#else
+    while (k & 1)
+	k >>= 1;
+    k >>= 1;
+#endif
+    return k == 0 ? idx->count : idx->rank[k];
+}
+
+/* Find the range of headwords that can be equal to WORD or, if PREFIX
+   is true, begin with it.  Store the number of the first headword of
+   the range in *PSTART and that of the headword past its end in *PEND.
+   Return 0 on success and -1 if WORD is not a valid UTF-8 string. */
+int
+dico_search_index_range(dico_search_index_t idx, const char *word,
+			int prefix, size_t *pstart, size_t *pend)
+{
+    uint64_t lo, hi;
+    size_t len;
+
+    if (word_key(word, idx->flags, &lo, &len))
+	return -1;
+    hi = lo;
+    if (prefix && len < KEY_SIZE)
+	hi |= len == 0 ? UINT64_MAX : UINT64_MAX >> (8 * len);
+    *pstart = lower_bound(idx, lo);
+    *pend = hi == UINT64_MAX ? idx->count : lower_bound(idx, hi + 1);
+    return 0;
+}
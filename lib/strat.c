@@ -66,6 +66,10 @@ dico_strategy_dup(const dico_strategy_t strat)
     if (np) {
 	np->sel = strat->sel;
 	np->closure = strat->closure;
+	np->time_limit = strat->time_limit;
+	np->compare_limit = strat->compare_limit;
+	np->flags = strat->flags;
+	np->keyfn = strat->keyfn;
     }
     return np;
 }
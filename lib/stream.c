@@ -24,6 +24,9 @@
 #define _STR_ERR           0x2000    /* Permanent error state */
 #define _STR_EOF           0x4000    /* EOF encountered */
 
+#define _STR_IOV_MAX       16        /* Max. number of buffers passed to
+					the writev method at once */
+
 struct dico_stream {
     enum dico_buffer_type buftype;
     size_t bufsize;
@@ -37,6 +40,7 @@ struct dico_stream {
     int last_err;
     int (*read) (void *, char *, size_t, size_t *);
     int (*write) (void *, const char *, size_t, size_t *);
+    int (*writev) (void *, const struct iovec *, int, size_t *);
     int (*flush) (void *);
     int (*open) (void *, int);
     int (*close) (void *);
@@ -114,6 +118,14 @@ dico_stream_set_write(dico_stream_t stream,
     stream->write = writefn;
 }
 
+void
+dico_stream_set_writev(dico_stream_t stream,
+		       int (*writevfn) (void *, const struct iovec *, int,
+					size_t *))
+{
+    stream->writev = writevfn;
+}
+
 void
 dico_stream_set_flush(dico_stream_t stream, int (*flushfn) (void *))
 {
@@ -364,6 +376,105 @@ dico_stream_write_unbuffered(dico_stream_t stream,
     return rc;
 }
 
+static int _stream_flush_buffer(dico_stream_t stream, int all);
+
+/* Write IOVCNT buffers from IOV to STREAM, bypassing its buffer.  Use
+   the writev method, if available.  Otherwise, write the buffers one
+   by one. */
+static int
+_stream_writev_unbuffered(dico_stream_t stream, const struct iovec *iov,
+			  int iovcnt)
+{
+    struct iovec v[_STR_IOV_MAX];
+    int rc = 0;
+
+    if (!stream->writev) {
+	for (; iovcnt > 0; iov++, iovcnt--) {
+	    rc = dico_stream_write_unbuffered(stream, iov->iov_base,
+					      iov->iov_len, NULL);
+	    if (rc)
+		break;
+	}
+	return rc;
+    }
+
+    if (!(stream->flags & DICO_STREAM_WRITE))
+	return _stream_seterror(stream, EACCES, 1);
+
+    if (stream->flags & _STR_ERR)
+	return stream->last_err;
+
+    while (rc == 0 && iovcnt > 0) {
+	int i = 0;
+	int n = iovcnt < _STR_IOV_MAX ? iovcnt : _STR_IOV_MAX;
+
+	memcpy(v, iov, n * sizeof(v[0]));
+	iov += n;
+	iovcnt -= n;
+	for (;;) {
+	    size_t wrbytes;
+
+	    while (i < n && v[i].iov_len == 0)
+		i++;
+	    if (i == n)
+		break;
+	    rc = stream->writev(stream->data, v + i, n - i, &wrbytes);
+	    if (rc)
+		break;
+	    if (wrbytes == 0) {
+		rc = EIO;
+		break;
+	    }
+	    stream->bytes_out += wrbytes;
+	    /* Skip the buffers written out and adjust the partially
+	       written one. */
+	    while (i < n && wrbytes >= v[i].iov_len) {
+		wrbytes -= v[i].iov_len;
+		i++;
+	    }
+	    if (wrbytes) {
+		v[i].iov_base = (char*) v[i].iov_base + wrbytes;
+		v[i].iov_len -= wrbytes;
+	    }
+	}
+    }
+    _stream_seterror(stream, rc, rc != 0);
+    return rc;
+}
+
+/* True if SIZE bytes written to a fully buffered STREAM can be passed
+   directly to its writev method, along with the buffered data, instead
+   of being copied to the buffer. */
+#define _stream_write_through_p(s,size)				\
+    ((s)->buftype == dico_buffer_full && (s)->writev		\
+     && !((s)->flags & DICO_STREAM_SEEK)				\
+     && ((s)->level == 0 || ((s)->flags & _STR_DIRTY))		\
+     && (size) >= (s)->bufsize - (s)->level)
+
+static int
+_stream_write_through(dico_stream_t stream, const struct iovec *iov,
+		      int iovcnt)
+{
+    struct iovec v[_STR_IOV_MAX];
+    int rc;
+
+    if (stream->level == 0 || iovcnt >= _STR_IOV_MAX)
+	return _stream_flush_buffer(stream, 1)
+	         ? stream->last_err
+	         : _stream_writev_unbuffered(stream, iov, iovcnt);
+
+    v[0].iov_base = stream->cur;
+    v[0].iov_len = stream->level;
+    memcpy(v + 1, iov, iovcnt * sizeof(v[0]));
+    rc = _stream_writev_unbuffered(stream, v, iovcnt + 1);
+    if (rc == 0) {
+	stream->cur = stream->buffer;
+	stream->level = 0;
+	stream->flags &= ~_STR_DIRTY;
+    }
+    return rc;
+}
+
 static int
 _stream_fill_buffer(dico_stream_t stream)
 {
@@ -618,6 +729,14 @@ dico_stream_write(dico_stream_t stream, const void *buf, size_t size)
 	
 	if (stream->flags & _STR_ERR)
 	    return stream->last_err;
+
+	if (_stream_write_through_p(stream, size)) {
+	    struct iovec iov;
+
+	    iov.iov_base = (void*) buf;
+	    iov.iov_len = size;
+	    return _stream_write_through(stream, &iov, 1);
+	}
 	
 	while (1) {
 	    size_t n;
@@ -652,6 +771,33 @@ dico_stream_writeln(dico_stream_t stream, const char *buf, size_t size)
     return rc;
 }
 
+/* Write IOVCNT buffers from IOV to STREAM.  The data are copied to the
+   stream buffer only if they fit into it.  Otherwise they are passed
+   to the stream writev method along with the buffered data, so that the
+   caller-owned buffers are written without copying. */
+int
+dico_stream_writev(dico_stream_t stream, const struct iovec *iov, int iovcnt)
+{
+    size_t size = 0;
+    int i, rc;
+
+    if (stream->flags & _STR_ERR)
+	return stream->last_err;
+
+    if (stream->buftype == dico_buffer_none)
+	return _stream_writev_unbuffered(stream, iov, iovcnt);
+
+    for (i = 0; i < iovcnt; i++)
+	size += iov[i].iov_len;
+    if (_stream_write_through_p(stream, size))
+	return _stream_write_through(stream, iov, iovcnt);
+
+    for (i = 0; i < iovcnt; i++)
+	if ((rc = dico_stream_write(stream, iov[i].iov_base, iov[i].iov_len)))
+	    return rc;
+    return 0;
+}
+
 int
 dico_stream_flush(dico_stream_t stream)
 {
@@ -666,6 +812,14 @@ dico_stream_flush(dico_stream_t stream)
     return 0;
 }
 
+/* Return the number of bytes written to STREAM and not yet passed to
+   its write method. */
+size_t
+dico_stream_pending(dico_stream_t stream)
+{
+    return (stream->flags & _STR_DIRTY) ? stream->level : 0;
+}
+
 int
 dico_stream_close(dico_stream_t stream)
 {
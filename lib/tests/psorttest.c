@@ -0,0 +1,109 @@
+/* This file is part of GNU Dico
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <config.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <dico.h>
+
+/* Test parallel sort.
+
+   Usage: psorttest NMEMB NKEYS
+
+   Sorts NMEMB pseudo-random records with keys in the range [0, NKEYS)
+   using both dico_sort and dico_psort.  Each record also keeps its
+   original position, which is ignored by the comparison function.
+   The program checks that the dico_psort result is ordered, that
+   records with equal keys keep their original order, and that it is
+   identical to the one produced by dico_sort. */
+
+struct record {
+    unsigned key;
+    size_t pos;
+};
+
+static int
+compare_record(const void *a, const void *b, void *closure)
+{
+    const struct record *ra = a;
+    const struct record *rb = b;
+    if (ra->key < rb->key)
+	return -1;
+    if (ra->key > rb->key)
+	return 1;
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    size_t nmemb, i;
+    unsigned nkeys, seed = 1;
+    struct record *a, *b;
+
+    dico_set_program_name(argv[0]);
+    if (argc != 3) {
+	fprintf(stderr, "usage: %s NMEMB NKEYS\n", dico_program_name);
+	return 2;
+    }
+    nmemb = strtoul(argv[1], NULL, 10);
+    nkeys = strtoul(argv[2], NULL, 10);
+    if (nkeys == 0) {
+	fprintf(stderr, "%s: NKEYS must be positive\n", dico_program_name);
+	return 2;
+    }
+
+    a = calloc(nmemb ? nmemb : 1, sizeof(a[0]));
+    b = calloc(nmemb ? nmemb : 1, sizeof(b[0]));
+    if (!a || !b) {
+	fprintf(stderr, "%s: not enough memory\n", dico_program_name);
+	return 2;
+    }
+    for (i = 0; i < nmemb; i++) {
+	seed = seed * 1103515245 + 12345;
+	a[i].key = (seed >> 16) % nkeys;
+	a[i].pos = i;
+    }
+    memcpy(b, a, nmemb * sizeof(a[0]));
+
+    if (dico_sort(a, nmemb, sizeof(a[0]), compare_record, NULL)
+	|| dico_psort(b, nmemb, sizeof(b[0]), compare_record, NULL)) {
+	fprintf(stderr, "%s: sort failed\n", dico_program_name);
+	return 2;
+    }
+
+    for (i = 1; i < nmemb; i++) {
+	if (b[i-1].key > b[i].key) {
+	    printf("%lu: out of order\n", (unsigned long) i);
+	    return 1;
+	}
+	if (b[i-1].key == b[i].key && b[i-1].pos > b[i].pos) {
+	    printf("%lu: not stable\n", (unsigned long) i);
+	    return 1;
+	}
+    }
+    for (i = 0; i < nmemb; i++) {
+	if (a[i].key != b[i].key || a[i].pos != b[i].pos) {
+	    printf("%lu: differs from dico_sort\n", (unsigned long) i);
+	    return 1;
+	}
+    }
+    printf("%lu records sorted\n", (unsigned long) nmemb);
+    free(a);
+    free(b);
+    return 0;
+}
@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 #include <dico.h>
 
 typedef int (*opfn) (int argc, char **argv);
@@ -187,6 +188,36 @@ op_tolower(int argc, char **argv)
     return 0;
 }
 
+static int
+op_casefold(int argc, char **argv)
+{
+    char *opname = *argv++;
+    char *s, *t;
+    unsigned *w;
+    size_t len;
+
+    argc--;
+    if (argc != 1) {
+	dico_log(L_ERR, 0, "%s requires one argument", opname);
+	return 1;
+    }
+    if (utf8_casefold(argv[0], &s))
+	abort();
+    /* Both folding functions must agree */
+    if (utf8_casefold_wc(argv[0], &w, &len)
+	|| utf8_wc_to_mbstr(w, len, &t))
+	abort();
+    if (strcmp(s, t)) {
+	dico_log(L_ERR, 0, "%s: results differ: %s, %s", opname, s, t);
+	return 1;
+    }
+    printf("%s\n", s);
+    free(s);
+    free(t);
+    free(w);
+    return 0;
+}
+
 static int
 op_wc_strchr(int argc, char **argv)
 {
@@ -255,6 +286,213 @@ op_wc_strstr(int argc, char **argv)
     return 0;
 }
 
+/* Reference implementations for the benchmark.  These decode each
+   character with utf8_mbtowc_internal and fold it with the case tables,
+   as the library did before the ASCII fast paths were introduced. */
+struct refstr {
+    const unsigned char *ptr;
+};
+
+static int
+ref_next(void *data)
+{
+    struct refstr *p = data;
+    return *p->ptr ? *p->ptr++ : 0;
+}
+
+static size_t
+ref_strlen(const char *s)
+{
+    size_t len = 0;
+    size_t n;
+
+    while (*s && (n = utf8_char_width(s)) != 0) {
+	len++;
+	s += n;
+    }
+    return len;
+}
+
+static int
+ref_compare(const char *a, const char *b, int ci, size_t maxlen)
+{
+    struct refstr ra = { (const unsigned char *) a };
+    struct refstr rb = { (const unsigned char *) b };
+    size_t n;
+
+    for (n = 0; maxlen == 0 || n < maxlen; n++) {
+	unsigned wa, wb;
+	int ea = *ra.ptr == 0 || utf8_mbtowc_internal(&ra, ref_next, &wa) < 0;
+	int eb = *rb.ptr == 0 || utf8_mbtowc_internal(&rb, ref_next, &wb) < 0;
+
+	if (ea || eb)
+	    return eb - ea;
+	if (ci == case_insensitive) {
+	    wa = utf8_wc_toupper(wa);
+	    wb = utf8_wc_toupper(wb);
+	}
+	if (wa != wb)
+	    return wa < wb ? -1 : 1;
+    }
+    return 0;
+}
+
+static unsigned *
+ref_mbstr_to_wc(const char *s)
+{
+    struct refstr rs = { (const unsigned char *) s };
+    unsigned *w = calloc(strlen(s) + 1, sizeof(w[0]));
+    size_t i = 0;
+
+    if (!w)
+	abort();
+    while (*rs.ptr) {
+	if (utf8_mbtowc_internal(&rs, ref_next, &w[i++]) < 0)
+	    abort();
+    }
+    return w;
+}
+
+static int
+sign(int n)
+{
+    return n < 0 ? -1 : n > 0;
+}
+
+static double
+elapsed(clock_t start)
+{
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* bench [-count=N] FILE
+   Run the UTF-8 primitives over the words from FILE (one per line), N
+   times.  Verify that the results agree with the reference
+   implementations and report the timings on stderr. */
+static int
+op_bench(int argc, char **argv)
+{
+    char *opname = *argv++;
+    long i, j, k, count = 100;
+    char **words = NULL, **upper;
+    size_t nwords = 0, maxwords = 0;
+    char buf[512];
+    FILE *fp;
+    clock_t start;
+    volatile long sum = 0;
+    int bad;
+
+    argc--;
+    if (argc > 0 && strncmp(argv[0], "-count=", 7) == 0) {
+	count = atol(argv[0] + 7);
+	argc--;
+	argv++;
+    }
+    if (argc != 1) {
+	dico_log(L_ERR, 0, "%s requires one argument", opname);
+	return 1;
+    }
+    fp = fopen(argv[0], "r");
+    if (!fp) {
+	dico_log(L_ERR, errno, "cannot open %s", argv[0]);
+	return 1;
+    }
+    while (fgets(buf, sizeof(buf), fp)) {
+	buf[strcspn(buf, "\n")] = 0;
+	if (nwords == maxwords) {
+	    maxwords = maxwords ? 2 * maxwords : 64;
+	    words = realloc(words, maxwords * sizeof(words[0]));
+	    if (!words)
+		abort();
+	}
+	if (!(words[nwords++] = strdup(buf)))
+	    abort();
+    }
+    fclose(fp);
+    if (nwords == 0) {
+	dico_log(L_ERR, 0, "no words");
+	return 1;
+    }
+
+    /* strlen */
+    bad = 0;
+    for (i = 0; i < nwords; i++)
+	if (utf8_strlen(words[i]) != ref_strlen(words[i]))
+	    bad++;
+    printf("strlen: %s\n", bad ? "FAILED" : "ok");
+    start = clock();
+    for (k = 0; k < count; k++)
+	for (i = 0; i < nwords; i++)
+	    sum += ref_strlen(words[i]);
+    fprintf(stderr, "strlen: reference %.3fs, ", elapsed(start));
+    start = clock();
+    for (k = 0; k < count; k++)
+	for (i = 0; i < nwords; i++)
+	    sum += utf8_strlen(words[i]);
+    fprintf(stderr, "library %.3fs\n", elapsed(start));
+
+    /* Comparisons.  The timings are taken comparing each word with its
+       upper-case variant, as when looking up a word in a sorted
+       index. */
+    upper = calloc(nwords, sizeof(upper[0]));
+    if (!upper)
+	abort();
+    for (i = 0; i < nwords; i++) {
+	if (!(upper[i] = strdup(words[i])) || utf8_toupper(upper[i]))
+	    abort();
+    }
+    for (i = 0; i < nwords; i++)
+	for (j = 0; j < nwords; j++)
+	    if (sign(utf8_strcasecmp(words[i], words[j]))
+		  != ref_compare(words[i], words[j], case_insensitive, 0)
+		|| sign(utf8_strcmp(words[i], words[j]))
+		  != ref_compare(words[i], words[j], case_sensitive, 0)
+		|| sign(utf8_strncasecmp(words[i], words[j], 3))
+		  != ref_compare(words[i], words[j], case_insensitive, 3))
+		bad++;
+    printf("compare: %s\n", bad ? "FAILED" : "ok");
+    start = clock();
+    for (k = 0; k < count; k++)
+	for (i = 0; i < nwords; i++)
+	    sum += ref_compare(words[i], upper[i], case_insensitive, 0);
+    fprintf(stderr, "compare: reference %.3fs, ", elapsed(start));
+    start = clock();
+    for (k = 0; k < count; k++)
+	for (i = 0; i < nwords; i++)
+	    sum += utf8_strcasecmp(words[i], upper[i]);
+    fprintf(stderr, "library %.3fs\n", elapsed(start));
+
+    /* Conversion to wide characters */
+    for (i = 0; i < nwords; i++) {
+	unsigned *wa, *wb;
+	size_t len;
+
+	if (utf8_mbstr_to_wc(words[i], &wa, &len))
+	    abort();
+	wb = ref_mbstr_to_wc(words[i]);
+	if (len != utf8_wc_strlen(wb) || utf8_wc_strcmp(wa, wb))
+	    bad++;
+	free(wa);
+	free(wb);
+    }
+    printf("mbstr_to_wc: %s\n", bad ? "FAILED" : "ok");
+    start = clock();
+    for (k = 0; k < count; k++)
+	for (i = 0; i < nwords; i++)
+	    free(ref_mbstr_to_wc(words[i]));
+    fprintf(stderr, "mbstr_to_wc: reference %.3fs, ", elapsed(start));
+    start = clock();
+    for (k = 0; k < count; k++)
+	for (i = 0; i < nwords; i++) {
+	    unsigned *w;
+	    utf8_mbstr_to_wc(words[i], &w, NULL);
+	    free(w);
+	}
+    fprintf(stderr, "library %.3fs\n", elapsed(start));
+
+    return bad != 0;
+}
+
 struct optab optab[] = {
     { "help", help },
     { "strlen", op_strlen },
@@ -266,9 +504,11 @@ struct optab optab[] = {
     { "wc_strncasecmp", op_wc_strncasecmp },
     { "toupper", op_toupper },
     { "tolower", op_tolower },
+    { "casefold", op_casefold },
     { "wc_strchr", op_wc_strchr },
     { "wc_strchr_ci", op_wc_strchr_ci },
     { "wc_strstr", op_wc_strstr },
+    { "bench", op_bench },
     { NULL }
 };
 
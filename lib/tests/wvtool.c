@@ -0,0 +1,175 @@
+/* This file is part of GNU Dico
+   Copyright (C) 2012-2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <config.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <dico.h>
+
+/* Test vectored writes.
+
+   Usage: wvtool [-max=N] [-bufsize=N] [-crlf] ARG [ARG...]
+
+   Arguments up to a ":" are written to the stream in a single
+   dico_stream_writev call, each argument as a separate buffer.  The
+   escapes \n and \r in arguments stand for newline and carriage
+   return.  The data end up on stdout through a stream that writes at
+   most N bytes at a time (-max), so that the caller has to resume
+   writing in the middle of a buffer.  Each call of its writev method is
+   reported on stderr as the number of buffers passed and the number of
+   bytes written. */
+
+#define MAX_ARGS 64
+
+struct limstr {
+    int fd;
+    size_t max;
+};
+
+static int
+lim_writev(void *data, const struct iovec *iov, int iovcnt, size_t *pret)
+{
+    struct limstr *p = data;
+    struct iovec v[MAX_ARGS];
+    size_t size = 0;
+    ssize_t n;
+    int i;
+
+    for (i = 0; i < iovcnt && i < MAX_ARGS && size < p->max; i++) {
+	v[i] = iov[i];
+	if (v[i].iov_len > p->max - size)
+	    v[i].iov_len = p->max - size;
+	size += v[i].iov_len;
+    }
+    n = writev(p->fd, v, i);
+    if (n == -1)
+	return errno;
+    fprintf(stderr, "%d %zd\n", iovcnt, n);
+    *pret = n;
+    return 0;
+}
+
+static int
+lim_write(void *data, const char *buf, size_t size, size_t *pret)
+{
+    struct iovec iov;
+
+    iov.iov_base = (void*) buf;
+    iov.iov_len = size;
+    return lim_writev(data, &iov, 1, pret);
+}
+
+static void
+unescape(char *s)
+{
+    char *p;
+
+    for (p = s; *s; s++) {
+	if (*s == '\\' && s[1]) {
+	    switch (*++s) {
+	    case 'n':
+		*p++ = '\n';
+		break;
+	    case 'r':
+		*p++ = '\r';
+		break;
+	    default:
+		*p++ = *s;
+	    }
+	} else
+	    *p++ = *s;
+    }
+    *p = 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    struct limstr lim = { 1, (size_t)-1 };
+    size_t bufsize = 0;
+    int crlf = 0;
+    dico_stream_t out, s;
+    struct iovec iov[MAX_ARGS];
+    int n, rc;
+
+    dico_set_program_name(argv[0]);
+
+    while (--argc) {
+	char *arg = *++argv;
+	if (strncmp(arg, "-max=", 5) == 0)
+	    lim.max = atoi(arg + 5);
+	else if (strncmp(arg, "-bufsize=", 9) == 0)
+	    bufsize = atoi(arg + 9);
+	else if (strcmp(arg, "-crlf") == 0)
+	    crlf = 1;
+	else if (strcmp(arg, "--") == 0) {
+	    --argc;
+	    ++argv;
+	    break;
+	} else if (arg[0] == '-') {
+	    dico_log(L_ERR, 0, "unknown option '%s'", arg);
+	    return 1;
+	} else
+	    break;
+    }
+
+    if (dico_stream_create(&out, DICO_STREAM_WRITE, &lim)) {
+	dico_log(L_ERR, errno, "cannot create stream");
+	return 2;
+    }
+    dico_stream_set_write(out, lim_write);
+    dico_stream_set_writev(out, lim_writev);
+
+    if (crlf) {
+	s = dico_crlf_stream(out, DICO_STREAM_WRITE, 0);
+	if (!s) {
+	    dico_log(L_ERR, errno, "cannot create filter stream");
+	    return 2;
+	}
+	out = s;
+    }
+    if (bufsize)
+	dico_stream_set_buffer(out, dico_buffer_full, bufsize);
+    else
+	dico_stream_set_buffer(out, dico_buffer_none, 0);
+    
+    while (argc) {
+	for (n = 0; argc && n < MAX_ARGS; argc--, argv++) {
+	    if (strcmp(*argv, ":") == 0) {
+		argc--;
+		argv++;
+		break;
+	    }
+	    unescape(*argv);
+	    iov[n].iov_base = *argv;
+	    iov[n].iov_len = strlen(*argv);
+	    n++;
+	}
+	rc = dico_stream_writev(out, iov, n);
+	if (rc) {
+	    dico_log(L_ERR, 0, "write error: %s",
+		     dico_stream_strerror(out, rc));
+	    return 2;
+	}
+    }
+    
+    dico_stream_close(out);
+    dico_stream_destroy(&out);
+    return 0;
+}
@@ -0,0 +1,311 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <config.h>
+#include <dico.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+
+/* Trigram index.
+
+   For each sequence of three consecutive characters (a trigram) found
+   in the headwords of a database, the index keeps the sorted list of
+   numbers of the headwords it occurs in (a posting list).  Characters
+   are converted to upper case, as done by the substr strategy.
+
+   Any headword containing a given string contains all of its trigrams,
+   so intersecting their posting lists yields a small set of candidates,
+   which are then verified using the strategy selector. */
+
+/* A trigram is packed into a 64-bit key, 21 bits per character. */
+typedef uint64_t trigram_t;
+
+#define TRIGRAM(a,b,c) \
+    (((trigram_t)(a) << 42) | ((trigram_t)(b) << 21) | (trigram_t)(c))
+#define CHAR_MASK 0x1fffff
+
+struct dico_trigram_index {
+    size_t nkeys;         /* Number of distinct trigrams */
+    trigram_t *keys;      /* Sorted array of trigrams */
+    size_t *off;          /* Posting list of keys[i] begins at post[off[i]]
+			     and ends at post[off[i+1]] */
+    unsigned *post;       /* Posting lists */
+};
+
+struct trigram_pair {
+    trigram_t key;
+    unsigned n;
+};
+
+static int
+compare_pair(const void *a, const void *b, void *closure)
+{
+    struct trigram_pair const *pa = a;
+    struct trigram_pair const *pb = b;
+
+    if (pa->key < pb->key)
+	return -1;
+    if (pa->key > pb->key)
+	return 1;
+    if (pa->n < pb->n)
+	return -1;
+    if (pa->n > pb->n)
+	return 1;
+    return 0;
+}
+
+/* Convert WORD to an upper-case wide character string.  Return its
+   length in *PLEN. */
+static unsigned *
+word_to_wc(const char *word, size_t *plen)
+{
+    unsigned *wc;
+    size_t i, len;
+
+    if (utf8_casefold_wc(word, &wc, &len))
+	return NULL;
+    for (i = 0; i < len; i++)
+	wc[i] &= CHAR_MASK;
+    *plen = len;
+    return wc;
+}
+
+dico_trigram_index_t
+dico_trigram_index_create(size_t nelem, dico_index_word_t getword,
+			  void *closure)
+{
+    struct dico_trigram_index *idx;
+    struct trigram_pair *pairs = NULL;
+    size_t npairs = 0, maxpairs = 0;
+    size_t i, j, k;
+
+    if (nelem > UINT_MAX) {
+	errno = ERANGE;
+	return NULL;
+    }
+
+    for (i = 0; i < nelem; i++) {
+	unsigned *wc;
+	size_t len;
+
+	wc = word_to_wc(getword(i, closure), &len);
+	if (!wc)
+	    continue;
+	for (j = 0; j + 2 < len; j++) {
+	    if (npairs == maxpairs) {
+		size_t n = maxpairs ? 2 * maxpairs : 1024;
+		struct trigram_pair *p = realloc(pairs, n * sizeof(pairs[0]));
+		if (!p) {
+		    free(wc);
+		    free(pairs);
+		    return NULL;
+		}
+		pairs = p;
+		maxpairs = n;
+	    }
+	    pairs[npairs].key = TRIGRAM(wc[j], wc[j+1], wc[j+2]);
+	    pairs[npairs].n = i;
+	    npairs++;
+	}
+	free(wc);
+    }
+
+    if (dico_psort(pairs, npairs, sizeof(pairs[0]), compare_pair, NULL)) {
+	free(pairs);
+	return NULL;
+    }
+
+    /* Remove duplicates and count distinct keys. */
+    for (i = j = k = 0; i < npairs; i++) {
+	if (j > 0 && compare_pair(&pairs[j-1], &pairs[i], NULL) == 0)
+	    continue;
+	if (j == 0 || pairs[j-1].key != pairs[i].key)
+	    k++;
+	pairs[j++] = pairs[i];
+    }
+    npairs = j;
+
+    idx = calloc(1, sizeof(*idx));
+    if (!idx) {
+	free(pairs);
+	return NULL;
+    }
+    idx->nkeys = k;
+    idx->keys = calloc(k ? k : 1, sizeof(idx->keys[0]));
+    idx->off = calloc(k + 1, sizeof(idx->off[0]));
+    idx->post = calloc(npairs ? npairs : 1, sizeof(idx->post[0]));
+    if (!idx->keys || !idx->off || !idx->post) {
+	free(pairs);
+	dico_trigram_index_free(idx);
+	return NULL;
+    }
+
+    for (i = k = 0; i < npairs; i++) {
+	if (i == 0 || pairs[i-1].key != pairs[i].key) {
+	    idx->keys[k] = pairs[i].key;
+	    idx->off[k] = i;
+	    k++;
+	}
+	idx->post[i] = pairs[i].n;
+    }
+    idx->off[k] = npairs;
+    free(pairs);
+    return idx;
+}
+
+void
+dico_trigram_index_free(dico_trigram_index_t idx)
+{
+    if (idx) {
+	free(idx->keys);
+	free(idx->off);
+	free(idx->post);
+	free(idx);
+    }
+}
+
+struct posting {
+    unsigned *start;
+    size_t len;
+};
+
+static int
+find_posting(dico_trigram_index_t idx, trigram_t key, struct posting *p)
+{
+    size_t l = 0, u = idx->nkeys;
+
+    while (l < u) {
+	size_t m = (l + u) / 2;
+	if (idx->keys[m] < key)
+	    l = m + 1;
+	else if (idx->keys[m] > key)
+	    u = m;
+	else {
+	    p->start = idx->post + idx->off[m];
+	    p->len = idx->off[m+1] - idx->off[m];
+	    return 0;
+	}
+    }
+    return 1;
+}
+
+static int
+compare_posting(const void *a, const void *b)
+{
+    struct posting const *pa = a;
+    struct posting const *pb = b;
+    if (pa->len < pb->len)
+	return -1;
+    if (pa->len > pb->len)
+	return 1;
+    return 0;
+}
+
+/* Return true if N is found in P.  *POS is the position where the
+   search begins.  It is advanced past the elements less than N. */
+static int
+posting_member(struct posting *p, size_t *pos, unsigned n)
+{
+    size_t l = *pos, u, step = 1;
+
+    /* Galloping search for the upper bound */
+    u = l;
+    while (u < p->len && p->start[u] < n) {
+	l = u;
+	u += step;
+	step *= 2;
+    }
+    if (u > p->len)
+	u = p->len;
+    while (l < u) {
+	size_t m = (l + u) / 2;
+	if (p->start[m] < n)
+	    l = m + 1;
+	else
+	    u = m;
+    }
+    *pos = l;
+    return l < p->len && p->start[l] == n;
+}
+
+/* Look up candidates for headwords containing WORD.
+
+   On success, store in *PCAND a malloc'ed array of headword numbers in
+   ascending order, store its size in *PCOUNT, and return 0.  Return 1
+   if WORD is too short for the index to be of any use, and -1 on
+   error.  In both cases, *PCAND and *PCOUNT are left untouched. */
+int
+dico_trigram_index_lookup(dico_trigram_index_t idx, const char *word,
+			  size_t **pcand, size_t *pcount)
+{
+    unsigned *wc;
+    size_t len, i, j, n;
+    struct posting *plist;
+    size_t *cand;
+
+    wc = word_to_wc(word, &len);
+    if (!wc)
+	return -1;
+    if (len < 3) {
+	free(wc);
+	return 1;
+    }
+
+    n = len - 2;
+    plist = calloc(n, sizeof(plist[0]));
+    if (!plist) {
+	free(wc);
+	return -1;
+    }
+    for (i = 0; i < n; i++) {
+	if (find_posting(idx, TRIGRAM(wc[i], wc[i+1], wc[i+2]), &plist[i])) {
+	    /* Unknown trigram: nothing matches */
+	    free(plist);
+	    free(wc);
+	    *pcand = NULL;
+	    *pcount = 0;
+	    return 0;
+	}
+    }
+    free(wc);
+
+    /* Intersect the posting lists, starting from the shortest one. */
+    qsort(plist, n, sizeof(plist[0]), compare_posting);
+    cand = calloc(plist[0].len ? plist[0].len : 1, sizeof(cand[0]));
+    if (!cand) {
+	free(plist);
+	return -1;
+    }
+    for (i = 0; i < plist[0].len; i++)
+	cand[i] = plist[0].start[i];
+    len = plist[0].len;
+
+    for (j = 1; j < n && len > 0; j++) {
+	size_t pos = 0, k = 0;
+	for (i = 0; i < len; i++)
+	    if (posting_member(&plist[j], &pos, cand[i]))
+		cand[k++] = cand[i];
+	len = k;
+    }
+    free(plist);
+
+    *pcand = cand;
+    *pcount = len;
+    return 0;
+}
@@ -19,6 +19,30 @@
 #include <limits.h>
 #include <errno.h>
 #include <string.h>
+#include <stdint.h>
+#include "casefold.h"
+
+/* Vectorized ASCII fast paths.  Bulk of the headwords in most
+   dictionaries is pure ASCII, which needs neither decoding nor table
+   lookups.  SSE2 is part of the x86-64 baseline; AVX2 is used if the
+   library is compiled for it (e.g. with -mavx2).  Address sanitizer
+   builds use the scalar code, because the vector code reads past the
+   terminating NUL (without crossing a page boundary). */
+#if defined(__has_feature)
+# if __has_feature(address_sanitizer)
+#  define __SANITIZE_ADDRESS__ 1
+# endif
+#endif
+#if defined(__GNUC__) && !defined(__SANITIZE_ADDRESS__)
+# if defined(__AVX2__)
+#  include <immintrin.h>
+#  define UTF8_AVX2 1
+# endif
+# if defined(__SSE2__)
+#  include <emmintrin.h>
+#  define UTF8_SSE2 1
+# endif
+#endif
 
 struct unicase_info_st {
     unsigned toupper;
@@ -28,7 +52,11 @@ struct unicase_info_st {
 
 typedef struct unicase_info_st MY_UNICASE_INFO;
 
-/* UTF tables written by Alexander Barkov <bar@udm.net> */
+/* UTF tables written by Alexander Barkov <bar@udm.net>.
+
+   These tables are the source of the case mapping tables in casefold.h,
+   which are generated from them by casefold.awk.  If you change them,
+   run "make casefold.h". */
 static MY_UNICASE_INFO plane00[] = {
     {0x0000, 0x0000, 0x0000}, {0x0001, 0x0001, 0x0001},
     {0x0002, 0x0002, 0x0002}, {0x0003, 0x0003, 0x0003},
@@ -1506,6 +1534,126 @@ MY_UNICASE_INFO *uni_plane[256] = {
 };
 
 
+/* Return the number of leading ASCII characters in STR, i.e. the
+   length of its longest prefix consisting of bytes 0x01 - 0x7f. */
+static inline size_t
+ascii_span(const char *str)
+{
+    const unsigned char *s = (const unsigned char *) str;
+    const unsigned char *p = s;
+#if defined(UTF8_SSE2) || defined(UTF8_AVX2)
+# if defined(UTF8_AVX2)
+#  define ASCII_SPAN_ALIGN 32
+# else
+#  define ASCII_SPAN_ALIGN 16
+# endif
+    /* Advance to the alignment boundary byte by byte.  Aligned loads
+       never cross a page boundary, hence it is safe to read past the
+       terminating NUL. */
+    while ((uintptr_t) p & (ASCII_SPAN_ALIGN - 1)) {
+	if (*p == 0 || (*p & 0x80))
+	    return p - s;
+	p++;
+    }
+    for (;;) {
+	unsigned mask;
+# if defined(UTF8_AVX2)
+	__m256i v = _mm256_load_si256((const __m256i *) p);
+	/* Mark NUL bytes and bytes with the high bit set */
+	mask = _mm256_movemask_epi8(_mm256_or_si256(v,
+			  _mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+# else
+	__m128i v = _mm_load_si128((const __m128i *) p);
+	mask = _mm_movemask_epi8(_mm_or_si128(v,
+			  _mm_cmpeq_epi8(v, _mm_setzero_si128())));
+# endif
+	if (mask)
+	    return p - s + __builtin_ctz(mask);
+	p += ASCII_SPAN_ALIGN;
+    }
+#else
+    while (*p && !(*p & 0x80))
+	p++;
+    return p - s;
+#endif
+}
+
+static inline int
+ascii_toupper(int c)
+{
+    return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c;
+}
+
+#ifdef UTF8_SSE2
+/* Return true if reading 16 bytes at P does not cross a page
+   boundary. */
+# define SAFE_LOAD16(p) (((uintptr_t)(p) & 4095) <= 4096 - 16)
+
+/* Convert lower-case ASCII letters in V to upper case */
+static inline __m128i
+ascii_upcase16(__m128i v)
+{
+    __m128i lc = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)),
+			       _mm_cmplt_epi8(v, _mm_set1_epi8('z' + 1)));
+    return _mm_sub_epi8(v, _mm_and_si128(lc, _mm_set1_epi8(0x20)));
+}
+#endif
+
+/* Return the length of the longest common prefix of A and B, not
+   longer than MAX, that consists of ASCII characters.  If CI is
+   case_insensitive, ASCII letters are compared ignoring case, which
+   agrees with utf8_wc_toupper. */
+static inline size_t
+ascii_common_prefix(const char *a, const char *b, int ci, size_t max)
+{
+    size_t n = 0;
+
+#ifdef UTF8_SSE2
+    /* Headwords often differ in the very first character: check it
+       before setting up vector comparisons. */
+    if (max > 0 && *a && !(*a & 0x80)) {
+	unsigned char ca = *a, cb = *b;
+	if (ci == case_insensitive) {
+	    ca = ascii_toupper(ca);
+	    cb = ascii_toupper(cb);
+	}
+	if (ca != cb)
+	    return 0;
+    } else
+	return 0;
+    while (n + 16 <= max && SAFE_LOAD16(a + n) && SAFE_LOAD16(b + n)) {
+	__m128i va = _mm_loadu_si128((const __m128i *) (a + n));
+	__m128i vb = _mm_loadu_si128((const __m128i *) (b + n));
+	unsigned stop;
+
+	/* Stop at non-ASCII and NUL bytes of A ... */
+	stop = _mm_movemask_epi8(_mm_or_si128(va,
+				 _mm_cmpeq_epi8(va, _mm_setzero_si128())));
+	if (ci == case_insensitive) {
+	    va = ascii_upcase16(va);
+	    vb = ascii_upcase16(vb);
+	}
+	/* ... and at the first difference. */
+	stop |= ~_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) & 0xffff;
+	if (stop)
+	    return n + __builtin_ctz(stop);
+	n += 16;
+    }
+#endif
+    for (; n < max; n++) {
+	unsigned char ca = a[n], cb = b[n];
+	if (ca == 0 || (ca & 0x80))
+	    break;
+	if (ci == case_insensitive) {
+	    ca = ascii_toupper(ca);
+	    cb = ascii_toupper(cb);
+	}
+	if (ca != cb)
+	    break;
+    }
+    return n;
+}
+
 size_t
 utf8_char_width(const char *ch)
 {
@@ -1527,7 +1675,12 @@ utf8_strlen(const char *s)
     size_t len = 0;
     size_t n;
 
-    while (*s && (n = utf8_char_width(s)) != 0) {
+    for (;;) {
+	n = ascii_span(s);
+	len += n;
+	s += n;
+	if (!*s || (n = utf8_char_width(s)) == 0)
+	    break;
 	len++;
 	s += n;
     }
@@ -1738,6 +1891,12 @@ int
 utf8_mbtowc(unsigned int *pwc, const char *r, size_t len)
 {
     struct tstring ts;
+    unsigned char c = *r;
+
+    if (c != 0 && c < 0x80) {
+	*pwc = c;
+	return 1;
+    }
     ts.ptr = (const unsigned char*)r;
     ts.len = len ? len : utf8_char_width(r);
     return utf8_mbtowc_internal(&ts, _next_char_from_string, pwc);
@@ -1783,16 +1942,29 @@ utf8_compare(char const *a, char const *b,
     unsigned wa, wb;
 
     while (1) {
+	if (!wcsel) {
+	    /* Skip common ASCII prefix */
+	    size_t n = ascii_common_prefix(a, b, ci,
+					   maxlen ? maxlen - an : SIZE_MAX);
+	    a += n;
+	    b += n;
+	    an += n;
+	    bn += n;
+	}
 	if (maxlen != 0 && an == maxlen)
 	    return 0;
 	if (*a == 0)
 	    break;
 	
-	alen = utf8_char_width(a);
-	if (alen == 0)
-	    return -1;
-	
-	utf8_mbtowc(&wa, a, alen);
+	if (!(*a & 0x80)) {
+	    wa = *a;
+	    alen = 1;
+	} else {
+	    alen = utf8_char_width(a);
+	    if (alen == 0)
+		return -1;
+	    utf8_mbtowc(&wa, a, alen);
+	}
 	a += alen;
 	an++;
 
@@ -1802,17 +1974,22 @@ utf8_compare(char const *a, char const *b,
 	    while (*b) {
 		if (maxlen != 0 && bn == maxlen)
 		    return 0;
-		blen = utf8_char_width(b);
-		if (blen == 0)
-		    return 1;
-		utf8_mbtowc(&wb, b, blen);
+		if (!(*b & 0x80)) {
+		    wb = *b;
+		    blen = 1;
+		} else {
+		    blen = utf8_char_width(b);
+		    if (blen == 0)
+			return 1;
+		    utf8_mbtowc(&wb, b, blen);
+		}
 		b += blen;
 		bn++;
 		
 		if (!wcsel || wcsel(wb)) {
 		    if (ci == case_insensitive) {
-			wa = utf8_wc_toupper(wa);
-			wb = utf8_wc_toupper(wb);
+			wa = wa < 0x80 ? ascii_toupper(wa) : utf8_wc_toupper(wa);
+			wb = wb < 0x80 ? ascii_toupper(wb) : utf8_wc_toupper(wb);
 		    }
 		    if (wa < wb)
 			return -1;
@@ -1855,11 +2032,21 @@ utf8_strncasecmp(char const *a, char const *b, size_t maxlen)
     return utf8_compare(a, b, case_insensitive, maxlen, NULL);
 }
 
+#define CASEFOLD_BLOCK_MASK ((1 << CASEFOLD_BLOCK_BITS) - 1)
+
+/* Map WC using the two-stage table TAB from casefold.h.  Characters
+   outside of the Basic Multilingual Plane have no case mappings. */
+#define CASEFOLD_LOOKUP(tab, wc)					\
+    ((wc) < 0x10000							\
+     ? (wc) + casefold_##tab##_delta					\
+		[casefold_##tab##_index[(wc) >> CASEFOLD_BLOCK_BITS]]	\
+		[(wc) & CASEFOLD_BLOCK_MASK]				\
+     : (wc))
+
 unsigned
 utf8_wc_toupper(unsigned wc)
 {
-    int plane = (wc >> 8) & 0xFF;
-    return uni_plane[plane] ? uni_plane[plane][wc & 0xFF].toupper : wc;
+    return CASEFOLD_LOOKUP(upper, wc);
 }
 
 int
@@ -1881,8 +2068,7 @@ utf8_toupper(char *s)
 unsigned
 utf8_wc_tolower(unsigned wc)
 {
-    int plane = (wc >> 8) & 0xFF;
-    return uni_plane[plane] ? uni_plane[plane][wc & 0xFF].tolower : wc;
+    return CASEFOLD_LOOKUP(lower, wc);
 }
 
 int
@@ -1900,6 +2086,109 @@ utf8_tolower(char *s)
     }
     return 0;
 }
+
+/* Case folding.
+
+   Case-insensitive comparisons in Dico map characters to upper case,
+   so folding is the same as utf8_wc_toupper.  The functions below
+   decode and fold a string in a single pass, copying runs of ASCII
+   characters without table lookups. */
+
+unsigned
+utf8_wc_fold(unsigned wc)
+{
+    return CASEFOLD_LOOKUP(upper, wc);
+}
+
+/* Fold the case of the UTF-8 string STR.  Store the folded string in
+   a malloc'ed buffer and return it in *SPTR.  Return 0 on success, and
+   -1 on error (invalid input or not enough memory), setting errno. */
+int
+utf8_casefold(const char *str, char **sptr)
+{
+    size_t len = strlen(str);
+    /* A folded character is at most one byte longer than the original
+       one, which is at least two bytes long. */
+    char *s = malloc(len + len / 2 + 1);
+    size_t i = 0;
+
+    if (!s)
+	return -1;
+    while (len) {
+	size_t n = ascii_span(str);
+	unsigned wc;
+	int rc;
+
+	if (n) {
+	    size_t k;
+	    for (k = 0; k < n; k++)
+		s[i + k] = ascii_toupper((unsigned char) str[k]);
+	    i += n;
+	    str += n;
+	    len -= n;
+	    if (!len)
+		break;
+	}
+	rc = utf8_mbtowc(&wc, str, len);
+	if (rc <= 0) {
+	    int ec = errno;
+	    free(s);
+	    errno = ec;
+	    return -1;
+	}
+	str += rc;
+	len -= rc;
+	i += utf8_wctomb(s + i, utf8_wc_fold(wc));
+    }
+    s[i] = 0;
+    *sptr = s;
+    return 0;
+}
+
+/* Decode the UTF-8 string STR into a zero-terminated array of folded
+   wide characters.  Return the array in *WPTR and, unless PLEN is NULL,
+   the number of characters in *PLEN.  Return 0 on success, and -1 on
+   error, setting errno. */
+int
+utf8_casefold_wc(const char *str, unsigned **wptr, size_t *plen)
+{
+    size_t len = strlen(str);
+    size_t i = 0;
+    unsigned *w = calloc(len + 1, sizeof(w[0]));
+
+    if (!w)
+	return -1;
+    while (len) {
+	size_t n = ascii_span(str);
+	int rc;
+
+	if (n) {
+	    size_t k;
+	    for (k = 0; k < n; k++)
+		w[i + k] = ascii_toupper((unsigned char) str[k]);
+	    i += n;
+	    str += n;
+	    len -= n;
+	    if (!len)
+		break;
+	}
+	rc = utf8_mbtowc(w + i, str, len);
+	if (rc <= 0) {
+	    int ec = errno;
+	    free(w);
+	    errno = ec;
+	    return -1;
+	}
+	w[i] = utf8_wc_fold(w[i]);
+	i++;
+	str += rc;
+	len -= rc;
+    }
+    *wptr = w;
+    if (plen)
+	*plen = i;
+    return 0;
+}
 
 
 size_t
@@ -2239,8 +2528,22 @@ utf8_mbstr_to_wc(const char *str, unsigned **wptr, size_t *plen)
 
     if (!w)
 	return -1;
-    for (i = 0, len = strlen(str); len; i++) {
-	int rc = utf8_mbtowc(w + i, str, len);
+    for (i = 0, len = sc; len; i++) {
+	size_t n = ascii_span(str);
+	int rc;
+
+	if (n) {
+	    /* Copy ASCII characters verbatim */
+	    size_t k;
+	    for (k = 0; k < n; k++)
+		w[i + k] = (unsigned char) str[k];
+	    i += n;
+	    str += n;
+	    len -= n;
+	    if (!len)
+		break;
+	}
+	rc = utf8_mbtowc(w + i, str, len);
 	if (rc <= 0) {
 	    int ec = errno;
 	    free(w);
@@ -2252,7 +2555,7 @@ utf8_mbstr_to_wc(const char *str, unsigned **wptr, size_t *plen)
     }
     *wptr = w;
     if (plen)
-	*plen = sc;
+	*plen = i;
     return 0;
 }
 
@@ -2271,9 +2574,15 @@ utf8_mbstr_to_norm_wc(const char *str, unsigned **nptr, size_t * plen)
 
     while (len > 0) {
 	unsigned wc;
-	int rc = utf8_mbtowc(&wc, str, len);
-	if (rc <= 0)
+	int rc;
+
+	if (*str && !(*str & 0x80)) {
+	    wc = (unsigned char) *str;
+	    rc = 1;
+	} else if ((rc = utf8_mbtowc(&wc, str, len)) <= 0) {
+	    free(base);
 	    return -1;
+	}
 	str += rc;
 	len -= rc;
 	if (rc == 1 && ISWS(wc)) {
@@ -21,6 +21,9 @@ static size_t compare_count;
 static int sort_index;
 static int trim_ws;
 static int show_dictorg_entries;
+static int trigram_index;
+static int search_index;
+static int key_index;
 
 static int
 is_alnumspace(unsigned c)
@@ -58,6 +61,16 @@ compare_index_entry(const void *a, const void *b, void *closure)
     return headword_compare(epa->word, epb->word, (struct dictdb *)closure);
 }
 
+/* Same as compare_index_entry, but does not update compare_count, so
+   that it can be used by dico_psort. */
+static int
+sort_index_entry(const void *a, const void *b, void *closure)
+{
+    const struct index_entry *epa = a;
+    const struct index_entry *epb = b;
+    return headword_compare(epa->word, epb->word, (struct dictdb *)closure);
+}
+
 static int get_db_flag(struct dictdb *db, const char *name);
     
 static int register_strategies(void);
@@ -68,6 +81,9 @@ static struct dico_option init_option[] = {
     { DICO_OPTSTR(trim-ws), dico_opt_bool, &trim_ws },
     { DICO_OPTSTR(show-dictorg-entries), dico_opt_bool,
       &show_dictorg_entries },
+    { DICO_OPTSTR(trigram-index), dico_opt_bool, &trigram_index },
+    { DICO_OPTSTR(search-index), dico_opt_bool, &search_index },
+    { DICO_OPTSTR(key-index), dico_opt_bool, &key_index },
     { NULL }
 };
 
@@ -128,6 +144,10 @@ free_db(struct dictdb *db)
 	}
 	free(db->suf_index);
     }
+    free(db->runs);
+    dico_trigram_index_free(db->trigram);
+    dico_search_index_free(db->search);
+    dico_list_destroy(&db->key_index);
     free(db->index);
     free(db->basename);
     free(db);
@@ -432,6 +452,75 @@ open_stream(struct dictdb *db)
     return 1;
 }
 
+static const char *
+index_entry_word(size_t n, void *closure)
+{
+    struct dictdb *db = closure;
+    return db->index[n].word;
+}
+
+static int
+free_key_index(void *item, void *data)
+{
+    dico_key_index_free(item);
+    return 0;
+}
+
+/* Build derived key indexes for all strategies that supply a key
+   derivation function. */
+static void
+init_key_index(struct dictdb *db)
+{
+    dico_iterator_t itr;
+    dico_strategy_t strat;
+
+    itr = dico_strategy_iterator();
+    if (!itr) {
+	DICO_LOG_MEMERR();
+	return;
+    }
+    for (strat = dico_iterator_first(itr); strat;
+	 strat = dico_iterator_next(itr)) {
+	dico_key_index_t idx;
+	
+	if (!strat->keyfn)
+	    continue;
+	if (!db->key_index) {
+	    db->key_index = dico_list_create();
+	    if (!db->key_index) {
+		DICO_LOG_MEMERR();
+		break;
+	    }
+	    dico_list_set_free_item(db->key_index, free_key_index, NULL);
+	}
+	idx = dico_key_index_create(strat->keyfn, db->numwords,
+				    index_entry_word, db);
+	if (!idx) {
+	    dico_log(L_WARN, errno, _("%s: cannot build %s key index"),
+		     db->dbname, strat->name);
+	    continue;
+	}
+	dico_list_append(db->key_index, idx);
+    }
+    dico_iterator_destroy(&itr);
+}
+
+static dico_key_index_t
+find_key_index(struct dictdb *db, dico_strat_keyfn_t keyfn)
+{
+    dico_iterator_t itr;
+    dico_key_index_t idx;
+
+    if (!db->key_index)
+	return NULL;
+    itr = dico_list_iterator(db->key_index);
+    for (idx = dico_iterator_first(itr); idx; idx = dico_iterator_next(itr))
+	if (dico_key_index_keyfn(idx) == keyfn)
+	    break;
+    dico_iterator_destroy(&itr);
+    return idx;
+}
+
 static dico_handle_t
 mod_init_db(const char *dbname, int argc, char **argv)
 {
@@ -440,6 +529,9 @@ mod_init_db(const char *dbname, int argc, char **argv)
     int sort_option = sort_index;
     int trimws_option = trim_ws;
     int show_dictorg_option = show_dictorg_entries;
+    int trigram_option = trigram_index;
+    int search_option = search_index;
+    int key_index_option = key_index;
     
     struct dico_option option[] = {
 	{ DICO_OPTSTR(sort), dico_opt_bool, &sort_option },
@@ -447,6 +539,9 @@ mod_init_db(const char *dbname, int argc, char **argv)
 	{ DICO_OPTSTR(trim-ws), dico_opt_bool, &trimws_option },
 	{ DICO_OPTSTR(show-dictorg-entries), dico_opt_bool,
 		      &show_dictorg_option },
+	{ DICO_OPTSTR(trigram-index), dico_opt_bool, &trigram_option },
+	{ DICO_OPTSTR(search-index), dico_opt_bool, &search_option },
+	{ DICO_OPTSTR(key-index), dico_opt_bool, &key_index_option },
 	{ NULL }
     };
 	
@@ -513,8 +608,29 @@ mod_init_db(const char *dbname, int argc, char **argv)
 
     if (sort_option) {
 	/* Sort index entries */
-	dico_sort(db->index, db->numwords, sizeof(db->index[0]),
-		  compare_index_entry, db);
+	dico_psort(db->index, db->numwords, sizeof(db->index[0]),
+		   sort_index_entry, db);
+    }
+
+    if (trigram_option) {
+	db->trigram = dico_trigram_index_create(db->numwords,
+						index_entry_word, db);
+	if (!db->trigram)
+	    dico_log(L_WARN, errno,
+		     _("%s: cannot build trigram index"), dbname);
+    }
+
+    if (key_index_option)
+	init_key_index(db);
+
+    if (search_option) {
+	db->search = dico_search_index_create(db->numwords,
+					      index_entry_word, db,
+					      db->flag_casesensitive
+						? 0 : DICO_SEARCH_CI);
+	if (!db->search)
+	    dico_log(L_WARN, errno,
+		     _("%s: cannot build search index"), dbname);
     }
     
     return (dico_handle_t)db;
@@ -566,8 +682,8 @@ init_suffix_index(struct dictdb *db)
 	    db->suf_index[i].word = p;
 	    db->suf_index[i].ptr = &db->index[i];
 	}
-        dico_sort(db->suf_index, db->numwords, sizeof(db->suf_index[0]),
-		  compare_rev_entry, db);
+        dico_psort(db->suf_index, db->numwords, sizeof(db->suf_index[0]),
+		   compare_rev_entry, db);
     }
     return 0;
 }    
@@ -632,19 +748,39 @@ uniq_comp(const void *a, const void *b, void *closure)
 			    epb->orig ? epb->orig : epb->word, db);
 }
 
+static int compare_prefix(const void *a, const void *b, void *closure);
+
+/* Find the first index entry equal to X or, if PREFIX is true,
+   beginning with it.  If the database has a search index, only the
+   range of entries whose search keys match is searched.  Unless the
+   database has the allchars flag, exact comparisons ignore
+   non-alphanumeric characters, which search keys do not.  The search
+   index is then used for prefix searches only. */
+static struct index_entry *
+index_search(struct dictdb *db, struct index_entry *x, int prefix)
+{
+    size_t start = 0, end = db->numwords;
+
+    if (db->search && (prefix || db->flag_allchars))
+	dico_search_index_range(db->search, x->word, prefix, &start, &end);
+    return dico_bsearch(x, db->index + start, end - start,
+			sizeof(db->index[0]),
+			prefix ? compare_prefix : compare_index_entry, db);
+}
+
 static int
-common_match(struct dictdb *db, const char *word,
-	     int (*compare)(const void *, const void *, void *),
-	     int unique, struct result *res)
+common_match(struct dictdb *db, const char *word, int prefix,
+	     struct result *res)
 {
     struct index_entry x, *ep;
+    int (*compare)(const void *, const void *, void *) =
+	prefix ? compare_prefix : compare_index_entry;
     
     x.word = (char*) word;
     x.length = strlen(word);
     x.wordlen = utf8_strlen(word);
     compare_count = 0;
-    ep = dico_bsearch(&x, db->index, db->numwords, sizeof(db->index[0]),
-		      compare, db);
+    ep = index_search(db, &x, prefix);
     if (ep) {
 	res->type = result_match;
 	res->db = db;
@@ -654,14 +790,17 @@ common_match(struct dictdb *db, const char *word,
 	    return 0;
 	}
 	res->itr = NULL;
-	if (unique) {
+	if (prefix) {
 	    dico_list_set_comparator(res->list, uniq_comp, db);
 	    dico_list_set_flags(res->list, DICO_LIST_COMPARE_TAIL);
 	}
 	for (; ep < db->index + db->numwords
 		 && compare(&x, ep, db) == 0; ep++)
-	    if (!RESERVED_WORD(db, ep->word))
+	    if (!RESERVED_WORD(db, ep->word)) {
+		if (dico_result_limit_reached(dico_list_count(res->list)))
+		    break;
 		dico_list_append(res->list, ep);
+	    }
 	res->compare_count = compare_count;
 	return 0;
     }
@@ -672,7 +811,7 @@ common_match(struct dictdb *db, const char *word,
 static int
 exact_match(struct dictdb *db, const char *word, struct result *res)
 {
-    return common_match(db, word, compare_index_entry, 0, res);
+    return common_match(db, word, 0, res);
 }
 
 static int
@@ -691,7 +830,7 @@ compare_prefix(const void *a, const void *b, void *closure)
 static int
 prefix_match(struct dictdb *db, const char *word, struct result *res)
 {
-    return common_match(db, word, compare_prefix, 1, res);
+    return common_match(db, word, 1, res);
 }
 
 static int
@@ -768,8 +907,11 @@ suffix_match(struct dictdb *db, const char *word, struct result *res)
 	}
 	dico_list_set_comparator(list, uniq_comp, db);
 	dico_list_set_flags(list, DICO_LIST_COMPARE_TAIL);
-	for (i = 0; i < count; i++) 
+	for (i = 0; i < count; i++) {
+	    if (dico_result_limit_reached(dico_list_count(list)))
+		break;
 	    dico_list_append(list, tmp[i]);
+	}
      
 	free(tmp);
 	res->type = result_match;
@@ -795,8 +937,7 @@ find_db_entry(struct dictdb *db, const char *name)
     x.word = (char*) name;
     x.length = strlen(name);
     x.wordlen = utf8_strlen(name);
-    ep = dico_bsearch(&x, db->index, db->numwords, sizeof(db->index[0]),
-		      compare_index_entry, db);
+    ep = index_search(db, &x, 0);
     if (!ep)
 	return NULL;
     buf = malloc(ep->size + 1);
@@ -882,6 +1023,29 @@ _match_simple(struct dictdb *db, entry_match_t match, const char *word)
     return (dico_result_t) res;
 }
 
+/* Find the range of index entries beginning with PREFIX.  Store the
+   number of its first entry in *PSTART and that of the entry past its
+   end in *PEND. */
+static void
+prefix_range(struct dictdb *db, const char *prefix,
+	     size_t *pstart, size_t *pend)
+{
+    struct index_entry x, *ep, *end = db->index + db->numwords;
+
+    x.word = (char*) prefix;
+    x.length = strlen(prefix);
+    x.wordlen = utf8_strlen(prefix);
+    ep = index_search(db, &x, 1);
+    if (!ep) {
+	*pstart = *pend = 0;
+	return;
+    }
+    *pstart = ep - db->index;
+    while (ep < end && compare_prefix(&x, ep, db) == 0)
+	ep++;
+    *pend = ep - db->index;
+}
+
 static dico_result_t
 _match_all(struct dictdb *db, dico_strategy_t strat, const char *word)
 {
@@ -889,6 +1053,9 @@ _match_all(struct dictdb *db, dico_strategy_t strat, const char *word)
     size_t count, i;
     struct result *res;
     struct dico_key key;
+    size_t *cand = NULL;
+    size_t start = 0;
+    size_t ncand = db->numwords;
     
     list = dico_list_create();
 
@@ -904,15 +1071,38 @@ _match_all(struct dictdb *db, dico_strategy_t strat, const char *word)
 	dico_log(L_ERR, 0, _("_match_all: key initialization failed"));
 	return NULL;
     }
-    
-    for (i = 0; i < db->numwords; i++) 
-	if (!RESERVED_WORD(db, db->index[i].word)
-	    && dico_key_match(&key, db->index[i].word)) 
-	    dico_list_append(list, &db->index[i]);
 
+    /* For substring searches, verify only the headwords that contain
+       all trigrams of the word.  For strategies with a key derivation
+       function, verify only the headwords sharing a key with it.  If
+       all matching headwords begin with a known prefix, verify only
+       the index range they occupy.  The latter requires the index
+       order to be consistent with prefix comparisons. */
+    if (db->trigram && (strat->flags & DICO_STRAT_SUBSTR))
+	dico_trigram_index_lookup(db->trigram, word, &cand, &ncand);
+    else if (strat->keyfn) {
+	dico_key_index_t kidx = find_key_index(db, strat->keyfn);
+	if (kidx)
+	    dico_key_index_lookup(kidx, word, &cand, &ncand);
+    } else if (key.prefix && db->flag_allchars && !db->flag_casesensitive)
+	prefix_range(db, key.prefix, &start, &ncand);
+    
+    for (i = start; i < ncand; i++) {
+	struct index_entry *ep = &db->index[cand ? cand[i] : i];
+	if (dico_budget_check())
+	    break;
+	if (!RESERVED_WORD(db, ep->word)
+	    && dico_key_match(&key, ep->word)) {
+	    if (dico_result_limit_reached(dico_list_count(list)))
+		break;
+	    dico_list_append(list, ep);
+	}
+    }
+    
     dico_key_deinit(&key);
+    free(cand);
     
-    compare_count = db->numwords;
+    compare_count = i - start;
 	
     count = dico_list_count(list);
     if (count == 0) {
@@ -931,15 +1121,116 @@ _match_all(struct dictdb *db, dico_strategy_t strat, const char *word)
     return (dico_result_t) res;
 }
 
+/* Build the run index.  Reserved entries are never returned by prefix
+   searches, so they don't start runs of their own: skipping N runs then
+   skips N headwords actually shown to the user. */
+static int
+init_run_index(struct dictdb *db)
+{
+    if (!db->runs) {
+	struct index_entry *last = NULL;
+	size_t i, n;
+	
+	db->runs = calloc(db->numwords ? db->numwords : 1,
+			  sizeof(db->runs[0]));
+	if (!db->runs)
+	    return 1;
+	for (i = n = 0; i < db->numwords; i++) {
+	    struct index_entry *ep = &db->index[i];
+	    if (!RESERVED_WORD(db, ep->word)) {
+		if (!last || uniq_comp(last, ep, db))
+		    n++;
+		last = ep;
+	    }
+	    db->runs[i] = n;
+	}
+    }
+    return 0;
+}
+
+/* Paginated prefix search.  Locate the first headword that begins with
+   the prefix, use the run index to skip the requested number of unique
+   headwords, and collect at most the requested number of matches. */
+static dico_result_t
+_match_page(struct dictdb *db, struct dico_prefix_page *pg)
+{
+    struct index_entry x, *ep, *end = db->index + db->numwords;
+    int any = pg->prefix[0] == 0;
+    dico_list_t list;
+    struct result *res;
+    
+    compare_count = 0;
+    if (any)
+	ep = db->index;
+    else {
+	x.word = (char*) pg->prefix;
+	x.length = strlen(pg->prefix);
+	x.wordlen = utf8_strlen(pg->prefix);
+	ep = index_search(db, &x, 1);
+	if (!ep)
+	    return NULL;
+    }
+
+    while (ep < end && RESERVED_WORD(db, ep->word))
+	ep++;
+    
+    if (pg->skip) {
+	if (init_run_index(db)) {
+	    DICO_LOG_MEMERR();
+	    return NULL;
+	}
+	ep = db->index + dico_run_index_seek(db->runs, db->numwords,
+					     ep - db->index, pg->skip);
+    }
+
+    list = dico_list_create();
+    if (!list) {
+	DICO_LOG_MEMERR();
+	return NULL;
+    }
+    dico_list_set_comparator(list, uniq_comp, db);
+    dico_list_set_flags(list, DICO_LIST_COMPARE_TAIL);
+
+    for (; ep < end && (any || compare_prefix(&x, ep, db) == 0); ep++) {
+	if (RESERVED_WORD(db, ep->word))
+	    continue;
+	if (dico_prefix_page_full(pg, dico_list_count(list)))
+	    break;
+	dico_list_append(list, ep);
+    }
+
+    if (dico_list_count(list) == 0) {
+	dico_list_destroy(&list);
+	return NULL;
+    }
+
+    res = malloc(sizeof(*res));
+    if (!res) {
+	DICO_LOG_MEMERR();
+	dico_list_destroy(&list);
+	return NULL;
+    }
+    res->db = db;
+    res->type = result_match;
+    res->list = list;
+    res->itr = NULL;
+    res->compare_count = compare_count;
+    return (dico_result_t) res;
+}
+
 static dico_result_t
 mod_match(dico_handle_t hp, const dico_strategy_t strat, const char *word)
 {
     struct dictdb *db = (struct dictdb *) hp;
     entry_match_t match;
+    struct dico_prefix_page pg;
 
     if (RESERVED_WORD(db, word))
 	return NULL;
 
+    if (dico_prefix_page_parse(strat, word, &pg) == 0)
+	return _match_page(db, &pg);
+    
     match = find_matcher(strat->name);
     if (match)
 	return _match_simple(db, match, word);
@@ -958,7 +1249,7 @@ mod_define(dico_handle_t hp, const char *word)
     if (RESERVED_WORD(db, word))
 	return NULL;
     
-    rc = common_match(db, word, compare_index_entry, 0, &res);
+    rc = common_match(db, word, 0, &res);
     if (rc)
 	return NULL;
     rp = malloc(sizeof(*rp));
@@ -141,6 +141,11 @@ struct dictdb {
     size_t numwords;
     struct index_entry *index;
     struct rev_entry *suf_index;
+    size_t *runs;               /* Run index (for paginated prefix search) */
+    dico_trigram_index_t trigram; /* Trigram index (for substring search) */
+    dico_search_index_t search; /* Search index (for exact and prefix
+				   search) */
+    dico_list_t key_index;      /* Derived key indexes */
     int show_dictorg_entries;
     dico_stream_t stream;
 };
@@ -24,6 +24,8 @@ struct gcide_entity {
     char *text;
 };
 
+/* Entities are looked up using the trie in enttrie.h, which is
+   generated from this table by trie.awk. */
 static struct gcide_entity gcide_entity[] = {
     { "Cced",   "Ç" },
     { "uum",    "ü" },
@@ -253,11 +255,13 @@ static struct gcide_entity gcide_entity[] = {
     { NULL }
 };
 
+#include "enttrie.h"
+
 char const *
 gcide_entity_to_utf8(const char *str)
 {
-    struct gcide_entity *p;
-    size_t len;
+    size_t len, n;
+    int i;
 
     if (str[0] == '<') {
 	str++;
@@ -265,9 +269,8 @@ gcide_entity_to_utf8(const char *str)
     } else
 	len = strlen(str);
 
-    for (p = gcide_entity; p->ent; p++) {
-	if (p->ent[0] == str[0] && strlen(p->ent) == len && memcmp(p->ent, str, len) == 0)
-	    return p->text;
-    }
+    i = gcide_trie_lookup(gcide_entity_trie, str, len, &n);
+    if (i >= 0 && n == len)
+	return gcide_entity[i].text;
     return NULL;
 }
@@ -0,0 +1,631 @@
+/* This file is generated automatically by trie.awk from ent.c.
+   Do not edit. */
+
+static const struct gcide_trie_node gcide_entity_trie[] = {
+    /* char, value, first child, number of children */
+    { 0, -1, 1, 53 },
+    { '?', 38, 54, 0 }, /* ? */
+    { 'A', -1, 54, 7 }, /* A */
+    { 'B', -1, 61, 2 }, /* B */
+    { 'C', -1, 63, 3 }, /* C */
+    { 'D', -1, 66, 3 }, /* D */
+    { 'E', -1, 69, 5 }, /* E */
+    { 'F', -1, 74, 1 }, /* F */
+    { 'G', -1, 75, 2 }, /* G */
+    { 'H', -1, 77, 1 }, /* H */
+    { 'I', -1, 78, 3 }, /* I */
+    { 'J', -1, 81, 1 }, /* J */
+    { 'K', -1, 82, 2 }, /* K */
+    { 'L', -1, 84, 2 }, /* L */
+    { 'M', -1, 86, 2 }, /* M */
+    { 'N', -1, 88, 3 }, /* N */
+    { 'O', -1, 91, 6 }, /* O */
+    { 'P', -1, 97, 3 }, /* P */
+    { 'Q', -1, 100, 1 }, /* Q */
+    { 'R', -1, 101, 2 }, /* R */
+    { 'S', -1, 103, 1 }, /* S */
+    { 'T', -1, 104, 3 }, /* T */
+    { 'U', -1, 107, 5 }, /* U */
+    { 'V', -1, 112, 1 }, /* V */
+    { 'W', -1, 113, 1 }, /* W */
+    { 'X', -1, 114, 1 }, /* X */
+    { 'Y', -1, 115, 1 }, /* Y */
+    { 'Z', -1, 116, 2 }, /* Z */
+    { 'a', -1, 118, 13 }, /* a */
+    { 'b', -1, 131, 4 }, /* b */
+    { 'c', -1, 135, 3 }, /* c */
+    { 'd', -1, 138, 5 }, /* d */
+    { 'e', -1, 143, 10 }, /* e */
+    { 'f', -1, 153, 3 }, /* f */
+    { 'g', -1, 156, 3 }, /* g */
+    { 'h', -1, 159, 2 }, /* h */
+    { 'i', -1, 161, 9 }, /* i */
+    { 'j', -1, 170, 1 }, /* j */
+    { 'k', -1, 171, 2 }, /* k */
+    { 'l', -1, 173, 5 }, /* l */
+    { 'm', -1, 178, 3 }, /* m */
+    { 'n', -1, 181, 5 }, /* n */
+    { 'o', -1, 186, 10 }, /* o */
+    { 'p', -1, 196, 6 }, /* p */
+    { 'q', -1, 202, 1 }, /* q */
+    { 'r', -1, 203, 6 }, /* r */
+    { 's', -1, 209, 4 }, /* s */
+    { 't', -1, 213, 4 }, /* t */
+    { 'u', -1, 217, 10 }, /* u */
+    { 'v', -1, 227, 1 }, /* v */
+    { 'w', -1, 228, 1 }, /* w */
+    { 'x', -1, 229, 1 }, /* x */
+    { 'y', -1, 230, 4 }, /* y */
+    { 'z', -1, 234, 2 }, /* z */
+    { 'D', -1, 236, 1 }, /* AD */
+    { 'E', 19, 237, 0 }, /* AE */
+    { 'I', -1, 237, 1 }, /* AI */
+    { 'L', -1, 238, 1 }, /* AL */
+    { 'r', -1, 239, 1 }, /* Ar */
+    { 't', -1, 240, 1 }, /* At */
+    { 'u', -1, 241, 1 }, /* Au */
+    { 'E', -1, 242, 1 }, /* BE */
+    { 'I', -1, 243, 1 }, /* BI */
+    { 'H', -1, 244, 1 }, /* CH */
+    { 'I', -1, 245, 1 }, /* CI */
+    { 'c', -1, 246, 1 }, /* Cc */
+    { 'E', -1, 247, 1 }, /* DE */
+    { 'I', -1, 248, 1 }, /* DI */
+    { 'a', -1, 249, 1 }, /* Da */
+    { 'I', -1, 250, 1 }, /* EI */
+    { 'P', -1, 251, 1 }, /* EP */
+    { 'T', -1, 252, 1 }, /* ET */
+    { 'a', -1, 253, 1 }, /* Ea */
+    { 't', -1, 254, 1 }, /* Et */
+    { 'I', -1, 255, 1 }, /* FI */
+    { 'A', -1, 256, 1 }, /* GA */
+    { 'I', -1, 257, 1 }, /* GI */
+    { 'I', -1, 258, 1 }, /* HI */
+    { 'I', -1, 259, 1 }, /* II */
+    { 'O', -1, 260, 1 }, /* IO */
+    { 't', -1, 261, 1 }, /* It */
+    { 'I', -1, 262, 1 }, /* JI */
+    { 'A', -1, 263, 1 }, /* KA */
+    { 'I', -1, 264, 1 }, /* KI */
+    { 'A', -1, 265, 1 }, /* LA */
+    { 'I', -1, 266, 1 }, /* LI */
+    { 'I', -1, 267, 1 }, /* MI */
+    { 'U', 126, 268, 0 }, /* MU */
+    { 'O', -1, 268, 1 }, /* NO */
+    { 'U', 127, 269, 0 }, /* NU */
+    { 't', -1, 269, 1 }, /* Nt */
+    { 'E', 54, 270, 0 }, /* OE */
+    { 'I', -1, 270, 1 }, /* OI */
+    { 'M', -1, 271, 2 }, /* OM */
+    { 'a', -1, 273, 1 }, /* Oa */
+    { 't', -1, 274, 1 }, /* Ot */
+    { 'u', -1, 275, 1 }, /* Ou */
+    { 'H', -1, 276, 1 }, /* PH */
+    { 'I', 130, 277, 1 }, /* PI */
+    { 'S', -1, 278, 1 }, /* PS */
+    { 'I', -1, 279, 1 }, /* QI */
+    { 'H', -1, 280, 1 }, /* RH */
+    { 'I', -1, 281, 1 }, /* RI */
+    { 'I', -1, 282, 2 }, /* SI */
+    { 'A', -1, 284, 1 }, /* TA */
+    { 'H', -1, 285, 1 }, /* TH */
+    { 'I', -1, 286, 1 }, /* TI */
+    { 'D', -1, 287, 1 }, /* UD */
+    { 'I', -1, 288, 1 }, /* UI */
+    { 'P', -1, 289, 1 }, /* UP */
+    { 't', -1, 290, 1 }, /* Ut */
+    { 'u', -1, 291, 1 }, /* Uu */
+    { 'I', -1, 292, 1 }, /* VI */
+    { 'I', -1, 293, 1 }, /* WI */
+    { 'I', 128, 294, 1 }, /* XI */
+    { 'I', -1, 295, 1 }, /* YI */
+    { 'E', -1, 296, 1 }, /* ZE */
+    { 'I', -1, 297, 1 }, /* ZI */
+    { 'a', -1, 298, 1 }, /* aa */
+    { 'c', -1, 299, 2 }, /* ac */
+    { 'd', -1, 301, 2 }, /* ad */
+    { 'e', 18, 303, 1 }, /* ae */
+    { 'g', -1, 304, 1 }, /* ag */
+    { 'i', -1, 305, 1 }, /* ai */
+    { 'l', -1, 306, 1 }, /* al */
+    { 'm', -1, 307, 1 }, /* am */
+    { 'n', -1, 308, 1 }, /* an */
+    { 'r', -1, 309, 1 }, /* ar */
+    { 's', -1, 310, 1 }, /* as */
+    { 't', -1, 311, 1 }, /* at */
+    { 'u', -1, 312, 1 }, /* au */
+    { 'e', -1, 313, 1 }, /* be */
+    { 'i', -1, 314, 1 }, /* bi */
+    { 'p', -1, 315, 1 }, /* bp */
+    { 'r', 212, 316, 0 }, /* br */
+    { 'c', -1, 316, 1 }, /* cc */
+    { 'h', -1, 317, 1 }, /* ch */
+    { 'i', -1, 318, 1 }, /* ci */
+    { 'a', -1, 319, 1 }, /* da */
+    { 'd', -1, 320, 1 }, /* dd */
+    { 'e', -1, 321, 2 }, /* de */
+    { 'i', -1, 323, 3 }, /* di */
+    { 's', -1, 326, 1 }, /* ds */
+    { 'a', -1, 327, 1 }, /* ea */
+    { 'c', -1, 328, 2 }, /* ec */
+    { 'd', -1, 330, 1 }, /* ed */
+    { 'g', -1, 331, 1 }, /* eg */
+    { 'i', -1, 332, 1 }, /* ei */
+    { 'm', -1, 333, 1 }, /* em */
+    { 'p', -1, 334, 1 }, /* ep */
+    { 's', -1, 335, 1 }, /* es */
+    { 't', -1, 336, 2 }, /* et */
+    { 'u', -1, 338, 1 }, /* eu */
+    { 'i', -1, 339, 1 }, /* fi */
+    { 'l', -1, 340, 1 }, /* fl */
+    { 'r', -1, 341, 1 }, /* fr */
+    { 'a', -1, 342, 1 }, /* ga */
+    { 'i', -1, 343, 1 }, /* gi */
+    { 't', 207, 344, 0 }, /* gt */
+    { 'a', -1, 344, 1 }, /* ha */
+    { 'i', -1, 345, 1 }, /* hi */
+    { 'a', -1, 346, 1 }, /* ia */
+    { 'c', -1, 347, 2 }, /* ic */
+    { 'g', -1, 349, 1 }, /* ig */
+    { 'i', -1, 350, 1 }, /* ii */
+    { 'm', -1, 351, 1 }, /* im */
+    { 'o', -1, 352, 1 }, /* io */
+    { 's', -1, 353, 1 }, /* is */
+    { 't', -1, 354, 1 }, /* it */
+    { 'u', -1, 355, 1 }, /* iu */
+    { 'i', -1, 356, 1 }, /* ji */
+    { 'a', -1, 357, 1 }, /* ka */
+    { 'i', -1, 358, 1 }, /* ki */
+    { 'a', -1, 359, 2 }, /* la */
+    { 'd', -1, 361, 1 }, /* ld */
+    { 'i', -1, 362, 1 }, /* li */
+    { 's', -1, 363, 1 }, /* ls */
+    { 't', 208, 364, 0 }, /* lt */
+    { 'd', -1, 364, 1 }, /* md */
+    { 'i', -1, 365, 2 }, /* mi */
+    { 'u', 100, 367, 0 }, /* mu */
+    { 'd', -1, 367, 1 }, /* nd */
+    { 'o', -1, 368, 1 }, /* no */
+    { 's', -1, 369, 2 }, /* ns */
+    { 't', -1, 371, 1 }, /* nt */
+    { 'u', 101, 372, 0 }, /* nu */
+    { 'a', -1, 372, 1 }, /* oa */
+    { 'c', -1, 373, 3 }, /* oc */
+    { 'e', 55, 376, 0 }, /* oe */
+    { 'g', -1, 376, 1 }, /* og */
+    { 'i', -1, 377, 1 }, /* oi */
+    { 'm', -1, 378, 3 }, /* om */
+    { 'r', 214, 381, 0 }, /* or */
+    { 's', -1, 381, 1 }, /* os */
+    { 't', -1, 382, 1 }, /* ot */
+    { 'u', -1, 383, 1 }, /* ou */
+    { 'a', -1, 384, 1 }, /* pa */
+    { 'h', -1, 385, 1 }, /* ph */
+    { 'i', 104, 386, 1 }, /* pi */
+    { 'o', -1, 387, 1 }, /* po */
+    { 'r', -1, 388, 1 }, /* pr */
+    { 's', -1, 389, 1 }, /* ps */
+    { 'i', -1, 390, 1 }, /* qi */
+    { 'a', -1, 391, 1 }, /* ra */
+    { 'd', -1, 392, 1 }, /* rd */
+    { 'h', -1, 393, 1 }, /* rh */
+    { 'i', -1, 394, 1 }, /* ri */
+    { 'o', -1, 395, 1 }, /* ro */
+    { 's', -1, 396, 1 }, /* rs */
+    { 'c', -1, 397, 1 }, /* sc */
+    { 'e', -1, 398, 1 }, /* se */
+    { 'h', -1, 399, 1 }, /* sh */
+    { 'i', -1, 400, 2 }, /* si */
+    { 'a', -1, 402, 1 }, /* ta */
+    { 'h', 45, 403, 2 }, /* th */
+    { 'i', -1, 405, 1 }, /* ti */
+    { 's', -1, 406, 1 }, /* ts */
+    { 'a', -1, 407, 1 }, /* ua */
+    { 'c', -1, 408, 2 }, /* uc */
+    { 'd', -1, 410, 1 }, /* ud */
+    { 'g', -1, 411, 1 }, /* ug */
+    { 'i', -1, 412, 1 }, /* ui */
+    { 'm', -1, 413, 1 }, /* um */
+    { 'p', -1, 414, 1 }, /* up */
+    { 's', -1, 415, 1 }, /* us */
+    { 't', -1, 416, 1 }, /* ut */
+    { 'u', -1, 417, 1 }, /* uu */
+    { 'i', -1, 418, 1 }, /* vi */
+    { 'i', -1, 419, 1 }, /* wi */
+    { 'i', 102, 420, 1 }, /* xi */
+    { 'i', -1, 421, 1 }, /* yi */
+    { 'm', -1, 422, 1 }, /* ym */
+    { 'o', -1, 423, 1 }, /* yo */
+    { 'u', -1, 424, 1 }, /* yu */
+    { 'e', -1, 425, 1 }, /* ze */
+    { 'i', -1, 426, 1 }, /* zi */
+    { 'D', 193, 427, 0 }, /* ADD */
+    { 'T', 139, 427, 0 }, /* AIT */
+    { 'P', -1, 427, 1 }, /* ALP */
+    { 'i', -1, 428, 1 }, /* Ari */
+    { 'i', -1, 429, 1 }, /* Ati */
+    { 'm', 15, 430, 0 }, /* Aum */
+    { 'T', -1, 430, 1 }, /* BET */
+    { 'T', 140, 431, 0 }, /* BIT */
+    { 'I', 136, 431, 0 }, /* CHI */
+    { 'T', 141, 431, 0 }, /* CIT */
+    { 'e', -1, 431, 1 }, /* Cce */
+    { 'L', -1, 432, 1 }, /* DEL */
+    { 'T', 142, 433, 0 }, /* DIT */
+    { 'g', -1, 433, 1 }, /* Dag */
+    { 'T', 143, 434, 0 }, /* EIT */
+    { 'S', -1, 434, 1 }, /* EPS */
+    { 'A', 121, 435, 0 }, /* ETA */
+    { 'c', -1, 435, 1 }, /* Eac */
+    { 'i', -1, 436, 1 }, /* Eti */
+    { 'T', 144, 437, 0 }, /* FIT */
+    { 'M', -1, 437, 1 }, /* GAM */
+    { 'T', 145, 438, 0 }, /* GIT */
+    { 'T', 146, 438, 0 }, /* HIT */
+    { 'T', 147, 438, 0 }, /* IIT */
+    { 'T', -1, 438, 1 }, /* IOT */
+    { 'i', -1, 439, 1 }, /* Iti */
+    { 'T', 148, 440, 0 }, /* JIT */
+    { 'P', -1, 440, 1 }, /* KAP */
+    { 'T', 149, 441, 0 }, /* KIT */
+    { 'M', -1, 441, 1 }, /* LAM */
+    { 'T', 150, 442, 0 }, /* LIT */
+    { 'T', 151, 442, 0 }, /* MIT */
+    { 'T', 152, 442, 0 }, /* NOT */
+    { 'i', -1, 442, 1 }, /* Nti */
+    { 'T', 153, 443, 0 }, /* OIT */
+    { 'E', -1, 443, 1 }, /* OME */
+    { 'I', -1, 444, 1 }, /* OMI */
+    { 'c', -1, 445, 1 }, /* Oac */
+    { 'i', -1, 446, 1 }, /* Oti */
+    { 'm', 29, 447, 0 }, /* Oum */
+    { 'I', 135, 447, 0 }, /* PHI */
+    { 'T', 154, 447, 0 }, /* PIT */
+    { 'I', 137, 447, 0 }, /* PSI */
+    { 'T', 155, 447, 0 }, /* QIT */
+    { 'O', 131, 447, 0 }, /* RHO */
+    { 'T', 156, 447, 0 }, /* RIT */
+    { 'G', -1, 447, 1 }, /* SIG */
+    { 'T', 157, 448, 0 }, /* SIT */
+    { 'U', 133, 448, 0 }, /* TAU */
+    { 'E', -1, 448, 1 }, /* THE */
+    { 'T', 158, 449, 0 }, /* TIT */
+    { 'D', 194, 449, 0 }, /* UDD */
+    { 'T', 159, 449, 0 }, /* UIT */
+    { 'S', -1, 449, 1 }, /* UPS */
+    { 'i', -1, 450, 1 }, /* Uti */
+    { 'm', 30, 451, 0 }, /* Uum */
+    { 'T', 160, 451, 0 }, /* VIT */
+    { 'T', 161, 451, 0 }, /* WIT */
+    { 'T', 162, 451, 0 }, /* XIT */
+    { 'T', 163, 451, 0 }, /* YIT */
+    { 'T', -1, 451, 1 }, /* ZET */
+    { 'T', 164, 452, 0 }, /* ZIT */
+    { 'c', -1, 452, 1 }, /* aac */
+    { 'i', -1, 453, 1 }, /* aci */
+    { 'r', 61, 454, 0 }, /* acr */
+    { 'd', 191, 454, 0 }, /* add */
+    { 'o', -1, 454, 1 }, /* ado */
+    { 'm', -1, 455, 1 }, /* aem */
+    { 'r', -1, 456, 1 }, /* agr */
+    { 't', 165, 457, 0 }, /* ait */
+    { 'p', -1, 457, 1 }, /* alp */
+    { 'a', -1, 458, 1 }, /* ama */
+    { 'd', 213, 459, 0 }, /* and */
+    { 'i', -1, 459, 1 }, /* ari */
+    { 'l', 63, 460, 0 }, /* asl */
+    { 'i', -1, 460, 1 }, /* ati */
+    { 'm', 4, 461, 0 }, /* aum */
+    { 't', -1, 461, 1 }, /* bet */
+    { 't', 166, 462, 0 }, /* bit */
+    { 'r', -1, 462, 1 }, /* bpr */
+    { 'e', -1, 463, 1 }, /* cce */
+    { 'i', 111, 464, 0 }, /* chi */
+    { 't', 167, 464, 0 }, /* cit */
+    { 'g', 203, 464, 1 }, /* dag */
+    { 'a', -1, 465, 1 }, /* dda */
+    { 'g', 86, 466, 0 }, /* deg */
+    { 'l', -1, 466, 1 }, /* del */
+    { 'g', -1, 467, 1 }, /* dig */
+    { 't', 168, 468, 0 }, /* dit */
+    { 'v', -1, 468, 1 }, /* div */
+    { 'd', -1, 469, 1 }, /* dsd */
+    { 'c', -1, 470, 1 }, /* eac */
+    { 'i', -1, 471, 1 }, /* eci */
+    { 'r', 51, 472, 0 }, /* ecr */
+    { 'h', 69, 472, 0 }, /* edh */
+    { 'r', -1, 472, 1 }, /* egr */
+    { 't', 169, 473, 0 }, /* eit */
+    { 'a', -1, 473, 1 }, /* ema */
+    { 's', -1, 474, 1 }, /* eps */
+    { 'l', 64, 475, 0 }, /* esl */
+    { 'a', 95, 475, 0 }, /* eta */
+    { 'i', -1, 475, 1 }, /* eti */
+    { 'm', 10, 476, 0 }, /* eum */
+    { 't', 170, 476, 0 }, /* fit */
+    { 'a', -1, 476, 1 }, /* fla */
+    { 'a', -1, 477, 1 }, /* fra */
+    { 'm', -1, 478, 1 }, /* gam */
+    { 't', 171, 479, 0 }, /* git */
+    { 'n', -1, 479, 1 }, /* han */
+    { 't', 172, 480, 0 }, /* hit */
+    { 'c', -1, 480, 1 }, /* iac */
+    { 'i', -1, 481, 1 }, /* ici */
+    { 'r', 52, 482, 0 }, /* icr */
+    { 'r', -1, 482, 1 }, /* igr */
+    { 't', 173, 483, 0 }, /* iit */
+    { 'a', -1, 483, 1 }, /* ima */
+    { 't', -1, 484, 1 }, /* iot */
+    { 'l', 65, 485, 0 }, /* isl */
+    { 'i', -1, 485, 1 }, /* iti */
+    { 'm', 12, 486, 0 }, /* ium */
+    { 't', 174, 486, 0 }, /* jit */
+    { 'p', -1, 486, 1 }, /* kap */
+    { 't', 175, 487, 0 }, /* kit */
+    { 'm', -1, 487, 1 }, /* lam */
+    { 'r', -1, 488, 1 }, /* lar */
+    { 'q', -1, 489, 1 }, /* ldq */
+    { 't', 176, 490, 0 }, /* lit */
+    { 'q', -1, 490, 1 }, /* lsq */
+    { 'a', -1, 491, 1 }, /* mda */
+    { 'd', -1, 492, 1 }, /* mid */
+    { 't', 177, 493, 0 }, /* mit */
+    { 'o', -1, 493, 1 }, /* ndo */
+    { 't', 178, 494, 0 }, /* not */
+    { 'd', -1, 494, 1 }, /* nsd */
+    { 'm', 42, 495, 0 }, /* nsm */
+    { 'i', -1, 495, 1 }, /* nti */
+    { 'c', -1, 496, 1 }, /* oac */
+    { 'a', -1, 497, 1 }, /* oca */
+    { 'i', -1, 498, 1 }, /* oci */
+    { 'r', 53, 499, 0 }, /* ocr */
+    { 'r', -1, 499, 1 }, /* ogr */
+    { 't', 179, 500, 0 }, /* oit */
+    { 'a', -1, 500, 1 }, /* oma */
+    { 'e', -1, 501, 1 }, /* ome */
+    { 'i', -1, 502, 1 }, /* omi */
+    { 'l', 66, 503, 0 }, /* osl */
+    { 'i', -1, 503, 1 }, /* oti */
+    { 'm', 21, 504, 0 }, /* oum */
+    { 'r', -1, 504, 1 }, /* par */
+    { 'i', 110, 505, 0 }, /* phi */
+    { 't', 180, 505, 0 }, /* pit */
+    { 'u', -1, 505, 1 }, /* pou */
+    { 'i', -1, 506, 1 }, /* pri */
+    { 'i', 112, 507, 0 }, /* psi */
+    { 't', 181, 507, 0 }, /* qit */
+    { 'r', -1, 507, 1 }, /* rar */
+    { 'q', -1, 508, 1 }, /* rdq */
+    { 'o', 105, 509, 0 }, /* rho */
+    { 't', 182, 509, 0 }, /* rit */
+    { 'o', -1, 509, 1 }, /* roo */
+    { 'd', -1, 510, 1 }, /* rsd */
+    { 'h', -1, 511, 1 }, /* sch */
+    { 'c', 215, 512, 1 }, /* sec */
+    { 'a', -1, 513, 1 }, /* sha */
+    { 'g', -1, 514, 1 }, /* sig */
+    { 't', 183, 515, 0 }, /* sit */
+    { 'u', 108, 515, 0 }, /* tau */
+    { 'e', -1, 515, 1 }, /* the */
+    { 'o', -1, 516, 1 }, /* tho */
+    { 't', 184, 517, 0 }, /* tit */
+    { 'd', -1, 517, 1 }, /* tsd */
+    { 'c', -1, 518, 1 }, /* uac */
+    { 'i', -1, 519, 1 }, /* uci */
+    { 'r', 60, 520, 0 }, /* ucr */
+    { 'd', 192, 520, 0 }, /* udd */
+    { 'r', -1, 520, 1 }, /* ugr */
+    { 't', 185, 521, 0 }, /* uit */
+    { 'a', -1, 521, 1 }, /* uma */
+    { 's', -1, 522, 1 }, /* ups */
+    { 'l', 67, 523, 0 }, /* usl */
+    { 'i', -1, 523, 1 }, /* uti */
+    { 'm', 1, 524, 0 }, /* uum */
+    { 't', 186, 524, 0 }, /* vit */
+    { 't', 187, 524, 0 }, /* wit */
+    { 't', 188, 524, 0 }, /* xit */
+    { 't', 189, 524, 0 }, /* yit */
+    { 'a', -1, 524, 1 }, /* yma */
+    { 'g', -1, 525, 1 }, /* yog */
+    { 'm', 28, 526, 0 }, /* yum */
+    { 't', -1, 526, 1 }, /* zet */
+    { 't', 190, 527, 0 }, /* zit */
+    { 'H', -1, 527, 1 }, /* ALPH */
+    { 'n', -1, 528, 1 }, /* Arin */
+    { 'l', 77, 529, 0 }, /* Atil */
+    { 'A', 116, 529, 0 }, /* BETA */
+    { 'd', 0, 529, 0 }, /* Cced */
+    { 'T', -1, 529, 1 }, /* DELT */
+    { 'g', -1, 530, 1 }, /* Dagg */
+    { 'I', -1, 531, 1 }, /* EPSI */
+    { 'u', -1, 532, 1 }, /* Eacu */
+    { 'l', 78, 533, 0 }, /* Etil */
+    { 'M', -1, 533, 1 }, /* GAMM */
+    { 'A', 123, 534, 0 }, /* IOTA */
+    { 'l', 79, 534, 0 }, /* Itil */
+    { 'P', -1, 534, 1 }, /* KAPP */
+    { 'B', -1, 535, 1 }, /* LAMB */
+    { 'l', 82, 536, 0 }, /* Ntil */
+    { 'G', -1, 536, 1 }, /* OMEG */
+    { 'C', -1, 537, 1 }, /* OMIC */
+    { 'u', -1, 538, 1 }, /* Oacu */
+    { 'l', 80, 539, 0 }, /* Otil */
+    { 'M', -1, 539, 1 }, /* SIGM */
+    { 'T', -1, 540, 1 }, /* THET */
+    { 'I', -1, 541, 1 }, /* UPSI */
+    { 'l', 81, 542, 0 }, /* Util */
+    { 'A', 120, 542, 0 }, /* ZETA */
+    { 'u', -1, 542, 1 }, /* aacu */
+    { 'r', 3, 543, 0 }, /* acir */
+    { 't', 68, 543, 0 }, /* adot */
+    { 'a', -1, 543, 1 }, /* aema */
+    { 'a', -1, 544, 1 }, /* agra */
+    { 'h', -1, 545, 1 }, /* alph */
+    { 'c', 41, 546, 0 }, /* amac */
+    { 'n', -1, 546, 1 }, /* arin */
+    { 'l', 71, 547, 0 }, /* atil */
+    { 'a', 90, 547, 0 }, /* beta */
+    { 'i', -1, 547, 1 }, /* bpri */
+    { 'd', 8, 548, 1 }, /* cced */
+    { 'g', -1, 549, 1 }, /* dagg */
+    { 'g', 205, 550, 0 }, /* ddag */
+    { 't', -1, 550, 1 }, /* delt */
+    { 'a', -1, 551, 1 }, /* diga */
+    { 'i', -1, 552, 1 }, /* divi */
+    { 'o', -1, 553, 1 }, /* dsdo */
+    { 'u', -1, 554, 1 }, /* eacu */
+    { 'r', 9, 555, 0 }, /* ecir */
+    { 'a', -1, 555, 1 }, /* egra */
+    { 'c', 47, 556, 0 }, /* emac */
+    { 'i', -1, 556, 1 }, /* epsi */
+    { 'l', 72, 557, 0 }, /* etil */
+    { 't', 44, 557, 0 }, /* flat */
+    { 'c', -1, 557, 2 }, /* frac */
+    { 'm', -1, 559, 1 }, /* gamm */
+    { 'd', 39, 560, 0 }, /* hand */
+    { 'u', -1, 560, 1 }, /* iacu */
+    { 'r', 13, 561, 0 }, /* icir */
+    { 'a', -1, 561, 1 }, /* igra */
+    { 'c', 46, 562, 0 }, /* imac */
+    { 'a', 97, 562, 0 }, /* iota */
+    { 'l', 73, 562, 0 }, /* itil */
+    { 'p', -1, 562, 1 }, /* kapp */
+    { 'b', -1, 563, 1 }, /* lamb */
+    { 'r', 210, 564, 0 }, /* larr */
+    { 'u', -1, 564, 1 }, /* ldqu */
+    { 'u', -1, 565, 1 }, /* lsqu */
+    { 's', -1, 566, 1 }, /* mdas */
+    { 'd', -1, 567, 1 }, /* midd */
+    { 't', 83, 568, 0 }, /* ndot */
+    { 'o', -1, 568, 1 }, /* nsdo */
+    { 'l', 76, 569, 0 }, /* ntil */
+    { 'u', -1, 569, 1 }, /* oacu */
+    { 'r', 58, 570, 0 }, /* ocar */
+    { 'r', 20, 570, 0 }, /* ocir */
+    { 'a', -1, 570, 1 }, /* ogra */
+    { 'c', 56, 571, 0 }, /* omac */
+    { 'g', -1, 571, 1 }, /* omeg */
+    { 'c', -1, 572, 1 }, /* omic */
+    { 'l', 74, 573, 0 }, /* otil */
+    { 'a', 206, 573, 0 }, /* para */
+    { 'n', -1, 573, 1 }, /* poun */
+    { 'm', -1, 574, 1 }, /* prim */
+    { 'r', 209, 575, 0 }, /* rarr */
+    { 'u', -1, 575, 1 }, /* rdqu */
+    { 't', 88, 576, 0 }, /* root */
+    { 'o', -1, 576, 1 }, /* rsdo */
+    { 'w', -1, 577, 1 }, /* schw */
+    { 't', 40, 578, 0 }, /* sect */
+    { 'r', -1, 578, 1 }, /* shar */
+    { 'm', -1, 579, 1 }, /* sigm */
+    { 't', -1, 580, 1 }, /* thet */
+    { 'r', -1, 581, 1 }, /* thor */
+    { 'o', -1, 582, 1 }, /* tsdo */
+    { 'u', -1, 583, 1 }, /* uacu */
+    { 'r', 25, 584, 0 }, /* ucir */
+    { 'a', -1, 584, 1 }, /* ugra */
+    { 'c', 57, 585, 0 }, /* umac */
+    { 'i', -1, 585, 1 }, /* upsi */
+    { 'l', 75, 586, 0 }, /* util */
+    { 'c', 62, 586, 0 }, /* ymac */
+    { 'h', 85, 586, 0 }, /* yogh */
+    { 'a', 94, 586, 0 }, /* zeta */
+    { 'A', 115, 586, 0 }, /* ALPHA */
+    { 'g', 16, 586, 0 }, /* Aring */
+    { 'A', 118, 586, 0 }, /* DELTA */
+    { 'e', -1, 586, 1 }, /* Dagge */
+    { 'L', -1, 587, 1 }, /* EPSIL */
+    { 't', -1, 588, 1 }, /* Eacut */
+    { 'A', 117, 589, 0 }, /* GAMMA */
+    { 'A', 124, 589, 0 }, /* KAPPA */
+    { 'D', -1, 589, 1 }, /* LAMBD */
+    { 'A', 138, 590, 0 }, /* OMEGA */
+    { 'R', -1, 590, 1 }, /* OMICR */
+    { 't', -1, 591, 1 }, /* Oacut */
+    { 'A', 132, 592, 0 }, /* SIGMA */
+    { 'A', 122, 592, 0 }, /* THETA */
+    { 'L', -1, 592, 1 }, /* UPSIL */
+    { 't', -1, 593, 1 }, /* aacut */
+    { 'c', 59, 594, 0 }, /* aemac */
+    { 'v', -1, 594, 1 }, /* agrav */
+    { 'a', 89, 595, 0 }, /* alpha */
+    { 'g', 6, 595, 0 }, /* aring */
+    { 'm', -1, 595, 1 }, /* bprim */
+    { 'i', -1, 596, 1 }, /* ccedi */
+    { 'e', -1, 597, 1 }, /* dagge */
+    { 'a', 92, 598, 0 }, /* delta */
+    { 'm', -1, 598, 1 }, /* digam */
+    { 'd', -1, 599, 1 }, /* divid */
+    { 't', 48, 600, 0 }, /* dsdot */
+    { 't', -1, 600, 1 }, /* eacut */
+    { 'v', -1, 601, 1 }, /* egrav */
+    { 'l', -1, 602, 1 }, /* epsil */
+    { '1', -1, 603, 3 }, /* frac1 */
+    { '2', -1, 606, 1 }, /* frac2 */
+    { 'a', 91, 607, 0 }, /* gamma */
+    { 't', -1, 607, 1 }, /* iacut */
+    { 'v', -1, 608, 1 }, /* igrav */
+    { 'a', 98, 609, 0 }, /* kappa */
+    { 'd', -1, 609, 1 }, /* lambd */
+    { 'o', 200, 610, 0 }, /* ldquo */
+    { 'o', 199, 610, 0 }, /* lsquo */
+    { 'h', 197, 610, 0 }, /* mdash */
+    { 'o', -1, 610, 1 }, /* middo */
+    { 't', 49, 611, 0 }, /* nsdot */
+    { 't', -1, 611, 1 }, /* oacut */
+    { 'v', -1, 612, 1 }, /* ograv */
+    { 'a', 113, 613, 0 }, /* omega */
+    { 'r', -1, 613, 1 }, /* omicr */
+    { 'd', 31, 614, 0 }, /* pound */
+    { 'e', 195, 614, 0 }, /* prime */
+    { 'o', 201, 614, 0 }, /* rdquo */
+    { 't', 84, 614, 0 }, /* rsdot */
+    { 'a', 211, 614, 0 }, /* schwa */
+    { 'p', 43, 614, 0 }, /* sharp */
+    { 'a', 106, 614, 1 }, /* sigma */
+    { 'a', 96, 615, 0 }, /* theta */
+    { 'n', 70, 615, 0 }, /* thorn */
+    { 't', 50, 615, 0 }, /* tsdot */
+    { 't', -1, 615, 1 }, /* uacut */
+    { 'v', -1, 616, 1 }, /* ugrav */
+    { 'l', -1, 617, 1 }, /* upsil */
+    { 'r', 204, 618, 0 }, /* Dagger */
+    { 'O', -1, 618, 1 }, /* EPSILO */
+    { 'e', 17, 619, 0 }, /* Eacute */
+    { 'A', 125, 619, 0 }, /* LAMBDA */
+    { 'O', -1, 619, 1 }, /* OMICRO */
+    { 'e', 24, 620, 0 }, /* Oacute */
+    { 'O', -1, 620, 1 }, /* UPSILO */
+    { 'e', 32, 621, 0 }, /* aacute */
+    { 'e', 5, 621, 0 }, /* agrave */
+    { 'e', 196, 621, 0 }, /* bprime */
+    { 'l', 7, 621, 0 }, /* ccedil */
+    { 'r', 202, 621, 0 }, /* dagger */
+    { 'm', -1, 621, 1 }, /* digamm */
+    { 'e', 198, 622, 0 }, /* divide */
+    { 'e', 2, 622, 0 }, /* eacute */
+    { 'e', 11, 622, 0 }, /* egrave */
+    { 'o', -1, 622, 1 }, /* epsilo */
+    { '2', 36, 623, 0 }, /* frac12 */
+    { '3', 35, 623, 0 }, /* frac13 */
+    { '4', 37, 623, 0 }, /* frac14 */
+    { '3', 34, 623, 0 }, /* frac23 */
+    { 'e', 33, 623, 0 }, /* iacute */
+    { 'e', 14, 623, 0 }, /* igrave */
+    { 'a', 99, 623, 0 }, /* lambda */
+    { 't', 87, 623, 0 }, /* middot */
+    { 'e', 23, 623, 0 }, /* oacute */
+    { 'e', 22, 623, 0 }, /* ograve */
+    { 'o', -1, 623, 1 }, /* omicro */
+    { 't', 107, 624, 0 }, /* sigmat */
+    { 'e', 27, 624, 0 }, /* uacute */
+    { 'e', 26, 624, 0 }, /* ugrave */
+    { 'o', -1, 624, 1 }, /* upsilo */
+    { 'N', 119, 625, 0 }, /* EPSILON */
+    { 'N', 129, 625, 0 }, /* OMICRON */
+    { 'N', 134, 625, 0 }, /* UPSILON */
+    { 'a', 114, 625, 0 }, /* digamma */
+    { 'n', 93, 625, 0 }, /* epsilon */
+    { 'n', 103, 625, 0 }, /* omicron */
+    { 'n', 109, 625, 0 }, /* upsilon */
+};
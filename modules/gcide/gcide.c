@@ -16,11 +16,14 @@
 
 #include <config.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <signal.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <sys/wait.h>
+#include <fcntl.h>
 #include <dico.h>
 #include "gcide.h"
 #include <errno.h>
@@ -29,6 +32,25 @@
 #define GCIDE_NOPR     0x01
 #define GCIDE_DBGLEX   0x02
 
+/* Key of a rendered article in the cache */
+struct render_key {
+    unsigned long offset;             /* Offset of the article */
+    int letter;                       /* Dictionary letter */
+    int flags;                        /* Rendering flags */
+};
+
+/* A rendered article */
+struct render_text {
+    size_t len;                       /* Length of the text */
+    char text[1];                     /* Rendered text */
+};
+
+/* A mapped dictionary file */
+struct gcide_file {
+    char *base;
+    size_t size;
+};
+
 struct gcide_db {
     char *db_dir;
     char *idx_dir;
@@ -38,11 +60,19 @@ struct gcide_db {
     int flags;
     time_t latest_change;
     
-    int file_letter;
-    dico_stream_t file_stream;
+    struct gcide_file file[26]; /* Dictionary files, CIDE.A to CIDE.Z */
+
+    dico_cache_t render_cache; /* Cache of rendered articles */
+    char *render_buf;          /* Buffer for rendering articles */
+    size_t render_bufsize;
     
-    size_t idx_cache_size;
+    char *idx_name;            /* Index file name */
     gcide_idx_file_t idx;
+    dev_t idx_dev;             /* Device and inode of the index file */
+    ino_t idx_ino;
+    int idx_reload;            /* Index is being rebuilt in background */
+    pid_t idx_owner;           /* PID of the process that reads its status */
+    int idx_status_fd;         /* Pipe delivering the indexer exit status */
 };
 
 enum result_type {
@@ -64,15 +94,21 @@ static char *idxgcide_program = LIBEXECDIR "/idxgcide";
 static void
 free_db(struct gcide_db *db)
 {
+    int i;
+
     free(db->db_dir);
     free(db->idx_dir);
     free(db->tmpl_name);
     free(db->idxgcide);
-    if (db->file_stream) {
-	dico_stream_close(db->file_stream);
-	dico_stream_destroy(&db->file_stream);
-    }	
+    free(db->idx_name);
+    for (i = 0; i < DICO_ARRAY_SIZE(db->file); i++)
+	if (db->file[i].base)
+	    munmap(db->file[i].base, db->file[i].size);
     gcide_idx_file_close(db->idx);
+    if (db->idx_status_fd != -1)
+	close(db->idx_status_fd);
+    dico_cache_destroy(&db->render_cache);
+    free(db->render_buf);
     free(db);
 }
 
@@ -103,45 +139,90 @@ gcide_template_name(struct gcide_db *db, int let)
     return db->tmpl_name;
 }
 
+/* Check the exit STATUS of idxgcide.  Return 0 if it succeeded. */
+static int
+idxgcide_status(struct gcide_db *db, int status)
+{
+    char *idxgcide = db->idxgcide ? db->idxgcide : idxgcide_program;
+
+    if (!WIFEXITED(status)) {
+	dico_log(L_ERR, 0, _("gcide_open_idx: %s failed"), idxgcide);
+	return 1;
+    }
+    status = WEXITSTATUS(status);
+    if (status) {
+	dico_log(L_ERR, 0,
+		 _("gcide_open_idx: %s exited with status %d"),
+		 idxgcide, status);
+	return 1;
+    }
+    return 0;
+}
+
+/* Start idxgcide to create the index file in background.
+
+   The indexer is run by a monitor process detached from the server, so
+   that it is not reaped by the latter.  The monitor waits for the
+   indexer to terminate and sends its exit status over a pipe, which is
+   read by gcide_reload_idx. */
 static int
-run_idxgcide(char *idxname, struct gcide_db *db)
+run_idxgcide(struct gcide_db *db)
 {
     pid_t pid;
     int status;
+    int p[2];
     char *idxgcide = db->idxgcide ? db->idxgcide : idxgcide_program;
     
-    dico_log(L_NOTICE, 0, _("gcide_open_idx: creating index %s"),
-	     idxname);
+    dico_log(L_NOTICE, 0,
+	     _("gcide_open_idx: creating index %s in background"),
+	     db->idx_name);
     if (access(idxgcide, X_OK)) {
 	dico_log(L_ERR, errno, _("gcide_open_idx: cannot run %s"),
 		 idxgcide);
 	return 1;
     }
+    if (pipe(p)) {
+	dico_log(L_ERR, errno, _("gcide_open_idx: cannot create pipe"));
+	return 1;
+    }
     pid = fork();
     if (pid == 0) {
-	execl(idxgcide, idxgcide, db->db_dir, db->idx_dir, NULL);
+	close(p[0]);
+	pid = fork();
+	if (pid)
+	    _exit(pid == -1);
+	/* Monitor process */
+	pid = fork();
+	if (pid == 0) {
+	    close(p[1]);
+	    execl(idxgcide, idxgcide, db->db_dir, db->idx_dir, NULL);
+	    _exit(127);
+	}
+	if (pid == -1)
+	    status = -1;
+	else
+	    while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+		;
+	write(p[1], &status, sizeof(status));
+	_exit(0);
     }
+    close(p[1]);
     if (pid == -1) {
 	dico_log(L_ERR, errno, _("gcide_open_idx: fork failed"));
+	close(p[0]);
 	return 1;
     }
-    if (waitpid(pid, &status, 0) != pid) {
-	dico_log(L_ERR, errno, _("gcide_open_idx: %s failed"), idxgcide);
-	kill(pid, SIGKILL);
-	return 1;
-    }
-    if (!WIFEXITED(status)) {
-	dico_log(L_ERR, 0, _("gcide_open_idx: %s failed"), idxgcide);
-	return 1;
-    }
-
-    status = WEXITSTATUS(status);
-    if (status) {
-	dico_log(L_ERR, 0,
-		 _("gcide_open_idx: %s exited with status %d"),
-		 idxgcide, status);
+    if (waitpid(pid, &status, 0) != pid
+	|| !WIFEXITED(status) || WEXITSTATUS(status)) {
+	dico_log(L_ERR, 0, _("gcide_open_idx: fork failed"));
+	close(p[0]);
 	return 1;
     }
+    fcntl(p[0], F_SETFD, FD_CLOEXEC);
+    fcntl(p[0], F_SETFL, O_NONBLOCK);
+    db->idx_status_fd = p[0];
+    db->idx_owner = 0;
+    db->idx_reload = 1;
     return 0;
 }
 
@@ -168,6 +249,44 @@ gcide_check_files(struct gcide_db *db)
     db->latest_change = t;
     return 0;
 }
+
+/* Map all dictionary files into memory.  Mapping them in the master
+   process lets all connections share the mappings. */
+static int
+gcide_map_files(struct gcide_db *db)
+{
+    int i;
+
+    for (i = 0; letters[i]; i++) {
+	char *p = gcide_template_name(db, letters[i]);
+	struct gcide_file *file = &db->file[i];
+	struct stat st;
+	int fd;
+
+	fd = open(p, O_RDONLY);
+	if (fd == -1) {
+	    dico_log(L_ERR, errno, _("gcide: cannot open `%s'"), p);
+	    return 1;
+	}
+	if (fstat(fd, &st)) {
+	    dico_log(L_ERR, errno, _("gcide: can't stat `%s'"), p);
+	    close(fd);
+	    return 1;
+	}
+	if (st.st_size > 0) {
+	    file->base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	    if (file->base == MAP_FAILED) {
+		file->base = NULL;
+		dico_log(L_ERR, errno, _("gcide: cannot map `%s'"), p);
+		close(fd);
+		return 1;
+	    }
+	    file->size = st.st_size;
+	}
+	close(fd);
+    }
+    return 0;
+}
 
 /* Try to access IDXNAME.  Return 0 on success, 1 if it should be (re)created
    and -1 on error */
@@ -194,39 +313,115 @@ gcide_access_idx(struct gcide_db *db, char *idxname)
     return rc;
 }
     
+/* Open the index file, replacing the one currently open, if any. */
+static int
+gcide_load_idx(struct gcide_db *db)
+{
+    struct stat st;
+    gcide_idx_file_t idx;
+
+    if (stat(db->idx_name, &st)) {
+	dico_log(L_ERR, errno, _("gcide: can't stat `%s'"), db->idx_name);
+	return 1;
+    }
+    idx = gcide_idx_file_open(db->idx_name);
+    if (!idx)
+	return 1;
+    gcide_idx_file_close(db->idx);
+    db->idx = idx;
+    db->idx_dev = st.st_dev;
+    db->idx_ino = st.st_ino;
+    return 0;
+}
+
+/* Read the exit status of the indexer and load the new index if it
+   succeeded.  If WAIT is set, wait for the indexer to terminate. */
+static void
+gcide_indexer_check(struct gcide_db *db, int wait)
+{
+    int status;
+    ssize_t n;
+
+    if (wait)
+	fcntl(db->idx_status_fd, F_SETFL, 0);
+    while ((n = read(db->idx_status_fd, &status, sizeof(status))) == -1
+	   && errno == EINTR)
+	;
+    if (n == -1 && errno == EAGAIN)
+	return;
+    close(db->idx_status_fd);
+    db->idx_status_fd = -1;
+    db->idx_reload = 0;
+    if (n != sizeof(status))
+	dico_log(L_ERR, 0, _("gcide: index builder terminated unexpectedly"));
+    else if (idxgcide_status(db, status) == 0)
+	gcide_load_idx(db);
+}
+
+/* If the index is being rebuilt, check whether the new one is ready and
+   load it.  This is done in the main process before serving each
+   connection, and on each request, in case the index becomes ready
+   during a session.
+
+   The first process to call this function reads the exit status of the
+   indexer.  In daemon mode this is the main process (which may differ
+   from the one that started the indexer, if dicod detached from the
+   terminal after opening the databases), in inetd mode the only one.
+   It waits for the indexer if WAIT is set and no index is loaded, since
+   there is nothing to serve meanwhile.  Connection subprocesses look
+   for a new index file that is not older than the database instead.
+
+   Return 0 if an index is available. */
+static int
+gcide_reload_idx(struct gcide_db *db, int wait)
+{
+    if (db->idx_reload) {
+	struct stat st;
+	
+	if (db->idx_owner == 0)
+	    db->idx_owner = getpid();
+	if (db->idx_owner == getpid())
+	    gcide_indexer_check(db, wait && !db->idx);
+	else if (stat(db->idx_name, &st) == 0
+		 && (st.st_dev != db->idx_dev || st.st_ino != db->idx_ino)
+		 && db->latest_change <= st.st_mtime
+		 && gcide_load_idx(db) == 0)
+	    db->idx_reload = 0;
+    }
+    return db->idx == NULL;
+}
+
+/* Open the index file.  If it is missing or outdated, start rebuilding
+   it in background.  The outdated index does not match the mapped
+   dictionary files, so the database remains unavailable until the new
+   index is loaded. */
 static int
 gcide_open_idx(struct gcide_db *db)
 {
-    int rc = 1;
-    char *idxname;
+    int rc;
     
-    idxname = dico_full_file_name(db->idx_dir, "GCIDE.IDX");
-    if (!idxname) {
+    db->idx_name = dico_full_file_name(db->idx_dir, "GCIDE.IDX");
+    if (!db->idx_name) {
         DICO_LOG_MEMERR();
 	return 1;
     }
     
-    rc = gcide_access_idx(db, idxname);
+    rc = gcide_access_idx(db, db->idx_name);
     if (rc == 1)
-	rc = run_idxgcide(idxname, db);
-	
-    if (rc == 0) {
-	db->idx = gcide_idx_file_open(idxname, db->idx_cache_size);
-	if (!db->idx)
-	    rc = 1;
-    }
-    
-    free(idxname);
+	rc = run_idxgcide(db);
+    else if (rc == 0)
+	rc = gcide_load_idx(db);
     return rc;
 }
-
+
 static dico_handle_t
 gcide_init_db(const char *dbname, int argc, char **argv)
 {
     char *db_dir = NULL;
     char *idx_dir = NULL;
     char *idxgcide = NULL;
-    long idx_cache_size = 16;
+    long idx_cache_size;
+    long render_cache_size = 512 * 1024;
     int flags = 0;
     struct gcide_db *db;
     
@@ -234,7 +429,9 @@ gcide_init_db(const char *dbname, int argc, char **argv)
 	{ DICO_OPTSTR(dbdir), dico_opt_string, &db_dir },
 	{ DICO_OPTSTR(idxdir), dico_opt_string, &idx_dir },
 	{ DICO_OPTSTR(index-program), dico_opt_string, &idxgcide },
+	/* Obsolete: the index is mapped into memory */
 	{ DICO_OPTSTR(index-cache-size), dico_opt_long, &idx_cache_size },
+	{ DICO_OPTSTR(render-cache-size), dico_opt_long, &render_cache_size },
 	{ DICO_OPTSTR(suppress-pr), dico_opt_bitmask, &flags, 
           .v.value = GCIDE_NOPR },
 	{ DICO_OPTSTR(debug-lex), dico_opt_bitmask, &flags, 
@@ -267,8 +464,16 @@ gcide_init_db(const char *dbname, int argc, char **argv)
     }
     db->db_dir = db_dir;
     db->idx_dir = idx_dir;
-    db->idx_cache_size = idx_cache_size;
+    db->idx_status_fd = -1;
     db->flags = flags;
+    if (render_cache_size > 0) {
+	db->render_cache = dico_cache_create(render_cache_size, free);
+	if (!db->render_cache) {
+	    DICO_LOG_ERRNO();
+	    free_db(db);
+	    return NULL;
+	}
+    }
     
     if (gcide_check_dir(db->db_dir) || gcide_check_dir(db->idx_dir)) {
 	free_db(db);
@@ -277,7 +482,7 @@ gcide_init_db(const char *dbname, int argc, char **argv)
 
     db->tmpl_name = dico_full_file_name(db->db_dir, "CIDE.A");
     db->tmpl_letter = db->tmpl_name + strlen(db->tmpl_name) - 1;
-    if (gcide_check_files(db)) {
+    if (gcide_check_files(db) || gcide_map_files(db)) {
 	free_db(db);
 	return NULL;
     }
@@ -489,6 +694,7 @@ struct match_closure {
     dico_strategy_t strat;
     dico_list_t list;
     struct dico_key key;
+    size_t compare_count;
 };
     
 static int
@@ -496,8 +702,12 @@ match_key(struct gcide_ref *ref, void *data)
 {
     struct match_closure *clos = data;
 
+    if (dico_budget_check())
+	return 1;
+    clos->compare_count++;
     if (dico_key_match(&clos->key, ref->ref_headword)) {
-	if (gcide_result_list_append(clos->list, ref))
+	if (dico_result_limit_reached(dico_list_count(clos->list))
+	    || gcide_result_list_append(clos->list, ref))
 	    return 1;
     }
     return 0;
@@ -521,7 +731,8 @@ gcide_match_all(struct gcide_db *db, const dico_strategy_t strat,
     }
     
     clos.strat = strat;
-    gcide_idx_enumerate(db->idx, match_key, &clos); 
+    clos.compare_count = 0;
+    gcide_idx_enumerate(db->idx, match_key, &clos);
     
     dico_key_deinit(&clos.key);
 
@@ -538,12 +749,53 @@ gcide_match_all(struct gcide_db *db, const dico_strategy_t strat,
 	res->type = result_match;
 	res->db = db;
 	res->list = clos.list;
-	res->compare_count = gcide_idx_defs(db->idx);
+	res->compare_count = clos.compare_count;
     }
     
     return (dico_result_t) res;
 }
 
+/* Paginated prefix search: locate the prefix range, skip the requested
+   number of unique headwords and collect the page. */
+static dico_result_t
+gcide_match_page(struct gcide_db *db, struct dico_prefix_page *pg)
+{
+    gcide_iterator_t itr;
+    struct gcide_result *res;
+    
+    itr = prefix_match(db, pg->prefix);
+    if (!itr)
+	return NULL;
+    if (gcide_iterator_skip(itr, pg->skip)) {
+	gcide_iterator_free(itr);
+	return NULL;
+    }
+
+    res = calloc(1, sizeof(*res));
+    if (!res) {
+	DICO_LOG_ERRNO();
+	gcide_iterator_free(itr);
+	return NULL;
+    }
+    res->type = result_match;
+    res->db = db;
+    res->list = gcide_create_result_list(1);
+    if (!res->list) {
+	free(res);
+	gcide_iterator_free(itr);
+	return NULL;
+    }
+
+    do {
+	if (dico_prefix_page_full(pg, dico_list_count(res->list)))
+	    break;
+	gcide_result_list_append(res->list, gcide_iterator_ref(itr));
+    } while (gcide_iterator_next(itr) == 0);
+    res->compare_count = gcide_iterator_compare_count(itr);
+    gcide_iterator_free(itr);
+    return (dico_result_t) res;
+}
+
 static dico_result_t
 gcide_match(dico_handle_t hp, const dico_strategy_t strat, const char *word)
 {
@@ -551,7 +803,13 @@ gcide_match(dico_handle_t hp, const dico_strategy_t strat, const char *word)
     matcher_t matcher = find_matcher(strat->name);
     gcide_iterator_t itr;
     struct gcide_result *res = NULL;
-    
+    struct dico_prefix_page pg;
+
+    if (gcide_reload_idx(db, 1))
+	return NULL;
+    /* An empty prefix is served by the selector. */
+    if (dico_prefix_page_parse(strat, word, &pg) == 0 && pg.prefix[0])
+	return gcide_match_page(db, &pg);
     if (!matcher)
 	return gcide_match_all(db, strat, word);
     itr = matcher(db, word);
@@ -572,9 +830,11 @@ gcide_match(dico_handle_t hp, const dico_strategy_t strat, const char *word)
 	    return NULL;
 	}
 
-	do
+	do {
+	    if (dico_result_limit_reached(dico_list_count(res->list)))
+		break;
 	    gcide_result_list_append(res->list, gcide_iterator_ref(itr));
-	while (gcide_iterator_next(itr) == 0);
+	} while (gcide_iterator_next(itr) == 0);
 	res->compare_count = gcide_iterator_compare_count(itr);
 	gcide_iterator_free(itr);
     }
@@ -588,6 +848,8 @@ gcide_define(dico_handle_t hp, const char *word)
     gcide_iterator_t itr;
     struct gcide_result *res = NULL;
     
+    if (gcide_reload_idx(db, 1))
+	return NULL;
     itr = exact_match(db, word);
     if (itr) {
 	res = calloc(1, sizeof(*res));
@@ -633,147 +895,179 @@ gcide_result_ref(struct gcide_result *res)
 #define GOF_AS     0x0002000
 
 struct output_closure {
-    dico_stream_t stream;
+    dico_stream_t stream;  /* Output stream or, if NULL, */
+    char *buf;             /* output buffer */
+    size_t len;            /* Length of the buffered text */
+    size_t size;           /* Size of the buffer */
     int flags;
-    int rc;
 };
 
 static int
-print_text(int end, struct gcide_tag *tag, void *data)
+output_write(struct output_closure *clos, char const *text, size_t len)
 {
-    struct output_closure *clos = data;
-    static char *quote[2] = { "“", "”" };
-    static char *ref[2] = { "{" , "}" };
-
-    switch (tag->tag_type) {
-    case gcide_content_unspecified:
-	break;
-    case gcide_content_text:
-	if (clos->flags & GOF_IGNORE)
-	    break;
-	if (clos->flags & GOF_AS) {
-	    char *s = tag->tag_v.text;
-	    
-	    if (strncmp(s, "as", 2) == 0 &&
-		(isspace(s[3]) || ispunct(s[3]))) {
-		
-		dico_stream_write(clos->stream, s, 3);
-		for (s += 3; *s && isspace(*s); s++)
-		    dico_stream_write(clos->stream, s, 1);
-		dico_stream_write(clos->stream, quote[0], strlen(quote[0]));
-		dico_stream_write(clos->stream, s, strlen(s));
-	    } else
-		dico_stream_write(clos->stream, quote[0], strlen(quote[0]));
-	} else
-	    dico_stream_write(clos->stream, tag->tag_v.text,
-			      strlen(tag->tag_v.text));
-	break;
-    case gcide_content_taglist:
-	if (tag->tag_parmc) {
-	    clos->flags &= ~GOF_AS;
-	    if (end) {
-		if (strcmp(tag->tag_name, "pr") == 0 &&
-			 clos->flags & GCIDE_NOPR)
-		    clos->flags &= ~GOF_IGNORE;
-		else if (clos->flags & GOF_IGNORE)
-		    break;
-		else if (strcmp(tag->tag_name, "as") == 0)
-		    dico_stream_write(clos->stream, quote[1], strlen(quote[1]));
-		else if (strcmp(tag->tag_name, "er") == 0)
-		    dico_stream_write(clos->stream, ref[1], strlen(ref[1]));
-	    } else {
-		if (strcmp(tag->tag_name, "pr") == 0 &&
-			 clos->flags & GCIDE_NOPR)
-		    clos->flags |= GOF_IGNORE;
-		else if (clos->flags & GOF_IGNORE)
-		    break;
-		else if (strcmp(tag->tag_name, "sn") == 0)
-		    dico_stream_write(clos->stream, "\n", 1);
-		else if (strcmp(tag->tag_name, "as") == 0)
-		    clos->flags |= GOF_AS;
-		else if (strcmp(tag->tag_name, "er") == 0)
-		    dico_stream_write(clos->stream, ref[0], strlen(ref[0]));
-	    }
-	}
+    if (clos->stream)
+	return dico_stream_write(clos->stream, text, len);
+    if (clos->size - clos->len < len) {
+	size_t nsize = clos->size ? clos->size : 1024;
+	char *p;
+
+	while (nsize - clos->len < len)
+	    nsize *= 2;
+	p = realloc(clos->buf, nsize);
+	if (!p)
+	    return ENOMEM;
+	clos->buf = p;
+	clos->size = nsize;
     }
+    memcpy(clos->buf + clos->len, text, len);
+    clos->len += len;
     return 0;
 }
 
+static char *quote[2] = { "“", "”" };
+static char *ref[2] = { "{" , "}" };
+
+static inline int
+tag_name_is(char const *name, size_t len, char const *str)
+{
+    return strlen(str) == len && memcmp(name, str, len) == 0;
+}
+
+static inline int
+output_str(struct output_closure *clos, char const *str)
+{
+    return output_write(clos, str, strlen(str));
+}
 
 static int
-output_def(dico_stream_t str, struct gcide_db *db, struct gcide_ref *ref)
+output_tag_begin(char const *text, size_t len, size_t namelen, void *data)
 {
-    char *buffer;
-    struct gcide_parse_tree *tree;
-    int rc;
-    
-    if (db->file_letter != ref->ref_letter) {
-	int rc;
-	
-	if (db->file_stream) {
-	    dico_stream_close(db->file_stream);
-	    dico_stream_destroy(&db->file_stream);
-	    db->file_letter = 0;
-	}
+    struct output_closure *clos = data;
 
-	*db->tmpl_letter = ref->ref_letter;
+    clos->flags &= ~GOF_AS;
+    if (tag_name_is(text, namelen, "pr") && clos->flags & GCIDE_NOPR)
+	clos->flags |= GOF_IGNORE;
+    else if (clos->flags & GOF_IGNORE)
+	return 0;
+    else if (tag_name_is(text, namelen, "sn"))
+	return output_write(clos, "\n", 1);
+    else if (tag_name_is(text, namelen, "as"))
+	clos->flags |= GOF_AS;
+    else if (tag_name_is(text, namelen, "er"))
+	return output_str(clos, ref[0]);
+    return 0;
+}
 
-	db->file_stream =
-	    dico_mapfile_stream_create(db->tmpl_name,
-				       DICO_STREAM_READ|DICO_STREAM_SEEK);
-	if (!db->file_stream) {
-	    dico_log(L_ERR, errno, _("cannot create stream `%s'"),
-		     db->tmpl_name);
-	    return 1;
-	}
-	rc = dico_stream_open(db->file_stream);
-	if (rc) {
-	    dico_log(L_ERR, 0,
-		     _("cannot open stream `%s': %s"),
-		     db->tmpl_name, dico_stream_strerror(db->file_stream, rc));
-	    dico_stream_destroy(&db->file_stream);
-	    return 1;
-	}
-	db->file_letter = ref->ref_letter;
-    }
+static int
+output_tag_end(char const *name, size_t len, void *data)
+{
+    struct output_closure *clos = data;
 
-    if (dico_stream_seek(db->file_stream, ref->ref_offset, SEEK_SET) < 0) {
-	dico_log(L_ERR, errno,
-		 _("seek error on `%s' while positioning to %lu: %s"),
-		 db->tmpl_name, ref->ref_offset,
-		 dico_stream_strerror(db->file_stream,
-				      dico_stream_last_error(db->file_stream)));
-	return 1;
+    clos->flags &= ~GOF_AS;
+    if (tag_name_is(name, len, "pr") && clos->flags & GCIDE_NOPR)
+	clos->flags &= ~GOF_IGNORE;
+    else if (clos->flags & GOF_IGNORE)
+	return 0;
+    else if (tag_name_is(name, len, "as"))
+	return output_str(clos, quote[1]);
+    else if (tag_name_is(name, len, "er"))
+	return output_str(clos, ref[1]);
+    return 0;
+}
+
+static int
+output_text(char const *text, size_t len, void *data)
+{
+    struct output_closure *clos = data;
+    char const *s;
+
+    if (clos->flags & GOF_IGNORE)
+	return 0;
+    if (!(clos->flags & GOF_AS))
+	return output_write(clos, text, len);
+    if (len > 3 && strncmp(text, "as", 2) == 0 &&
+	(isspace((unsigned char) text[3]) || ispunct((unsigned char) text[3]))) {
+	for (s = text + 3; *s && isspace((unsigned char) *s); s++)
+	    ;
+	return output_write(clos, text, s - text)
+	       || output_str(clos, quote[0])
+	       || output_write(clos, s, len - (s - text));
     }
+    return output_str(clos, quote[0]);
+}
 
-    buffer = malloc(ref->ref_size);
-    if (!buffer) {
-        DICO_LOG_ERRNO();
+static struct gcide_markup_handler output_handler = {
+    output_tag_begin,
+    output_tag_end,
+    output_text
+};
+
+static int
+output_def(dico_stream_t str, struct gcide_db *db, struct gcide_ref *ref)
+{
+    struct gcide_file *file;
+    char const *text;
+    struct output_closure clos;
+    struct render_key key;
+    struct render_text *rt;
+    int rc;
+
+    if (!(ref->ref_letter >= 'A' && ref->ref_letter <= 'Z')) {
+	dico_log(L_ERR, 0, _("%s: invalid letter in index: %d"),
+		 db->idx_name, ref->ref_letter);
 	return 1;
     }
-    
-    if ((rc = dico_stream_read(db->file_stream, buffer, ref->ref_size, NULL))) {
-	dico_log(L_ERR, 0, _("%s: read error: %s"),
-		 db->tmpl_name,
-		 dico_stream_strerror(db->file_stream, rc));
-	free(buffer);
+    file = &db->file[ref->ref_letter - 'A'];
+    if (ref->ref_offset > file->size
+	|| ref->ref_size > file->size - ref->ref_offset) {
+	dico_log(L_ERR, 0,
+		 _("%s: reference %lu+%lu is out of file; reindex the database"),
+		 gcide_template_name(db, ref->ref_letter),
+		 (unsigned long) ref->ref_offset,
+		 (unsigned long) ref->ref_size);
 	return 1;
     }
-
-    tree = gcide_markup_parse(buffer, ref->ref_size, db->flags & GCIDE_DBGLEX);
-    if (!tree)
-	rc = dico_stream_write(str, buffer, ref->ref_size);
-    else {
-	struct output_closure clos;
+    text = file->base + ref->ref_offset;
+
+    memset(&key, 0, sizeof(key));
+    key.offset = ref->ref_offset;
+    key.letter = ref->ref_letter;
+    key.flags = db->flags & GCIDE_NOPR;
+    rt = dico_cache_lookup(db->render_cache, &key, sizeof(key));
+    if (rt)
+	return dico_stream_write(str, rt->text, rt->len);
+
+    /* Articles that would not fit in the cache are streamed directly.
+       The rendered text is normally shorter than its source, so this
+       also bounds the size of the rendering buffer. */
+    clos.flags = db->flags;
+    if (!dico_cache_fits(db->render_cache, sizeof(*rt) + ref->ref_size)) {
 	clos.stream = str;
-	clos.flags = db->flags;
-	clos.rc = 0;
-	gcide_parse_tree_inorder(tree, print_text, &clos);
-	gcide_parse_tree_free(tree);
-	rc = clos.rc;
-	
+	return gcide_markup_scan(text, ref->ref_size,
+				 db->flags & GCIDE_DBGLEX,
+				 &output_handler, &clos);
+    }
+
+    /* Render the article into the buffer, and cache the result */
+    clos.stream = NULL;
+    clos.buf = db->render_buf;
+    clos.size = db->render_bufsize;
+    clos.len = 0;
+    rc = gcide_markup_scan(text, ref->ref_size, db->flags & GCIDE_DBGLEX,
+			   &output_handler, &clos);
+    db->render_buf = clos.buf;
+    db->render_bufsize = clos.size;
+    if (rc == 0) {
+	rc = dico_stream_write(str, clos.buf, clos.len);
+	rt = malloc(sizeof(*rt) + clos.len);
+	if (rt) {
+	    rt->len = clos.len;
+	    memcpy(rt->text, clos.buf, clos.len);
+	    if (dico_cache_insert(db->render_cache, &key, sizeof(key), rt,
+				  sizeof(*rt) + clos.len))
+		free(rt);
+	}
     }
-    free(buffer);
     return rc;
 }
 
@@ -811,6 +1105,12 @@ gcide_compare_count(dico_result_t rp)
     return res->compare_count;
 }
 
+static void
+gcide_refresh(dico_handle_t hp)
+{
+    gcide_reload_idx((struct gcide_db *) hp, 0);
+}
+
 static void
 gcide_free_result(dico_result_t rp)
 {
@@ -832,5 +1132,6 @@ struct dico_database_module DICO_EXPORT(gcide, module) = {
     .dico_output_result = gcide_output_result,
     .dico_result_count = gcide_result_count,
     .dico_compare_count = gcide_compare_count,
-    .dico_free_result = gcide_free_result
+    .dico_free_result = gcide_free_result,
+    .dico_db_refresh = gcide_refresh
 };
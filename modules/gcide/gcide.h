@@ -15,6 +15,7 @@
    along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
 
 #include "dico.h"
+#include <stdint.h>
 
 /* GCIDE-specific definitions. */
 #define GCIDE_IDX_MAGIC "GCIDEIDX"
@@ -22,6 +23,72 @@
 
 #define GCIDE_IDX_HEADER_PAGESIZE 10240
 
+/* Version 2 index format.
+
+   The file consists of pages of equal size.  All numbers are unsigned
+   32-bit integers in little-endian byte order.  The first page holds
+   the header:
+
+     magic                  GCIDE_IDX2_MAGIC (8 bytes)
+     pagesize               Page size
+     num_pages              Number of pages following the header
+     num_headwords          Total number of references
+     num_defs               Total number of definitions
+     restart                Restart interval
+
+   Each subsequent page holds the references sorted by their keys.  A
+   key is the headword with its case folded by utf8_casefold, so that
+   keys compare with memcmp in the same order as headwords compare with
+   utf8_strcasecmp.  A page consists of:
+
+     nrefs                  Number of references in the page
+     ref[nrefs]             References: offset, size, letter
+     restart[N]             Offsets (from the start of the page) of
+			    the entries of references 0, restart,
+			    2*restart, ..., N = ceil(nrefs / restart)
+     entries                Keys and headwords
+
+   Each entry is front-coded against the previous one, except at
+   restart points.  It consists of the number of leading bytes it
+   shares with the key of the previous entry, the number of remaining
+   bytes and these bytes, followed by the same three items for the
+   headword.  Numbers in entries are stored in the LEB128 format (7 bits
+   per byte, least significant first, high bit set in all bytes but the
+   last). */
+#define GCIDE_IDX2_MAGIC "GCIDEIX2"
+#define GCIDE_IDX2_PAGESIZE 4096
+#define GCIDE_IDX2_RESTART 16
+
+enum {
+    GCIDE_IDX2_HDR_PAGESIZE,
+    GCIDE_IDX2_HDR_NUM_PAGES,
+    GCIDE_IDX2_HDR_NUM_HEADWORDS,
+    GCIDE_IDX2_HDR_NUM_DEFS,
+    GCIDE_IDX2_HDR_RESTART,
+    GCIDE_IDX2_HDR_MAX
+};
+
+#define GCIDE_IDX2_HEADER_SIZE (GCIDE_IDX_MAGIC_LEN + 4 * GCIDE_IDX2_HDR_MAX)
+#define GCIDE_IDX2_REF_SIZE 12
+
+static inline uint32_t
+gcide_get_le32(void const *ptr)
+{
+    unsigned char const *p = ptr;
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8)
+	   | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static inline void
+gcide_put_le32(void *ptr, uint32_t val)
+{
+    unsigned char *p = ptr;
+    p[0] = val;
+    p[1] = val >> 8;
+    p[2] = val >> 16;
+    p[3] = val >> 24;
+}
+
 struct gcide_idx_header {
     char ihdr_magic[GCIDE_IDX_MAGIC_LEN];
     unsigned long ihdr_pagesize;
@@ -57,7 +124,7 @@ struct gcide_idx_page {
 typedef struct gcide_idx_file *gcide_idx_file_t;
 typedef struct gcide_iterator *gcide_iterator_t;
 
-gcide_idx_file_t gcide_idx_file_open(const char *name, size_t cachesize);
+gcide_idx_file_t gcide_idx_file_open(const char *name);
 void gcide_idx_file_close(gcide_idx_file_t file);
 size_t gcide_idx_headwords(struct gcide_idx_file *file);
 size_t gcide_idx_defs(struct gcide_idx_file *file);
@@ -71,12 +138,24 @@ gcide_iterator_t gcide_idx_locate(struct gcide_idx_file *file, char *headword,
 void gcide_iterator_free(gcide_iterator_t itr);
 int gcide_iterator_next(gcide_iterator_t itr);
 int gcide_iterator_rewind(gcide_iterator_t itr);
+int gcide_iterator_skip(gcide_iterator_t itr, size_t skip);
 struct gcide_ref *gcide_iterator_ref(gcide_iterator_t itr);
 size_t gcide_iterator_count(gcide_iterator_t itr);
 size_t gcide_iterator_compare_count(gcide_iterator_t itr);
 void gcide_iterator_store_flags(gcide_iterator_t itr, int flags);
 int gcide_iterator_flags(gcide_iterator_t itr);
 
+/* Trie node.  The tries are generated by trie.awk. */
+struct gcide_trie_node {
+    unsigned char c;        /* Character leading to this node */
+    short value;            /* Value of the node, or -1 */
+    unsigned short child;   /* Index of its first child */
+    unsigned short nchild;  /* Number of children */
+};
+
+int gcide_trie_lookup(struct gcide_trie_node const *trie,
+		      char const *str, size_t len, size_t *plen);
+
 extern char gcide_webchr[256][4];
 char const *gcide_escape_to_utf8(const char *esc);
 char const *gcide_entity_to_utf8(const char *str);
@@ -84,40 +163,22 @@ char const *gcide_entity_to_utf8(const char *str);
 const char *gcide_grk_to_utf8(const char *input, size_t *prd);
 
 
-enum gcide_content_type
-{
-    gcide_content_unspecified,
-    gcide_content_text,
-    gcide_content_taglist
-};
-
-struct gcide_tag {
-    size_t tag_parmc;
-    char **tag_parmv;
-#define tag_name tag_parmv[0]
-    enum gcide_content_type tag_type;
-    struct gcide_tag *tag_next;
-    union {
-	char *text;
-	size_t textpos;
-	dico_list_t taglist;
-    } tag_v;
-};
-
-#define TAG_HAS_NAME(t) ((t) && (t)->tag_parmv && (t)->tag_name)
-
-struct gcide_parse_tree {
-    char *textspace;
-    size_t textsize;
-    struct gcide_tag *root;
+/* Handler functions for gcide_markup_scan.  Each of them returns 0 to
+   continue scanning. */
+struct gcide_markup_handler {
+    /* Beginning of a tag.  TEXT and LEN give the contents of the tag,
+       the first NAMELEN bytes of which are the tag name. */
+    int (*tag_begin)(char const *text, size_t len, size_t namelen,
+		     void *data);
+    /* End of the tag NAME. */
+    int (*tag_end)(char const *name, size_t len, void *data);
+    /* A text segment, with entities and escapes replaced by their
+       UTF-8 representation.  TEXT is nul-terminated. */
+    int (*text)(char const *text, size_t len, void *data);
 };
 
-struct gcide_parse_tree *gcide_markup_parse(char const *text, size_t len,
-					    int dbg);
-void gcide_parse_tree_free(struct gcide_parse_tree *tp);
-int gcide_parse_tree_inorder(struct gcide_parse_tree *tp,
-			     int (*fun)(int, struct gcide_tag *, void *),
-			     void *data);
+int gcide_markup_scan(char const *text, size_t len, int dbg,
+		      struct gcide_markup_handler const *handler, void *data);
 
 
 
@@ -30,6 +30,8 @@ struct xlit {
 	    or vice-versa.  The table below supports both forms.
 */
 
+/* Sequences are looked up using the trie in grktrie.h, which is
+   generated from this table by trie.awk. */
 static struct xlit xlit[] = {
     { "'A", "Ἀ" },
     { "'A,", "ᾈ" },
@@ -335,39 +337,19 @@ static struct xlit xlit[] = {
     { NULL }
 };
 
+#include "grktrie.h"
+
+/* Transliterate the longest sequence at the beginning of INPUT.
+   Store its length in *PRD. */
 const char *
 gcide_grk_to_utf8(const char *input, size_t *prd)
 {
-    struct xlit *p, *found_xlit = NULL;
-    size_t found_len = 0;
+    int i;
 
     if (input[0] == 's' && input[1] == 0) {
 	*prd = 1;
 	return "ς";
     }
-    for (p = xlit; p->seq; p++) {
-	int i;
-
-	for (i = 0; input[i]; i++)
-	    if (input[i] != p->seq[i])
-		break;
-
-	if (p->seq[i]) {
-	    if (found_len && i == 0)
-		break;
-	    continue;
-	}
-
-	if (i > found_len) {
-	    found_len = i;
-	    found_xlit = p;
-	}
-    }
-
-    if (found_len) {
-	*prd = found_len;
-	return found_xlit->grk;
-    }
-
-    return NULL;
+    i = gcide_trie_lookup(xlit_trie, input, SIZE_MAX, prd);
+    return i >= 0 ? xlit[i].grk : NULL;
 }
@@ -0,0 +1,295 @@
+/* This file is generated automatically by trie.awk from grk.c.
+   Do not edit. */
+
+static const struct gcide_trie_node xlit_trie[] = {
+    /* char, value, first child, number of children */
+    { 0, -1, 1, 50 },
+    { '"', -1, 51, 18 }, /* " */
+    { '\'', -1, 69, 16 }, /* ' */
+    { 'A', 78, 85, 3 }, /* A */
+    { 'B', 83, 88, 0 }, /* B */
+    { 'C', -1, 88, 2 }, /* C */
+    { 'D', 86, 90, 0 }, /* D */
+    { 'E', 87, 90, 2 }, /* E */
+    { 'F', 91, 92, 0 }, /* F */
+    { 'G', 92, 92, 0 }, /* G */
+    { 'H', 93, 92, 3 }, /* H */
+    { 'I', 98, 95, 2 }, /* I */
+    { 'K', 102, 97, 0 }, /* K */
+    { 'L', 103, 97, 0 }, /* L */
+    { 'M', 104, 97, 0 }, /* M */
+    { 'N', 105, 97, 0 }, /* N */
+    { 'O', 106, 97, 2 }, /* O */
+    { 'P', 110, 99, 2 }, /* P */
+    { 'Q', 113, 101, 0 }, /* Q */
+    { 'R', 114, 101, 0 }, /* R */
+    { 'S', 115, 101, 0 }, /* S */
+    { 'T', 116, 101, 0 }, /* T */
+    { 'U', 117, 101, 2 }, /* U */
+    { 'W', 121, 103, 3 }, /* W */
+    { 'X', 126, 106, 0 }, /* X */
+    { 'Y', 127, 106, 2 }, /* Y */
+    { 'Z', 131, 108, 0 }, /* Z */
+    { 'a', 221, 108, 4 }, /* a */
+    { 'b', 229, 112, 0 }, /* b */
+    { 'c', -1, 112, 1 }, /* c */
+    { 'd', 231, 113, 0 }, /* d */
+    { 'e', 232, 113, 2 }, /* e */
+    { 'f', 235, 115, 0 }, /* f */
+    { 'g', 236, 115, 0 }, /* g */
+    { 'h', 237, 115, 4 }, /* h */
+    { 'i', 245, 119, 4 }, /* i */
+    { 'k', 256, 123, 0 }, /* k */
+    { 'l', 257, 123, 0 }, /* l */
+    { 'm', 258, 123, 0 }, /* m */
+    { 'n', 259, 123, 0 }, /* n */
+    { 'o', 260, 123, 2 }, /* o */
+    { 'p', 263, 125, 1 }, /* p */
+    { 'q', 265, 126, 0 }, /* q */
+    { 'r', 266, 126, 0 }, /* r */
+    { 's', 267, 126, 0 }, /* s */
+    { 't', 268, 126, 0 }, /* t */
+    { 'u', 269, 126, 4 }, /* u */
+    { 'w', 280, 130, 4 }, /* w */
+    { 'x', 288, 134, 0 }, /* x */
+    { 'y', 289, 134, 4 }, /* y */
+    { 'z', 300, 138, 0 }, /* z */
+    { 'A', 132, 138, 4 }, /* "A */
+    { 'E', 140, 142, 2 }, /* "E */
+    { 'H', 143, 144, 4 }, /* "H */
+    { 'I', 151, 148, 3 }, /* "I */
+    { 'O', 155, 151, 2 }, /* "O */
+    { 'R', 158, 153, 0 }, /* "R */
+    { 'U', 159, 153, 3 }, /* "U */
+    { 'W', 163, 156, 4 }, /* "W */
+    { 'Y', 171, 160, 3 }, /* "Y */
+    { 'a', 175, 163, 4 }, /* "a */
+    { 'e', 185, 167, 2 }, /* "e */
+    { 'h', 188, 169, 4 }, /* "h */
+    { 'i', 197, 173, 3 }, /* "i */
+    { 'o', 201, 176, 2 }, /* "o */
+    { 'r', 204, 178, 0 }, /* "r */
+    { 'u', 205, 178, 3 }, /* "u */
+    { 'w', 209, 181, 4 }, /* "w */
+    { 'y', 217, 185, 3 }, /* "y */
+    { 'A', 0, 188, 4 }, /* 'A */
+    { 'E', 8, 192, 2 }, /* 'E */
+    { 'H', 11, 194, 4 }, /* 'H */
+    { 'I', 19, 198, 3 }, /* 'I */
+    { 'O', 23, 201, 2 }, /* 'O */
+    { 'W', 26, 203, 4 }, /* 'W */
+    { '`', -1, 207, 1 }, /* '` */
+    { 'a', 35, 208, 4 }, /* 'a */
+    { 'e', 43, 212, 2 }, /* 'e */
+    { 'h', 46, 214, 4 }, /* 'h */
+    { 'i', 54, 218, 3 }, /* 'i */
+    { 'o', 58, 221, 2 }, /* 'o */
+    { 'r', 61, 223, 0 }, /* 'r */
+    { 'u', 62, 223, 3 }, /* 'u */
+    { 'w', 66, 226, 4 }, /* 'w */
+    { 'y', 74, 230, 3 }, /* 'y */
+    { ',', 80, 233, 0 }, /* A, */
+    { '`', 81, 233, 0 }, /* A` */
+    { '~', 82, 233, 0 }, /* A~ */
+    { 'H', 84, 233, 0 }, /* CH */
+    { 'h', 85, 233, 0 }, /* Ch */
+    { '`', 89, 233, 0 }, /* E` */
+    { '~', 90, 233, 0 }, /* E~ */
+    { ',', 95, 233, 0 }, /* H, */
+    { '`', 96, 233, 0 }, /* H` */
+    { '~', 97, 233, 0 }, /* H~ */
+    { '`', 100, 233, 0 }, /* I` */
+    { '~', 101, 233, 0 }, /* I~ */
+    { '`', 108, 233, 0 }, /* O` */
+    { '~', 109, 233, 0 }, /* O~ */
+    { 'S', 111, 233, 0 }, /* PS */
+    { 's', 112, 233, 0 }, /* Ps */
+    { '`', 119, 233, 0 }, /* U` */
+    { '~', 120, 233, 0 }, /* U~ */
+    { ',', 123, 233, 0 }, /* W, */
+    { '`', 124, 233, 0 }, /* W` */
+    { '~', 125, 233, 0 }, /* W~ */
+    { '`', 129, 233, 0 }, /* Y` */
+    { '~', 130, 233, 0 }, /* Y~ */
+    { ',', 222, 233, 0 }, /* a, */
+    { '^', 223, 233, 1 }, /* a^ */
+    { '`', 225, 234, 1 }, /* a` */
+    { '~', 227, 235, 1 }, /* a~ */
+    { 'h', 230, 236, 0 }, /* ch */
+    { '`', 233, 236, 0 }, /* e` */
+    { '~', 234, 236, 0 }, /* e~ */
+    { ',', 238, 236, 0 }, /* h, */
+    { '^', 239, 236, 1 }, /* h^ */
+    { '`', 241, 237, 1 }, /* h` */
+    { '~', 243, 238, 1 }, /* h~ */
+    { ':', 246, 239, 3 }, /* i: */
+    { '^', 250, 242, 1 }, /* i^ */
+    { '`', 252, 243, 1 }, /* i` */
+    { '~', 255, 244, 0 }, /* i~ */
+    { '`', 261, 244, 0 }, /* o` */
+    { '~', 262, 244, 0 }, /* o~ */
+    { 's', 264, 244, 0 }, /* ps */
+    { ':', 270, 244, 3 }, /* u: */
+    { '^', 274, 247, 1 }, /* u^ */
+    { '`', 276, 248, 1 }, /* u` */
+    { '~', 278, 249, 1 }, /* u~ */
+    { ',', 281, 250, 0 }, /* w, */
+    { '^', 282, 250, 1 }, /* w^ */
+    { '`', 284, 251, 1 }, /* w` */
+    { '~', 286, 252, 1 }, /* w~ */
+    { ':', 290, 253, 3 }, /* y: */
+    { '^', 294, 256, 1 }, /* y^ */
+    { '`', 296, 257, 1 }, /* y` */
+    { '~', 298, 258, 1 }, /* y~ */
+    { ',', 133, 259, 0 }, /* "A, */
+    { '^', 134, 259, 1 }, /* "A^ */
+    { '`', 136, 260, 1 }, /* "A` */
+    { '~', 138, 261, 1 }, /* "A~ */
+    { '`', 141, 262, 0 }, /* "E` */
+    { '~', 142, 262, 0 }, /* "E~ */
+    { ',', 144, 262, 0 }, /* "H, */
+    { '^', 145, 262, 1 }, /* "H^ */
+    { '`', 147, 263, 1 }, /* "H` */
+    { '~', 149, 264, 1 }, /* "H~ */
+    { '^', 152, 265, 0 }, /* "I^ */
+    { '`', 153, 265, 0 }, /* "I` */
+    { '~', 154, 265, 0 }, /* "I~ */
+    { '`', 156, 265, 0 }, /* "O` */
+    { '~', 157, 265, 0 }, /* "O~ */
+    { '^', 160, 265, 0 }, /* "U^ */
+    { '`', 161, 265, 0 }, /* "U` */
+    { '~', 162, 265, 0 }, /* "U~ */
+    { ',', 164, 265, 0 }, /* "W, */
+    { '^', 165, 265, 1 }, /* "W^ */
+    { '`', 167, 266, 1 }, /* "W` */
+    { '~', 169, 267, 1 }, /* "W~ */
+    { '^', 172, 268, 0 }, /* "Y^ */
+    { '`', 173, 268, 0 }, /* "Y` */
+    { '~', 174, 268, 0 }, /* "Y~ */
+    { ',', 176, 268, 0 }, /* "a, */
+    { '^', 177, 268, 1 }, /* "a^ */
+    { '`', 179, 269, 1 }, /* "a` */
+    { '~', 182, 270, 1 }, /* "a~ */
+    { '`', 186, 271, 0 }, /* "e` */
+    { '~', 187, 271, 0 }, /* "e~ */
+    { ',', 189, 271, 0 }, /* "h, */
+    { '^', 190, 271, 1 }, /* "h^ */
+    { '`', 192, 272, 1 }, /* "h` */
+    { '~', 195, 273, 1 }, /* "h~ */
+    { '^', 198, 274, 0 }, /* "i^ */
+    { '`', 199, 274, 0 }, /* "i` */
+    { '~', 200, 274, 0 }, /* "i~ */
+    { '`', 202, 274, 0 }, /* "o` */
+    { '~', 203, 274, 0 }, /* "o~ */
+    { '^', 206, 274, 0 }, /* "u^ */
+    { '`', 207, 274, 0 }, /* "u` */
+    { '~', 208, 274, 0 }, /* "u~ */
+    { ',', 210, 274, 0 }, /* "w, */
+    { '^', 211, 274, 1 }, /* "w^ */
+    { '`', 214, 275, 1 }, /* "w` */
+    { '~', -1, 276, 1 }, /* "w~ */
+    { '^', 218, 277, 0 }, /* "y^ */
+    { '`', 219, 277, 0 }, /* "y` */
+    { '~', 220, 277, 0 }, /* "y~ */
+    { ',', 1, 277, 0 }, /* 'A, */
+    { '^', 2, 277, 0 }, /* 'A^ */
+    { '`', 3, 277, 0 }, /* 'A` */
+    { '~', 4, 277, 1 }, /* 'A~ */
+    { '`', 9, 278, 0 }, /* 'E` */
+    { '~', 10, 278, 0 }, /* 'E~ */
+    { ',', 12, 278, 0 }, /* 'H, */
+    { '^', 13, 278, 0 }, /* 'H^ */
+    { '`', 14, 278, 0 }, /* 'H` */
+    { '~', 15, 278, 1 }, /* 'H~ */
+    { '^', 20, 279, 0 }, /* 'I^ */
+    { '`', 21, 279, 0 }, /* 'I` */
+    { '~', 22, 279, 0 }, /* 'I~ */
+    { '`', 24, 279, 0 }, /* 'O` */
+    { '~', 25, 279, 0 }, /* 'O~ */
+    { ',', 27, 279, 0 }, /* 'W, */
+    { '^', 28, 279, 0 }, /* 'W^ */
+    { '`', 29, 279, 0 }, /* 'W` */
+    { '~', 30, 279, 1 }, /* 'W~ */
+    { 'O', 34, 280, 0 }, /* '`O */
+    { ',', 36, 280, 0 }, /* 'a, */
+    { '^', 37, 280, 1 }, /* 'a^ */
+    { '`', 39, 281, 1 }, /* 'a` */
+    { '~', 41, 282, 1 }, /* 'a~ */
+    { '`', 44, 283, 0 }, /* 'e` */
+    { '~', 45, 283, 0 }, /* 'e~ */
+    { ',', 47, 283, 0 }, /* 'h, */
+    { '^', 48, 283, 1 }, /* 'h^ */
+    { '`', 50, 284, 1 }, /* 'h` */
+    { '~', 52, 285, 1 }, /* 'h~ */
+    { '^', 55, 286, 0 }, /* 'i^ */
+    { '`', 56, 286, 0 }, /* 'i` */
+    { '~', 57, 286, 0 }, /* 'i~ */
+    { '`', 59, 286, 0 }, /* 'o` */
+    { '~', 60, 286, 0 }, /* 'o~ */
+    { '^', 63, 286, 0 }, /* 'u^ */
+    { '`', 64, 286, 0 }, /* 'u` */
+    { '~', 65, 286, 0 }, /* 'u~ */
+    { ',', 67, 286, 0 }, /* 'w, */
+    { '^', 68, 286, 1 }, /* 'w^ */
+    { '`', 70, 287, 1 }, /* 'w` */
+    { '~', 72, 288, 1 }, /* 'w~ */
+    { '^', 75, 289, 0 }, /* 'y^ */
+    { '`', 76, 289, 0 }, /* 'y` */
+    { '~', 77, 289, 0 }, /* 'y~ */
+    { ',', 224, 289, 0 }, /* a^, */
+    { ',', 226, 289, 0 }, /* a`, */
+    { ',', 228, 289, 0 }, /* a~, */
+    { ',', 240, 289, 0 }, /* h^, */
+    { ',', 242, 289, 0 }, /* h`, */
+    { ',', 244, 289, 0 }, /* h~, */
+    { '^', 247, 289, 0 }, /* i:^ */
+    { '`', 249, 289, 0 }, /* i:` */
+    { '~', 248, 289, 0 }, /* i:~ */
+    { ':', 251, 289, 0 }, /* i^: */
+    { ':', 253, 289, 0 }, /* i`: */
+    { '^', 271, 289, 0 }, /* u:^ */
+    { '`', 272, 289, 0 }, /* u:` */
+    { '~', 273, 289, 0 }, /* u:~ */
+    { ':', 275, 289, 0 }, /* u^: */
+    { ':', 277, 289, 0 }, /* u`: */
+    { ':', 279, 289, 0 }, /* u~: */
+    { ',', 283, 289, 0 }, /* w^, */
+    { ',', 285, 289, 0 }, /* w`, */
+    { ',', 287, 289, 0 }, /* w~, */
+    { '^', 291, 289, 0 }, /* y:^ */
+    { '`', 292, 289, 0 }, /* y:` */
+    { '~', 293, 289, 0 }, /* y:~ */
+    { ':', 295, 289, 0 }, /* y^: */
+    { ':', 297, 289, 0 }, /* y`: */
+    { ':', 299, 289, 0 }, /* y~: */
+    { ',', 135, 289, 0 }, /* "A^, */
+    { ',', 137, 289, 0 }, /* "A`, */
+    { ',', 139, 289, 0 }, /* "A~, */
+    { ',', 146, 289, 0 }, /* "H^, */
+    { ',', 148, 289, 0 }, /* "H`, */
+    { ',', 150, 289, 0 }, /* "H~, */
+    { ',', 166, 289, 0 }, /* "W^, */
+    { ',', 168, 289, 0 }, /* "W`, */
+    { ',', 170, 289, 0 }, /* "W~, */
+    { ',', 178, 289, 0 }, /* "a^, */
+    { ',', 181, 289, 0 }, /* "a`, */
+    { ',', 184, 289, 0 }, /* "a~, */
+    { ',', 191, 289, 0 }, /* "h^, */
+    { ',', 194, 289, 0 }, /* "h`, */
+    { ',', 196, 289, 0 }, /* "h~, */
+    { ',', 213, 289, 0 }, /* "w^, */
+    { ',', 215, 289, 0 }, /* "w`, */
+    { ',', 216, 289, 0 }, /* "w~, */
+    { ',', 5, 289, 0 }, /* 'A~, */
+    { ',', 16, 289, 0 }, /* 'H~, */
+    { ',', 31, 289, 0 }, /* 'W~, */
+    { ',', 38, 289, 0 }, /* 'a^, */
+    { ',', 40, 289, 0 }, /* 'a`, */
+    { ',', 42, 289, 0 }, /* 'a~, */
+    { ',', 49, 289, 0 }, /* 'h^, */
+    { ',', 51, 289, 0 }, /* 'h`, */
+    { ',', 53, 289, 0 }, /* 'h~, */
+    { ',', 69, 289, 0 }, /* 'w^, */
+    { ',', 71, 289, 0 }, /* 'w`, */
+    { ',', 73, 289, 0 }, /* 'w~, */
+};
@@ -16,102 +16,460 @@
 
 #include <config.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <sys/wait.h>
 #include <dico.h>
 #include "gcide.h"
 #include <errno.h>
 #include <appi18n.h>
 
-struct gcide_idx_cache {
-    size_t pageno;
-    unsigned refcount;
-    struct gcide_idx_page *page;
+/* The index file is mapped into memory read-only, so that its pages are
+   shared by all processes using it.  To locate the page a headword
+   belongs to without touching the file, the first and last keys of each
+   page are kept in the fence array.
+
+   Two index formats are supported.  In version 1 files, pages are
+   arrays of struct gcide_ref and headwords are compared using
+   utf8_strcasecmp.  In version 2 files (see gcide.h), references are
+   decoded by a cursor, which is kept in the file structure, so that
+   sequential accesses to a page decode each entry only once.  Their
+   keys are compared with memcmp against the folded search word. */
+
+struct gcide_fence {
+    char *key;                  /* Key (headword, in version 1) */
+    size_t len;                 /* Its length in bytes */
+};
+
+/* Version 2 page cursor */
+struct idx2_cursor {
+    size_t pageno;              /* Page number */
+    size_t refno;               /* Number of the next entry to decode */
+    unsigned char const *next;  /* Pointer to that entry */
+    unsigned char const *end;   /* End of page */
+    char *key;                  /* Key of the last decoded entry */
+    size_t keylen;              /* Its length */
+    char *hw;                   /* Headword of the last decoded entry */
+    size_t hwlen;               /* Its length */
+    int same;                   /* True if the key equals the previous one */
 };
 
 struct gcide_idx_file {
     char *name;
-    int fd;
+    int version;                /* Index format version */
     struct gcide_idx_header header;
-    size_t cache_size;
-    size_t cache_used;
-    struct gcide_idx_cache **cache;
+    size_t restart;             /* Restart interval (version 2) */
+    char *base;                 /* Start of the mapped file */
+    size_t size;                /* Its size */
+    struct gcide_fence *fence;  /* First and last keys of each page */
+    char *fence_text;           /* Storage for fence keys */
     size_t compare_count;
+    size_t *page_runs;          /* Run table (see _idx_build_runs) */
+    struct idx2_cursor cursor;  /* Version 2 page cursor */
+    struct gcide_ref ref;       /* Last reference returned by _idx_ref */
+};
+
+/* Search key */
+struct idx_key {
+    char *word;                 /* Search word */
+    size_t hwlen;               /* Number of characters to compare, 0 for
+				   the whole word */
+    char *fold;                 /* Folded word (version 2) */
+    size_t foldlen;             /* Its length in bytes */
 };
 
 #define REF_NOT_FOUND ((size_t)-1)
 
+#define PAGE_NREFS(page) ((page)->ipg_header.hdr.phdr_numentries)
+#define REF_HEADWORD(page, ref) ((char*)(page) + (ref)->ref_hwoff)
+#define PAGE_HEADWORD(page, n) REF_HEADWORD(page, &(page)->ipg_ref[n])
+
+#define PAGE2_NREFS(page) gcide_get_le32(page)
+#define PAGE2_REF(page, n) ((page) + 4 + (n) * GCIDE_IDX2_REF_SIZE)
+#define PAGE2_RESTART(page, n) \
+    gcide_get_le32(PAGE2_REF(page, PAGE2_NREFS(page)) + 4 * (n))
+
 static void
 _free_index(struct gcide_idx_file *file)
 {
-    size_t i;
     free(file->name);
-    for (i = 0; i < file->cache_used; i++) {
-	free(file->cache[i]->page);
-	free(file->cache[i]);
-    }
-    free(file->cache);
+    if (file->base)
+	munmap(file->base, file->size);
+    free(file->fence);
+    free(file->fence_text);
+    free(file->page_runs);
+    free(file->cursor.key);
+    free(file->cursor.hw);
     free(file);
 }
 
+static inline char *
+_idx_page(struct gcide_idx_file *file, size_t n)
+{
+    return file->base + (n + 1) * file->header.ihdr_pagesize;
+}
+
+static inline size_t
+_idx_nrefs(struct gcide_idx_file *file, size_t n)
+{
+    char *page = _idx_page(file, n);
+    if (file->version == 1)
+	return PAGE_NREFS((struct gcide_idx_page *)page);
+    return PAGE2_NREFS(page);
+}
+
+static void
+_idx_corrupted(struct gcide_idx_file *file)
+{
+    dico_log(L_ERR, 0, _("index file `%s' is corrupted"), file->name);
+}
+
+/* Version 2 decoder */
+
+/* Read a LEB128 number from the cursor. */
 static int
-_idx_full_read(struct gcide_idx_file *file, void *buf, size_t size)
-{
-    char *p = buf;
-    while (size) {
-	ssize_t rc = read(file->fd, p, size);
-	if (rc == -1) {
-	    if (errno == EAGAIN)
-		continue;
-	    dico_log(L_ERR, errno, _("error reading from `%s'"), file->name);
+_idx2_get_num(struct idx2_cursor *cur, size_t *ret)
+{
+    size_t val = 0;
+    int shift = 0;
+    unsigned char c;
+
+    do {
+	if (cur->next == cur->end || shift > 28)
 	    return -1;
-	} else if (rc == 0) {
-	    dico_log(L_ERR, errno, _("short read while reading from `%s'"),
-		     file->name);
+	c = *cur->next++;
+	val |= (size_t) (c & 0x7f) << shift;
+	shift += 7;
+    } while (c & 0x80);
+    *ret = val;
+    return 0;
+}
+
+/* Decode a front-coded string into BUF, which holds the previous
+   string of *PLEN bytes and can hold at most MAX bytes.  If PSAME is
+   not NULL, store in it whether the string remained the same. */
+static int
+_idx2_get_string(struct idx2_cursor *cur, char *buf, size_t *plen,
+		 size_t max, int *psame)
+{
+    size_t shared, n;
+
+    if (_idx2_get_num(cur, &shared)
+	|| _idx2_get_num(cur, &n)
+	|| shared > *plen
+	|| n > max - shared
+	|| n > (size_t) (cur->end - cur->next))
+	return -1;
+    if (psame)
+	*psame = shared + n == *plen
+	         && memcmp(buf + shared, cur->next, n) == 0;
+    memcpy(buf + shared, cur->next, n);
+    cur->next += n;
+    *plen = shared + n;
+    return 0;
+}
+
+/* Decode the next entry. */
+static int
+_idx2_next(struct gcide_idx_file *file)
+{
+    struct idx2_cursor *cur = &file->cursor;
+    size_t max = file->header.ihdr_pagesize;
+
+    if (_idx2_get_string(cur, cur->key, &cur->keylen, max, &cur->same)
+	|| _idx2_get_string(cur, cur->hw, &cur->hwlen, max, NULL))
+	return -1;
+    cur->hw[cur->hwlen] = 0;
+    cur->refno++;
+    return 0;
+}
+
+/* Position the cursor at the start of the restart block N of the
+   page PAGENO. */
+static int
+_idx2_restart(struct gcide_idx_file *file, size_t pageno, size_t n)
+{
+    struct idx2_cursor *cur = &file->cursor;
+    unsigned char const *page = (unsigned char *) _idx_page(file, pageno);
+    size_t off = PAGE2_RESTART(page, n);
+
+    if (off >= file->header.ihdr_pagesize)
+	return -1;
+    cur->pageno = pageno;
+    cur->refno = n * file->restart;
+    cur->next = page + off;
+    cur->end = page + file->header.ihdr_pagesize;
+    cur->keylen = cur->hwlen = 0;
+    return 0;
+}
+
+/* Decode entry REFNO of the page PAGENO.  Unless REFNO is 0, the entry
+   preceding it is decoded as well, so that cursor->same is valid. */
+static int
+_idx2_seek(struct gcide_idx_file *file, size_t pageno, size_t refno)
+{
+    struct idx2_cursor *cur = &file->cursor;
+    size_t start = refno ? (refno - 1) / file->restart * file->restart : 0;
+
+    if (cur->pageno == pageno && cur->refno == refno + 1)
+	return 0;
+    if (!(cur->pageno == pageno && cur->refno > start
+	  && cur->refno <= refno)
+	&& _idx2_restart(file, pageno, start / file->restart)) {
+	_idx_corrupted(file);
+	return -1;
+    }
+    while (cur->refno <= refno) {
+	if (_idx2_next(file)) {
+	    cur->pageno = REF_NOT_FOUND;
+	    _idx_corrupted(file);
 	    return -1;
 	}
-	p += rc;
-	size -= rc;
     }
     return 0;
 }
 
+/* Return the key of reference REFNO in page PAGENO and store its length
+   in *PLEN.  On error, return an empty key. */
+static char const *
+_idx_key(struct gcide_idx_file *file, size_t pageno, size_t refno,
+	 size_t *plen)
+{
+    if (file->version == 1) {
+	struct gcide_idx_page *page =
+	    (struct gcide_idx_page *) _idx_page(file, pageno);
+	*plen = page->ipg_ref[refno].ref_hwbytelen - 1;
+	return PAGE_HEADWORD(page, refno);
+    }
+    if (_idx2_seek(file, pageno, refno)) {
+	*plen = 0;
+	return "";
+    }
+    *plen = file->cursor.keylen;
+    return file->cursor.key;
+}
+
+/* Return true if reference REFNO (> 0) in page PAGENO has the same
+   headword as the reference preceding it. */
 static int
-_open_index(struct gcide_idx_file *file)
+_idx_same(struct gcide_idx_file *file, size_t pageno, size_t refno)
+{
+    if (file->version == 1) {
+	struct gcide_idx_page *page =
+	    (struct gcide_idx_page *) _idx_page(file, pageno);
+	return utf8_strcasecmp(PAGE_HEADWORD(page, refno-1),
+			       PAGE_HEADWORD(page, refno)) == 0;
+    }
+    return _idx2_seek(file, pageno, refno) == 0 && file->cursor.same;
+}
+
+/* Return reference REFNO in page PAGENO.  The returned structure and
+   the headword it points to remain valid until the next access to the
+   index. */
+static struct gcide_ref *
+_idx_ref(struct gcide_idx_file *file, size_t pageno, size_t refno)
+{
+    char *page;
+    struct gcide_ref *ref = &file->ref;
+
+    if (pageno >= file->header.ihdr_num_pages
+	|| refno >= _idx_nrefs(file, pageno)) {
+	dico_log(L_ERR, 0, _("%s: reference %lu:%lu out of range"),
+		 file->name, (unsigned long) pageno, (unsigned long) refno);
+	return NULL;
+    }
+    page = _idx_page(file, pageno);
+    if (file->version == 1) {
+	struct gcide_idx_page *pg = (struct gcide_idx_page *) page;
+	*ref = pg->ipg_ref[refno];
+	ref->ref_headword = REF_HEADWORD(pg, ref);
+    } else {
+	unsigned char const *p = PAGE2_REF((unsigned char *) page, refno);
+
+	if (_idx2_seek(file, pageno, refno))
+	    return NULL;
+	memset(ref, 0, sizeof(*ref));
+	ref->ref_offset = gcide_get_le32(p);
+	ref->ref_size = gcide_get_le32(p + 4);
+	ref->ref_letter = gcide_get_le32(p + 8);
+	ref->ref_headword = file->cursor.hw;
+	ref->ref_hwbytelen = file->cursor.hwlen + 1;
+	ref->ref_hwlen = utf8_strlen(file->cursor.hw);
+    }
+    return ref;
+}
+
+/* Check that version 1 page N is consistent. */
+static int
+_idx_check_page(struct gcide_idx_file *file, size_t n)
+{
+    struct gcide_idx_page *page =
+	(struct gcide_idx_page *) _idx_page(file, n);
+    size_t pagesize = file->header.ihdr_pagesize;
+    size_t i, nrefs = PAGE_NREFS(page);
+
+    if (nrefs == 0
+	|| nrefs > (pagesize - sizeof(page->ipg_header))
+	            / sizeof(page->ipg_ref[0]))
+	return -1;
+    for (i = 0; i < nrefs; i++) {
+	struct gcide_ref *ref = &page->ipg_ref[i];
+	if (ref->ref_hwbytelen == 0
+	    || ref->ref_hwoff >= pagesize
+	    || ref->ref_hwbytelen > pagesize - ref->ref_hwoff
+	    || REF_HEADWORD(page, ref)[ref->ref_hwbytelen - 1])
+	    return -1;
+    }
+    return 0;
+}
+
+/* Check that version 2 page N is consistent: decode all its entries
+   and verify the restart table. */
+static int
+_idx2_check_page(struct gcide_idx_file *file, size_t n)
+{
+    struct idx2_cursor *cur = &file->cursor;
+    unsigned char const *page = (unsigned char *) _idx_page(file, n);
+    size_t pagesize = file->header.ihdr_pagesize;
+    size_t i, nrefs = PAGE2_NREFS(page);
+    size_t nrestarts;
+
+    if (nrefs == 0 || nrefs > pagesize / GCIDE_IDX2_REF_SIZE)
+	return -1;
+    nrestarts = (nrefs + file->restart - 1) / file->restart;
+    if (4 + nrefs * GCIDE_IDX2_REF_SIZE + 4 * nrestarts > pagesize)
+	return -1;
+    if (_idx2_restart(file, n, 0))
+	return -1;
+    for (i = 0; i < nrefs; i++) {
+	if (i % file->restart == 0
+	    && cur->next != page + PAGE2_RESTART(page, i / file->restart))
+	    return -1;
+	if (_idx2_next(file))
+	    return -1;
+    }
+    return 0;
+}
+
+/* Build the fence array. */
+static int
+_idx_build_fence(struct gcide_idx_file *file)
+{
+    size_t n = file->header.ihdr_num_pages;
+    size_t i, len, size = 0;
+    char *p;
+
+    for (i = 0; i < n; i++) {
+	if ((file->version == 1 ? _idx_check_page : _idx2_check_page)
+	        (file, i)) {
+	    file->cursor.pageno = REF_NOT_FOUND;
+	    _idx_corrupted(file);
+	    return -1;
+	}
+	_idx_key(file, i, 0, &len);
+	size += len + 1;
+	_idx_key(file, i, _idx_nrefs(file, i) - 1, &len);
+	size += len + 1;
+    }
+    file->fence = calloc(2 * n + 1, sizeof(file->fence[0]));
+    file->fence_text = malloc(size + 1);
+    if (!file->fence || !file->fence_text) {
+	DICO_LOG_ERRNO();
+	return -1;
+    }
+    p = file->fence_text;
+    for (i = 0; i < 2 * n; i++) {
+	char const *key = _idx_key(file, i / 2,
+				   (i % 2) ? _idx_nrefs(file, i / 2) - 1 : 0,
+				   &len);
+	memcpy(p, key, len);
+	p[len] = 0;
+	file->fence[i].key = p;
+	file->fence[i].len = len;
+	p += len + 1;
+    }
+    return 0;
+}
+
+static int
+_open_index(struct gcide_idx_file *file, int fd)
 {
-    off_t total;
     struct stat st;
-    
-    if (_idx_full_read(file, &file->header, sizeof(file->header)))
+
+    if (fstat(fd, &st)) {
+	dico_log(L_ERR, errno, "fstat `%s'", file->name);
 	return 1;
-    if (memcmp(file->header.ihdr_magic, GCIDE_IDX_MAGIC,
-	       GCIDE_IDX_MAGIC_LEN)) {
+    }
+    if (st.st_size < sizeof(file->header)
+	|| st.st_size < GCIDE_IDX2_HEADER_SIZE) {
 	dico_log(L_ERR, 0, _("file `%s' is not a valid gcide index file"),
 		 file->name);
 	return 1;
     }
-    
-    if (fstat(file->fd, &st)) {
-	dico_log(L_ERR, errno, "fstat `%s'", file->name);
+    file->size = st.st_size;
+    file->base = mmap(NULL, file->size, PROT_READ, MAP_SHARED, fd, 0);
+    if (file->base == MAP_FAILED) {
+	file->base = NULL;
+	dico_log(L_ERR, errno, _("cannot map index file `%s'"), file->name);
 	return 1;
     }
-    
-    total = (file->header.ihdr_num_pages + 1) * file->header.ihdr_pagesize;
-    if (total != st.st_size) {
-	dico_log(L_ERR, 0, _("index file `%s' is corrupted"), file->name);
+
+    if (memcmp(file->base, GCIDE_IDX_MAGIC, GCIDE_IDX_MAGIC_LEN) == 0) {
+	file->version = 1;
+	memcpy(&file->header, file->base, sizeof(file->header));
+	if (file->header.ihdr_pagesize < sizeof(struct gcide_idx_page)) {
+	    _idx_corrupted(file);
+	    return 1;
+	}
+    } else if (memcmp(file->base, GCIDE_IDX2_MAGIC,
+		      GCIDE_IDX_MAGIC_LEN) == 0) {
+	char const *p = file->base + GCIDE_IDX_MAGIC_LEN;
+
+	file->version = 2;
+	file->header.ihdr_pagesize =
+	    gcide_get_le32(p + 4 * GCIDE_IDX2_HDR_PAGESIZE);
+	file->header.ihdr_num_pages =
+	    gcide_get_le32(p + 4 * GCIDE_IDX2_HDR_NUM_PAGES);
+	file->header.ihdr_num_headwords =
+	    gcide_get_le32(p + 4 * GCIDE_IDX2_HDR_NUM_HEADWORDS);
+	file->header.ihdr_num_defs =
+	    gcide_get_le32(p + 4 * GCIDE_IDX2_HDR_NUM_DEFS);
+	file->restart = gcide_get_le32(p + 4 * GCIDE_IDX2_HDR_RESTART);
+	if (file->header.ihdr_pagesize < GCIDE_IDX2_HEADER_SIZE
+	    || file->restart == 0) {
+	    _idx_corrupted(file);
+	    return 1;
+	}
+	file->cursor.key = malloc(file->header.ihdr_pagesize);
+	file->cursor.hw = malloc(file->header.ihdr_pagesize + 1);
+	if (!file->cursor.key || !file->cursor.hw) {
+	    DICO_LOG_ERRNO();
+	    return 1;
+	}
+    } else {
+	dico_log(L_ERR, 0, _("file `%s' is not a valid gcide index file"),
+		 file->name);
 	return 1;
     }
-    return 0;
+    file->cursor.pageno = REF_NOT_FOUND;
+
+    if ((file->header.ihdr_num_pages + 1) * file->header.ihdr_pagesize
+	  != file->size) {
+	_idx_corrupted(file);
+	return 1;
+    }
+    return _idx_build_fence(file);
 }
 
 struct gcide_idx_file *
-gcide_idx_file_open(const char *name, size_t cachesize)
+gcide_idx_file_open(const char *name)
 {
-    int fd;
+    int fd, rc;
     struct gcide_idx_file *file;
-    
+
     file = calloc(1, sizeof(*file));
     if (!file) {
         DICO_LOG_ERRNO();
@@ -126,24 +484,23 @@ gcide_idx_file_open(const char *name, size_t cachesize)
     fd = open(name, O_RDONLY);
     if (fd == -1) {
 	dico_log(L_ERR, errno, _("cannot open index file `%s'"), name);
-	free(file);
+	_free_index(file);
+	return NULL;
     }
-    file->fd = fd;
-    if (_open_index(file)) {
+    rc = _open_index(file, fd);
+    close(fd);
+    if (rc) {
 	_free_index(file);
 	return NULL;
     }
-    file->cache_size = cachesize;
     return file;
 }
 
 void
 gcide_idx_file_close(struct gcide_idx_file *file)
 {
-    if (file) {
-	close(file->fd);
+    if (file)
 	_free_index(file);
-    }
 }
 
 size_t
@@ -158,154 +515,132 @@ gcide_idx_defs(struct gcide_idx_file *file)
     return file->header.ihdr_num_defs;
 }
 
-static struct gcide_idx_cache *
-_cache_alloc(struct gcide_idx_file *file)
+int
+gcide_idx_enumerate(struct gcide_idx_file *file,
+		    int (*fun)(struct gcide_ref *, void *),
+		    void *data)
 {
-    struct gcide_idx_cache *cp;
-    
-    if (!file->cache) {
-	file->cache = calloc(file->cache_size, sizeof(file->cache[0]));
-	if (!file->cache) {
-            DICO_LOG_ERRNO();
-	    return NULL;
+    size_t i, j, nrefs;
+
+    for (i = 0; i < file->header.ihdr_num_pages; i++) {
+	nrefs = _idx_nrefs(file, i);
+	for (j = 0; j < nrefs; j++) {
+	    struct gcide_ref *ref = _idx_ref(file, i, j);
+	    if (!ref)
+		return 1;
+	    if (fun(ref, data))
+		return 1;
 	}
     }
-    if (file->cache_used < file->cache_size) {
-	if (file->cache_used &&
-	    file->cache[file->cache_used - 1]->refcount == 0)
-	    return file->cache[file->cache_used - 1];
-	cp = calloc(1, sizeof(*cp));
-	if (!cp) {
-            DICO_LOG_ERRNO();
-	    return NULL;
-	}
-	cp->page = malloc(file->header.ihdr_pagesize);
-	if (!cp->page) {
-            DICO_LOG_ERRNO();
-	    free(cp);
-	    return NULL;
+    return 0;
+}
+
+/* Initialize the search key for HEADWORD.  If HWLEN is not 0, only its
+   first HWLEN characters are used. */
+static int
+_key_init(struct gcide_idx_file *file, struct idx_key *key,
+	  char const *headword, size_t hwlen)
+{
+    size_t len;
+
+    key->hwlen = 0;
+    if (hwlen) {
+	for (len = 0; headword[len] && hwlen; hwlen--, key->hwlen++) {
+	    size_t n = utf8_char_width(headword + len);
+	    if (n == 0)
+		break;
+	    len += n;
 	}
-	file->cache[file->cache_used++] = cp;
     } else
-	cp = file->cache[file->cache_used - 1];
-    cp->pageno = 0;
-    cp->refcount = 0;
-    return cp;
+	len = strlen(headword);
+    key->word = malloc(len + 1);
+    if (!key->word)
+	return -1;
+    memcpy(key->word, headword, len);
+    key->word[len] = 0;
+    key->fold = NULL;
+    key->foldlen = 0;
+    if (file->version == 2) {
+	if (utf8_casefold(key->word, &key->fold)) {
+	    free(key->word);
+	    return -1;
+	}
+	key->foldlen = strlen(key->fold);
+    }
+    return 0;
 }
 
 static void
-_cache_promote(struct gcide_idx_file *file, int n)
+_key_free(struct idx_key *key)
 {
-    int i;
-    unsigned refcount = ++file->cache[n]->refcount;
-
-    if (n == 0)
-	return;
-    for (i = n - 1; i >= 0; i--)
-	if (file->cache[i]->refcount >= refcount)
-	    break;
-    i++;
-    if (i != n) {
-	struct gcide_idx_cache *tmp = file->cache[n];
-	file->cache[n] = file->cache[i];
-	file->cache[i] = tmp;
-    }
+    free(key->word);
+    free(key->fold);
 }
 
-static struct gcide_idx_cache *
-_cache_find_page(struct gcide_idx_file *file, size_t n)
+/* Compare KEY with the index key REFKEY of length REFLEN.  If KEY is a
+   prefix, index keys beginning with it compare equal. */
+static int
+_compare(struct gcide_idx_file *file, struct idx_key const *key,
+	 char const *refkey, size_t reflen)
 {
-    size_t i;
-    
-    for (i = 0; i < file->cache_used; i++) {
-	if (file->cache[i]->pageno == n) {
-	    struct gcide_idx_cache *cp = file->cache[i];
-	    _cache_promote(file, n);
-	    return cp;
-	}
-    }
-    
-    return NULL;
-}
-
-struct gcide_idx_page *
-_idx_get_page(struct gcide_idx_file *file, size_t n)
-{
-    off_t off;
-    struct gcide_idx_cache *cp;
-    struct gcide_idx_page *page;
-    size_t i;
-    
-    cp = _cache_find_page(file, n);
-    if (cp)
-	return cp->page;
-    
-    off = (n + 1) * file->header.ihdr_pagesize;
-    if (lseek(file->fd, off, SEEK_SET) != off) {
-	dico_log(L_ERR, errno,
-		 _("seek error on `%s' while positioning to %lu"),
-		 file->name, (unsigned long) off);
-	return NULL;
+    int rc;
+
+    file->compare_count++;
+    if (file->version == 1) {
+	if (key->hwlen)
+	    return utf8_strncasecmp(key->word, refkey, key->hwlen);
+	return utf8_strcasecmp(key->word, refkey);
     }
-    cp = _cache_alloc(file);
-    if (!cp)
-	return NULL;
-    if (_idx_full_read(file, cp->page, file->header.ihdr_pagesize))
-	return NULL;
-    cp->refcount++;
-    page = cp->page;
-    for (i = 0; i < page->ipg_header.hdr.phdr_numentries; i++)
-	page->ipg_ref[i].ref_headword =
-	    (char*)page + page->ipg_ref[i].ref_hwoff;
-    return page;
+    rc = memcmp(key->fold, refkey,
+		key->foldlen < reflen ? key->foldlen : reflen);
+    if (rc)
+	return rc;
+    if (key->foldlen > reflen)
+	return 1;
+    if (key->foldlen == reflen || key->hwlen)
+	return 0;
+    return -1;
 }
 
-
-int
-gcide_idx_enumerate(struct gcide_idx_file *file,
-		    int (*fun)(struct gcide_ref *, void *),
-		    void *data)
+static int
+_compare_ref(struct gcide_idx_file *file, struct idx_key const *key,
+	     size_t pageno, size_t refno)
 {
-    size_t i;
-
-    for (i = 0; i < file->header.ihdr_num_pages; i++) {
-	int j;
+    size_t len;
+    char const *refkey = _idx_key(file, pageno, refno, &len);
+    return _compare(file, key, refkey, len);
+}
 
-	struct gcide_idx_page *page = _idx_get_page(file, i);
-	if (!page)
-	    return -1;
-	for (j = 0; j < page->ipg_header.hdr.phdr_numentries; j++)
-	    if (fun(&page->ipg_ref[j], data))
-		break;
-    }
-    return 0;
+static int
+_compare_fence(struct gcide_idx_file *file, struct idx_key const *key,
+	       size_t n)
+{
+    return _compare(file, key, file->fence[n].key, file->fence[n].len);
 }
 
+/* Return true if fence keys A and B are equal. */
 static int
-_compare(struct gcide_idx_file *file, char *hw, struct gcide_ref *ref,
-	 size_t hwlen)
+_fence_equal(struct gcide_idx_file *file, size_t a, size_t b)
 {
-    file->compare_count++;
-    if (hwlen) {
-	if (hwlen > ref->ref_hwlen)
-	    hwlen = ref->ref_hwlen;
-	return utf8_strncasecmp(hw, ref->ref_headword, hwlen);
-    }
-    return utf8_strcasecmp(hw, ref->ref_headword);
+    if (file->version == 1)
+	return utf8_strcasecmp(file->fence[a].key, file->fence[b].key) == 0;
+    return file->fence[a].len == file->fence[b].len
+	   && memcmp(file->fence[a].key, file->fence[b].key,
+		     file->fence[a].len) == 0;
 }
 
 static size_t
-_idx_ref_locate(struct gcide_idx_file *file,
-		struct gcide_idx_page *page, char *headword, size_t hwlen)
+_idx_ref_locate(struct gcide_idx_file *file, size_t pageno,
+		struct idx_key const *key)
 {
     size_t l, u, idx;
     int res;
-    
+
     l = 0;
-    u = page->ipg_header.hdr.phdr_numentries;
+    u = _idx_nrefs(file, pageno);
     while (l < u) {
 	idx = (l + u) / 2;
-	res = _compare(file, headword, &page->ipg_ref[idx], hwlen);
+	res = _compare_ref(file, key, pageno, idx);
 	if (res < 0)
 	    u = idx;
 	else if (res > 0)
@@ -317,30 +652,22 @@ _idx_ref_locate(struct gcide_idx_file *file,
 }
 
 static size_t
-_idx_page_locate(struct gcide_idx_file *file, char *headword, size_t hwlen)
+_idx_page_locate(struct gcide_idx_file *file, struct idx_key const *key)
 {
     size_t l, u, idx;
     int res;
-    
+
     l = 0;
     u = file->header.ihdr_num_pages;
     while (l < u) {
-	struct gcide_idx_page *page;
-	    
 	idx = (l + u) / 2;
-	page = _idx_get_page(file, idx);
-	if (!page)
-	    return REF_NOT_FOUND;
-
-	res = _compare(file, headword, &page->ipg_ref[0], hwlen);
+	res = _compare_fence(file, key, 2 * idx);
 	if (res < 0)
 	    u = idx;
 	else if (res == 0)
 	    return idx;
 	else {
-	    res = _compare(file, headword,
-			   &page->ipg_ref[page->ipg_header.hdr.phdr_numentries-1],
-			   hwlen);
+	    res = _compare_fence(file, key, 2 * idx + 1);
 	    if (res > 0)
 		l = idx + 1;
 	    else
@@ -349,11 +676,10 @@ _idx_page_locate(struct gcide_idx_file *file, char *headword, size_t hwlen)
     }
     return REF_NOT_FOUND;
 }
-
+
 struct gcide_iterator {
     struct gcide_idx_file *file; /* Index file */
-    char *headword;              /* Headword this iterator tracks */
-    size_t hwlen;                /* Length of the headword */
+    struct idx_key key;          /* Headword this iterator tracks */
     size_t start_pageno;         /* Number of start page */
     size_t start_refno;          /* Number of start reference in page */
     size_t cur_pageno;           /* Number of current page */
@@ -365,77 +691,65 @@ struct gcide_iterator {
 				    if not yet determined. */
     size_t curref;               /* Position in iterator */
 
-    char *prevbuf;               /* Previous match */ 
+    char *prevbuf;               /* Previous match */
     size_t prevsize;
-    
+
     int flags;                   /* User-defined flags. */
+    struct gcide_ref ref;        /* Current reference */
+    char *hwbuf;                 /* Its headword (version 2) */
 };
-    
+
 gcide_iterator_t
 gcide_idx_locate(struct gcide_idx_file *file, char *headword, size_t hwlen)
 {
     size_t pageno, refno;
-    struct gcide_idx_page *page;
     struct gcide_iterator *itr;
+    struct idx_key key;
 
-    file->compare_count = 0;
-    pageno = _idx_page_locate(file, headword, hwlen);
-    if (pageno == REF_NOT_FOUND)
-	return NULL;
-    page = _idx_get_page(file, pageno);
-    if (!page)
+    if (_key_init(file, &key, headword, hwlen)) {
+        DICO_LOG_ERRNO();
 	return NULL;
-    refno = _idx_ref_locate(file, page, headword, hwlen);
-    if (refno == REF_NOT_FOUND)
+    }
+
+    file->compare_count = 0;
+    pageno = _idx_page_locate(file, &key);
+    if (pageno == REF_NOT_FOUND
+	|| (refno = _idx_ref_locate(file, pageno, &key)) == REF_NOT_FOUND) {
+	_key_free(&key);
 	return NULL;
+    }
 
     for (;;) {
 	if (refno > 0) {
-	    if (_compare(file, headword, &page->ipg_ref[refno-1], hwlen) > 0)
+	    if (_compare_ref(file, &key, pageno, refno-1) > 0)
 		break;
 	    --refno;
 	}
 	if (refno == 0) {
 	    if (pageno == 0)
 		break;
-	    page = _idx_get_page(file, --pageno);
-	    if (!page)
-		return NULL;
-	    refno = page->ipg_header.hdr.phdr_numentries;
+	    refno = _idx_nrefs(file, --pageno);
 	}
     }
-    if (refno == page->ipg_header.hdr.phdr_numentries) {
+    if (refno == _idx_nrefs(file, pageno)) {
 	pageno++;
 	refno = 0;
     }
-    
-    itr = malloc(sizeof(*itr));
-    if (!itr) {
-        DICO_LOG_ERRNO();
-	return NULL;
-    }
-    if (hwlen) {
-	itr->headword = malloc(hwlen);
-	if (itr->headword)
-	    memcpy(itr->headword, headword, hwlen);
-    } else
-	itr->headword = strdup(headword);
 
-    if (!itr->headword) {
+    itr = calloc(1, sizeof(*itr));
+    if (!itr) {
         DICO_LOG_ERRNO();
-	free(itr);
+	_key_free(&key);
 	return NULL;
     }
-
-    itr->hwlen = hwlen;
-    
+    itr->key = key;
     itr->file = file;
-    itr->start_pageno = itr->cur_pageno = pageno;    
+    itr->start_pageno = itr->cur_pageno = pageno;
     itr->start_refno = itr->cur_refno = refno;
-    itr->page_numrefs = page->ipg_header.hdr.phdr_numentries;
+    itr->page_numrefs = _idx_nrefs(file, pageno);
     itr->curref = itr->numrefs = 0;
     itr->compare_count = file->compare_count;
-    
+
     return itr;
 }
 
@@ -443,7 +757,8 @@ void
 gcide_iterator_free(gcide_iterator_t itr)
 {
     if (itr) {
-	free(itr->headword);
+	_key_free(&itr->key);
+	free(itr->hwbuf);
 	free(itr);
     }
 }
@@ -451,7 +766,6 @@ gcide_iterator_free(gcide_iterator_t itr)
 int
 gcide_iterator_next(gcide_iterator_t itr)
 {
-    struct gcide_idx_page *page;
     size_t pageno, refno;
 
     if (!itr)
@@ -463,7 +777,7 @@ gcide_iterator_next(gcide_iterator_t itr)
     if (itr->cur_refno < itr->page_numrefs-1) {
 	pageno = itr->cur_pageno;
 	refno = itr->cur_refno + 1;
-    } else if (itr->cur_pageno == itr->file->header.ihdr_num_pages) {
+    } else if (itr->cur_pageno + 1 >= itr->file->header.ihdr_num_pages) {
 	if (!itr->numrefs)
 	    itr->numrefs = itr->curref + 1;
 	return -1;
@@ -472,17 +786,13 @@ gcide_iterator_next(gcide_iterator_t itr)
 	refno = 0;
     }
 
-    page = _idx_get_page(itr->file, pageno);
-    if (!page)
-	return -1;
     if (!itr->numrefs &&
-	_compare(itr->file, itr->headword, &page->ipg_ref[refno],
-		 itr->hwlen)) {
+	_compare_ref(itr->file, &itr->key, pageno, refno)) {
 	if (!itr->numrefs)
 	    itr->numrefs = itr->curref + 1;
 	return -1;
     }
-    itr->page_numrefs = page->ipg_header.hdr.phdr_numentries;
+    itr->page_numrefs = _idx_nrefs(itr->file, pageno);
     itr->cur_pageno = pageno;
     itr->cur_refno = refno;
     itr->curref++;
@@ -492,31 +802,39 @@ gcide_iterator_next(gcide_iterator_t itr)
 int
 gcide_iterator_rewind(gcide_iterator_t itr)
 {
-    struct gcide_idx_page *page;
-
     if (!itr)
 	return -1;
-    itr->cur_pageno = itr->start_pageno;    
+    itr->cur_pageno = itr->start_pageno;
     itr->cur_refno = itr->start_refno;
     itr->curref = 0;
-    page = _idx_get_page(itr->file, itr->cur_pageno);
-    if (!page)
-	return -1;
-    itr->page_numrefs = page->ipg_header.hdr.phdr_numentries;
+    itr->page_numrefs = _idx_nrefs(itr->file, itr->cur_pageno);
     return 0;
 }
 
 struct gcide_ref *
 gcide_iterator_ref(gcide_iterator_t itr)
 {
-    struct gcide_idx_page *page;
-    
+    struct gcide_ref *ref;
+
     if (!itr)
 	return NULL;
-    page = _idx_get_page(itr->file, itr->cur_pageno);
-    if (!page)
+    ref = _idx_ref(itr->file, itr->cur_pageno, itr->cur_refno);
+    if (!ref)
 	return NULL;
-    return &page->ipg_ref[itr->cur_refno];
+    itr->ref = *ref;
+    if (itr->file->version == 2) {
+	/* Keep the headword past the next access to the index */
+	if (!itr->hwbuf) {
+	    itr->hwbuf = malloc(itr->file->header.ihdr_pagesize + 1);
+	    if (!itr->hwbuf) {
+		DICO_LOG_ERRNO();
+		return NULL;
+	    }
+	}
+	memcpy(itr->hwbuf, ref->ref_headword, ref->ref_hwbytelen);
+	itr->ref.ref_headword = itr->hwbuf;
+    }
+    return &itr->ref;
 }
 
 size_t
@@ -532,6 +850,102 @@ gcide_iterator_count(gcide_iterator_t itr)
     return itr->numrefs;
 }
 
+/* Return the number of unique headwords that begin in page PAGENO at
+   positions 1 through REFNO. */
+static size_t
+_page_run_count(struct gcide_idx_file *file, size_t pageno, size_t refno)
+{
+    size_t i, n = 0;
+
+    for (i = 1; i <= refno; i++)
+	if (!_idx_same(file, pageno, i))
+	    n++;
+    return n;
+}
+
+/* Build the run table.  Its Nth element keeps the ordinal number
+   (1-based) of the unique headword the first reference in page N
+   belongs to.  Together with a scan of a single page, this gives the
+   ordinal number of any reference in the index. */
+static int
+_idx_build_runs(struct gcide_idx_file *file)
+{
+    size_t n = file->header.ihdr_num_pages;
+    size_t *runs;
+    size_t i, count = 0;
+
+    runs = calloc(n ? n : 1, sizeof(runs[0]));
+    if (!runs) {
+	DICO_LOG_ERRNO();
+	return -1;
+    }
+    for (i = 0; i < n; i++) {
+	if (i == 0 || !_fence_equal(file, 2 * i - 1, 2 * i))
+	    count++;
+	runs[i] = count;
+	count += _page_run_count(file, i, _idx_nrefs(file, i) - 1);
+    }
+    file->page_runs = runs;
+    return 0;
+}
+
+/* Reposition ITR to the SKIPth unique headword after its start
+   position.  Return -1 if there is no such headword or it falls outside
+   the range the iterator tracks. */
+int
+gcide_iterator_skip(gcide_iterator_t itr, size_t skip)
+{
+    struct gcide_idx_file *file;
+    size_t target, n, l, u, pageno, refno, nrefs;
+
+    if (!itr)
+	return -1;
+    if (skip == 0)
+	return 0;
+    file = itr->file;
+    if (!file->page_runs && _idx_build_runs(file))
+	return -1;
+
+    target = file->page_runs[itr->start_pageno]
+	      + _page_run_count(file, itr->start_pageno, itr->start_refno)
+	      + skip;
+
+    /* Find the last page whose first reference precedes the target. */
+    l = itr->start_pageno;
+    u = file->header.ihdr_num_pages;
+    while (l < u) {
+	size_t m = (l + u) / 2;
+	if (file->page_runs[m] < target)
+	    l = m + 1;
+	else
+	    u = m;
+    }
+    pageno = l - 1;
+
+    nrefs = _idx_nrefs(file, pageno);
+    n = file->page_runs[pageno];
+    for (refno = 1; refno < nrefs; refno++) {
+	if (!_idx_same(file, pageno, refno) && ++n == target)
+	    break;
+    }
+    if (refno >= nrefs) {
+	/* The target headword begins the next page. */
+	if (++pageno >= file->header.ihdr_num_pages)
+	    return -1;
+	refno = 0;
+    }
+
+    if (_compare_ref(file, &itr->key, pageno, refno))
+	return -1;
+
+    itr->start_pageno = itr->cur_pageno = pageno;
+    itr->start_refno = itr->cur_refno = refno;
+    itr->page_numrefs = _idx_nrefs(file, pageno);
+    itr->curref = itr->numrefs = 0;
+    itr->compare_count = file->compare_count;
+    return 0;
+}
+
 size_t
 gcide_iterator_compare_count(gcide_iterator_t itr)
 {
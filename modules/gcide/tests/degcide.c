@@ -38,107 +38,120 @@ struct output_closure {
 };
 
 static int
-print_tag(int end, struct gcide_tag *tag, void *data)
+print_tag_begin(char const *text, size_t len, size_t namelen, void *data)
 {
-    size_t i;
     struct output_closure *clos = data;
 
-    if (end) {
-	clos->level--;
-	printf("%*.*s", 2*clos->level,2*clos->level, "");
-	printf("END");
-	if (tag->tag_parmc)
-	    printf(" %s", tag->tag_name);
-	putchar('\n');
-	return 0;
-    }
     printf("%*.*s", 2*clos->level,2*clos->level, "");
-    switch (tag->tag_type) {
-    case gcide_content_unspecified:
-	break;
-    case gcide_content_text:
-	printf("TEXT");
-	for (i = 0; i < tag->tag_parmc; i++)
-	    printf(" %s", tag->tag_parmv[i]);
-	printf(":\n%s\n%*.*sENDTEXT", tag->tag_v.text,
-	       2*clos->level, 2*clos->level, "");
-	if (tag->tag_parmc)
-	    printf(" %s", tag->tag_name);
-	putchar('\n');
-	break;
-    case gcide_content_taglist:
-	printf("BEGIN");
-	for (i = 0; i < tag->tag_parmc; i++)
-	    printf(" %s", tag->tag_parmv[i]);
-	putchar('\n');
-	clos->level++;
-	break;
-    }
+    printf("BEGIN %.*s\n", (int) len, text);
+    clos->level++;
+    return 0;
+}
+
+static int
+print_tag_end(char const *name, size_t len, void *data)
+{
+    struct output_closure *clos = data;
+
+    clos->level--;
+    printf("%*.*s", 2*clos->level,2*clos->level, "");
+    printf("END %.*s\n", (int) len, name);
     return 0;
 }
 
+static int
+print_tag_text(char const *text, size_t len, void *data)
+{
+    struct output_closure *clos = data;
+
+    printf("%*.*s", 2*clos->level,2*clos->level, "");
+    printf("TEXT:\n%s\n%*.*sENDTEXT\n", text,
+	   2*clos->level, 2*clos->level, "");
+    return 0;
+}
+
+static struct gcide_markup_handler struct_handler = {
+    print_tag_begin,
+    print_tag_end,
+    print_tag_text
+};
+
 #define GCIDE_NOPR 0x0000001
 #define GOF_IGNORE 0x0001000
 #define GOF_AS     0x0002000
 
+static char *quote[2] = { "``", "''" };
+static char *ref[2] = { "{" , "}" };
+
+static inline int
+tag_name_is(char const *name, size_t len, char const *str)
+{
+    return strlen(str) == len && memcmp(name, str, len) == 0;
+}
+
 static int
-print_text(int end, struct gcide_tag *tag, void *data)
+print_text_begin(char const *text, size_t len, size_t namelen, void *data)
 {
     struct output_closure *clos = data;
-    static char *quote[2] = { "``", "''" };
-    static char *ref[2] = { "{" , "}" };
-
-    switch (tag->tag_type) {
-    case gcide_content_unspecified:
-	break;
-    case gcide_content_text:
-	if (clos->flags & GOF_IGNORE)
-	    break;
-	if (clos->flags & GOF_AS) {
-	    char *s = tag->tag_v.text;
-	    
-	    if (strncmp(s, "as", 2) == 0 &&
-		(isspace(s[3]) || ispunct(s[3]))) {
-		fwrite(s, 3, 1, clos->stream);
-		for (s += 3; *s && isspace(*s); s++)
-		    fputc(*s, clos->stream);
-		fprintf(clos->stream, "%s%s", quote[0], s);
-	    } else
-		fprintf(clos->stream, "%s", quote[0]);
-	} else
-	    fprintf(clos->stream, "%s", tag->tag_v.text);
-	break;
-    case gcide_content_taglist:
-	if (tag->tag_parmc) {
-	    clos->flags &= ~GOF_AS;
-	    if (end) {
-		if (strcmp(tag->tag_name, "pr") == 0 &&
-			 clos->flags & GCIDE_NOPR)
-		    clos->flags &= ~GOF_IGNORE;
-		else if (clos->flags & GOF_IGNORE)
-		    break;
-		else if (strcmp(tag->tag_name, "as") == 0)
-		    fprintf(clos->stream, "%s", quote[1]);
-		else if (strcmp(tag->tag_name, "er") == 0)
-		    fprintf(clos->stream, "%s", ref[1]);
-	    } else {
-		if (strcmp(tag->tag_name, "pr") == 0 &&
-			 clos->flags & GCIDE_NOPR)
-		    clos->flags |= GOF_IGNORE;
-		else if (clos->flags & GOF_IGNORE)
-		    break;
-		else if (strcmp(tag->tag_name, "sn") == 0)
-		    fputc('\n', clos->stream);
-		else if (strcmp(tag->tag_name, "as") == 0)
-		    clos->flags |= GOF_AS;
-		else if (strcmp(tag->tag_name, "er") == 0)
-		    fprintf(clos->stream, "%s", ref[0]);
-	    }
-	}
-    }
+
+    clos->flags &= ~GOF_AS;
+    if (tag_name_is(text, namelen, "pr") && clos->flags & GCIDE_NOPR)
+	clos->flags |= GOF_IGNORE;
+    else if (clos->flags & GOF_IGNORE)
+	return 0;
+    else if (tag_name_is(text, namelen, "sn"))
+	fputc('\n', clos->stream);
+    else if (tag_name_is(text, namelen, "as"))
+	clos->flags |= GOF_AS;
+    else if (tag_name_is(text, namelen, "er"))
+	fprintf(clos->stream, "%s", ref[0]);
+    return 0;
+}
+
+static int
+print_text_end(char const *name, size_t len, void *data)
+{
+    struct output_closure *clos = data;
+
+    clos->flags &= ~GOF_AS;
+    if (tag_name_is(name, len, "pr") && clos->flags & GCIDE_NOPR)
+	clos->flags &= ~GOF_IGNORE;
+    else if (clos->flags & GOF_IGNORE)
+	return 0;
+    else if (tag_name_is(name, len, "as"))
+	fprintf(clos->stream, "%s", quote[1]);
+    else if (tag_name_is(name, len, "er"))
+	fprintf(clos->stream, "%s", ref[1]);
+    return 0;
+}
+
+static int
+print_text(char const *text, size_t len, void *data)
+{
+    struct output_closure *clos = data;
+    char const *s = text;
+
+    if (clos->flags & GOF_IGNORE)
+	return 0;
+    if (!(clos->flags & GOF_AS))
+	fwrite(text, len, 1, clos->stream);
+    else if (len > 3 && strncmp(s, "as", 2) == 0 &&
+	     (isspace((unsigned char) s[3]) || ispunct((unsigned char) s[3]))) {
+	fwrite(s, 3, 1, clos->stream);
+	for (s += 3; *s && isspace((unsigned char) *s); s++)
+	    fputc(*s, clos->stream);
+	fprintf(clos->stream, "%s%s", quote[0], s);
+    } else
+	fprintf(clos->stream, "%s", quote[0]);
     return 0;
 }
 
+static struct gcide_markup_handler text_handler = {
+    print_text_begin,
+    print_text_end,
+    print_text
+};
+
 int
 main(int argc, char **argv)
 {
@@ -147,7 +160,6 @@ main(int argc, char **argv)
     unsigned long size = 0;
     FILE *fp;
     char *textbuf;
-    struct gcide_parse_tree *tree;
     struct output_closure clos;
     int show_struct = 0;
     int dbglex = 0;
@@ -226,13 +238,10 @@ main(int argc, char **argv)
 	exit(EX_UNAVAILABLE);
     }
 	
-    tree = gcide_markup_parse(textbuf, size, dbglex);
-    if (!tree)
-	exit(EX_UNAVAILABLE);
-
     clos.level = 0;
-    gcide_parse_tree_inorder(tree, show_struct ? print_tag : print_text, &clos);
-    
-    gcide_parse_tree_free(tree);
+    if (gcide_markup_scan(textbuf, size, dbglex,
+			  show_struct ? &struct_handler : &text_handler,
+			  &clos))
+	exit(EX_UNAVAILABLE);
     exit(0);
 }
@@ -0,0 +1,128 @@
+# This file is part of GNU Dico.
+# Copyright (C) 2021 Sergey Poznyakoff
+#
+# GNU Dico is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GNU Dico is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>.
+
+# Generate a trie from the keys of a translation table in a C source.
+#
+# The table is an array of structures, whose first member is the key
+# string, terminated by an entry with NULL key.  The trie is an array
+# of struct gcide_trie_node.  Its nodes are numbered in breadth-first
+# order, so that the children of each node are consecutive, and sorted
+# by their characters.  The value of a node is the index in the table
+# of the first entry whose key leads to that node, or -1.
+#
+# Usage: awk -v table=NAME -f trie.awk file.c > file.h
+
+function unescape(s,   r, c, i) {
+    r = ""
+    for (i = 1; i <= length(s); i++) {
+	c = substr(s, i, 1)
+	if (c == "\\")
+	    c = substr(s, ++i, 1)
+	r = r c
+    }
+    return r
+}
+
+function charlit(c) {
+    if (c == "'" || c == "\\")
+	return "'\\" c "'"
+    return "'" c "'"
+}
+
+BEGIN {
+    if (table == "") {
+	print "trie.awk: table name not given" > "/dev/stderr"
+	exit 1
+    }
+    for (i = 1; i < 256; i++)
+	ord[sprintf("%c", i)] = i
+}
+
+$0 ~ "^static struct [a-z_]+ " table "\\[\\] = \\{" {
+    intable = 1
+    n = 0
+    next
+}
+
+intable && /\{ *NULL *\}/ {
+    intable = 0
+    done = 1
+    next
+}
+
+intable && match($0, /\{ *"([^"\\]|\\.)*"/) {
+    key = substr($0, RSTART, RLENGTH)
+    sub(/^\{ *"/, "", key)
+    key = unescape(substr(key, 1, length(key) - 1))
+    for (i = 1; i <= length(key); i++) {
+	p = substr(key, 1, i)
+	if (!(p in value)) {
+	    value[p] = -1
+	    q = substr(key, 1, i - 1)
+	    kids[q] = kids[q] substr(key, i, 1)
+	}
+    }
+    if (value[key] == -1)
+	value[key] = n
+    n++
+}
+
+END {
+    if (!done) {
+	print "trie.awk: table " table " not found" > "/dev/stderr"
+	exit 1
+    }
+
+    # Number the nodes in breadth-first order
+    queue[0] = ""
+    qlen = 1
+    for (q = 0; q < qlen; q++) {
+	p = queue[q]
+	s = kids[p]
+	# Sort the children
+	m = length(s)
+	for (i = 1; i <= m; i++)
+	    ch[i] = substr(s, i, 1)
+	for (i = 2; i <= m; i++) {
+	    c = ch[i]
+	    for (j = i - 1; j >= 1 && ord[ch[j]] > ord[c]; j--)
+		ch[j+1] = ch[j]
+	    ch[j+1] = c
+	}
+	first[p] = qlen
+	nkids[p] = m
+	for (i = 1; i <= m; i++)
+	    queue[qlen++] = p ch[i]
+    }
+
+    name = FILENAME
+    sub(/.*\//, "", name)
+    print "/* This file is generated automatically by trie.awk from " \
+	  name "."
+    print "   Do not edit. */\n"
+    printf "static const struct gcide_trie_node %s_trie[] = {\n", table
+    printf "    /* char, value, first child, number of children */\n"
+    for (q = 0; q < qlen; q++) {
+	p = queue[q]
+	printf "    { %s, %d, %d, %d },", \
+	    q ? charlit(substr(p, length(p), 1)) : "0",
+	    q ? value[p] : -1, first[p], nkids[p]
+	if (q)
+	    printf " /* %s */", p
+	printf "\n"
+    }
+    print "};"
+}
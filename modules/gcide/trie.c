@@ -0,0 +1,55 @@
+/* This file is part of GNU Dico.
+   Copyright (C) 2021 Sergey Poznyakoff
+
+   GNU Dico is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GNU Dico is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU Dico.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <config.h>
+#include <stdlib.h>
+#include "gcide.h"
+
+/* Find the longest key in TRIE that is a prefix of STR.  At most LEN
+   bytes of STR are examined, or less if it is terminated by a nul.
+   Return the value of the key and store its length in *PLEN.  Return -1
+   if no key is found. */
+int
+gcide_trie_lookup(struct gcide_trie_node const *trie,
+		  char const *str, size_t len, size_t *plen)
+{
+    struct gcide_trie_node const *node = trie;
+    int value = -1;
+    size_t i;
+
+    for (i = 0; i < len && str[i]; i++) {
+	unsigned char c = str[i];
+	size_t lo = node->child;
+	size_t hi = lo + node->nchild;
+
+	/* Children are sorted by their characters */
+	while (lo < hi) {
+	    size_t mid = (lo + hi) / 2;
+	    if (trie[mid].c < c)
+		lo = mid + 1;
+	    else
+		hi = mid;
+	}
+	if (lo == node->child + node->nchild || trie[lo].c != c)
+	    break;
+	node = &trie[lo];
+	if (node->value >= 0) {
+	    value = node->value;
+	    *plen = i + 1;
+	}
+    }
+    return value;
+}
@@ -20,220 +20,72 @@
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
-
-#define METAPH_SEGM_SIZE 16
-
-struct metaph_segment {
-    char segm[METAPH_SEGM_SIZE];
-    struct metaph_segment *next;
+#include <sys/time.h>
+
+/* Double Metaphone codes are built in fixed-size buffers.  Characters
+   that do not fit are dropped, but the logical length of the code is
+   maintained, so that the encoder behaves as if the whole code were
+   kept.  Codes are trimmed to the requested length afterwards, so no
+   data is lost as long as it does not exceed DMETAPH_MAX_LENGTH. */
+#define DMETAPH_MAX_LENGTH 64
+
+struct dmetaph_code {
+    size_t length;                 /* Logical length of the code */
+    char buf[DMETAPH_MAX_LENGTH];  /* Code characters */
 };
 
-struct metaph_code {
-    size_t length;
-    size_t nsegm;
-    struct metaph_segment *segm_head, *segm_tail;
-};
-
-static size_t
-metaph_code_length(struct metaph_code *code)
-{
-    return code ? code->length : 0;
-}
+typedef struct {
+    struct dmetaph_code code[2];   /* Primary and secondary codes */
+    int alternate;                 /* True if the secondary code exists */
+} double_metaphone_code;
 
 static void
-metaph_code_trim(struct metaph_code *code, size_t length)
-{
-    if (code && code->length > length)
-	code->length = length;
-}
-
-static struct metaph_code *
-metaph_code_create(void)
-{
-    struct metaph_code *code = malloc(sizeof *code);
-    if (code) {
-	code->length = 0;
-	code->nsegm = 0;
-	code->segm_head = code->segm_tail = NULL;
-    }
-    return code;
-}
-
-static struct metaph_segment *
-metaph_code_alloc_segment(struct metaph_code *code)
-{
-    struct metaph_segment *newseg = malloc(sizeof newseg[0]);
-    if (!newseg)
-	return NULL;
-    newseg->next = NULL;
-    memset(newseg->segm, 0, METAPH_SEGM_SIZE);
-    if (code->segm_tail)
-	code->segm_tail->next = newseg;
-    else
-	code->segm_head = newseg;
-    code->segm_tail = newseg;
-    code->nsegm++;
-    return newseg;
-}
-
-static struct metaph_code *
-metaph_code_dup(struct metaph_code *src)
+dmetaph_code_add(struct dmetaph_code *code, char const *str)
 {
-    struct metaph_code *dst = metaph_code_create();
-    struct metaph_segment *src_segm, *dst_segm;
-    if (!dst)
-	return NULL;
-    for (src_segm = src->segm_head; src_segm; src_segm = src_segm->next) {
-	dst_segm = metaph_code_alloc_segment(dst);
-	memcpy(dst_segm->segm, src_segm->segm, METAPH_SEGM_SIZE);
-    }
-    dst->length = src->length;
-    return dst;
-}
-
-static void
-metaph_code_free(struct metaph_code *code)
-{
-    if (code) {
-	struct metaph_segment *s = code->segm_head;
-
-	while (s) {
-	    struct metaph_segment *next = s->next;
-	    free(s);
-	    s = next;
+    if (str) {
+	size_t len = strlen(str);
+	if (code->length < DMETAPH_MAX_LENGTH) {
+	    size_t n = DMETAPH_MAX_LENGTH - code->length;
+	    if (n > len)
+		n = len;
+	    memcpy(code->buf + code->length, str, n);
 	}
-	free(code);
-    }
-}
-
-static int
-metaph_code_eq(struct metaph_code *a, struct metaph_code *b)
-{
-    struct metaph_segment *sa, *sb;
-    size_t length;
-
-    if (a == NULL || b == NULL)
-	return 0;
-    
-    if (a->length != b->length)
-	return 0;
-    length = a->length;
-    sa = a->segm_head;
-    sb = b->segm_head;
-    while (length) {
-	size_t segm_length = length < METAPH_SEGM_SIZE
-	                        ? length : METAPH_SEGM_SIZE;
-	if (memcmp(sa->segm, sb->segm, segm_length))
-	    return 0;
-	length -= segm_length;
-	sa = sa->next;
-	sb = sb->next;
+	code->length += len;
     }
-    return 1;
 }
 
 static int
-metaph_code_get_buffer(struct metaph_code *code,
-		       char **ret_ptr, size_t *ret_size)
+dmetaph_code_eq(struct dmetaph_code const *a, struct dmetaph_code const *b)
 {
-    size_t s = code->nsegm * METAPH_SEGM_SIZE - code->length;
-    if (s == 0) {
-	if (!metaph_code_alloc_segment(code))
-	    return -1;
-	s = METAPH_SEGM_SIZE;
-    }
-    *ret_ptr = code->segm_tail->segm + code->length % METAPH_SEGM_SIZE;
-    *ret_size = s;
-    return 0;
-}
-
-static int
-metaph_code_add(struct metaph_code *code, char const *str)
-{
-    if (str) {
-	size_t length = strlen(str);
-
-	while (length) {
-	    char *p;
-	    size_t n;
-	    
-	    if (metaph_code_get_buffer(code, &p, &n))
-		return -1;
-	    if (n > length)
-		n = length;
-	    memcpy(p, str, n);
-	    str += n;
-	    code->length += n;
-	    length -= n;
-	}
-    }
-    return 0;
+    return a->length == b->length
+	&& memcmp(a->buf, b->buf,
+		  a->length < DMETAPH_MAX_LENGTH
+		    ? a->length : DMETAPH_MAX_LENGTH) == 0;
 }
 
 static void
-metaph_code_dump(struct metaph_code *code)
+dmetaph_code_dump(struct dmetaph_code const *code)
 {
-    if (!code)
-	printf("%s\n", "NULL");
-    else {
-	struct metaph_segment *s;
-	size_t length;
-	
-	printf("length = %zu\n", code->length);
-	printf("nsegm = %zu\n", code->nsegm);
-	length = code->length;
-	for (s = code->segm_head; s; s = s->next) {
-	    size_t i;
-	    
-	    putchar('\'');
-	    for (i = 0; length > 0 && i < METAPH_SEGM_SIZE; i++, length--)
-		putchar(s->segm[i]);
-	    printf("'\n");
-	}
-    }
-}    
+    size_t n = code->length < DMETAPH_MAX_LENGTH
+	         ? code->length : DMETAPH_MAX_LENGTH;
+    printf("length = %zu\n", code->length);
+    printf("'%.*s'\n", (int) n, code->buf);
+}
 
 static void
-metaph_code_print(struct metaph_code *code)
-{
-    if (!code)
-	printf("%s\n", "NULL");
-    else {
-	struct metaph_segment *s;
-	size_t length;
-	
-	length = code->length;
-	for (s = code->segm_head; s; s = s->next) {
-	    size_t i;
-            for (i = 0; length > 0 && i < METAPH_SEGM_SIZE; i++, length--)
-		putchar(s->segm[i]);
-	}
-    }
-}    
-
-typedef struct metaph_code *double_metaphone_code[2];
-
-static int
-double_metaphone_add(double_metaphone_code code,
+double_metaphone_add(double_metaphone_code *code,
 		     char const *primary,
 		     char const *secondary)
 {
     if (secondary) {
-	if (!code[1]) {
-	    code[1] = metaph_code_dup(code[0]);
-	    if (!code[1]) {
-                DICO_LOG_MEMERR();
-		return -1;
-	    }
+	if (!code->alternate) {
+	    code->code[1] = code->code[0];
+	    code->alternate = 1;
 	}
-        if (metaph_code_add(code[1], secondary))
-	    return -1;
-    } else if (code[1]) {
-        if (metaph_code_add(code[1], primary))
-            return -1;
-    }
-    metaph_code_add(code[0], primary);
-    return 0;
+        dmetaph_code_add(&code->code[1], secondary);
+    } else if (code->alternate)
+        dmetaph_code_add(&code->code[1], primary);
+    dmetaph_code_add(&code->code[0], primary);
 }
 
 /* Return true if POS + OFF is within the STR and the substring at
@@ -267,13 +119,6 @@ looking_at(unsigned const *str, size_t pos, int off, char const *pat)
     return 0;
 }
 
-static void
-double_metaphone_free(double_metaphone_code code)
-{
-    metaph_code_free(code[0]);
-    metaph_code_free(code[1]);
-}
-
 #define ISVOWEL(s,p,i) looking_at(s, p, i, "A|E|I|O|U|Y")
 
 static int
@@ -297,39 +142,74 @@ is_slavo_germanic(unsigned const *str)
     return 0;
 }
 
+/* Words up to this length are encoded without allocating memory. */
+#define DMETAPH_WORD_MAX 128
+/* Number of zeros after the word, to allow for look-ahead. */
+#define DMETAPH_PAD 8
+
+/* Convert STR to an upper-case wide character string.  Use WBUF if
+   it is large enough, otherwise allocate the string.  Return the
+   string and store its length in *PLEN. */
+static unsigned *
+dmetaph_upcase(char const *str, unsigned *wbuf, size_t *plen)
+{
+    unsigned char const *p = (unsigned char const *) str;
+    unsigned *w;
+    size_t i, len;
+
+    /* ASCII fast path */
+    for (i = 0; i < DMETAPH_WORD_MAX && p[i] && p[i] < 0x80; i++)
+	wbuf[i] = (p[i] >= 'a' && p[i] <= 'z') ? p[i] - 'a' + 'A' : p[i];
+    if (p[i] == 0) {
+	memset(wbuf + i, 0, DMETAPH_PAD * sizeof(wbuf[0]));
+	*plen = i;
+	return wbuf;
+    }
+
+    if (utf8_casefold_wc(str, &w, &len)) {
+	dico_log(L_ERR, errno, "%s: cannot convert \"%s\"", __func__, str);
+	return NULL;
+    }
+    if (len < DMETAPH_WORD_MAX) {
+	memcpy(wbuf, w, len * sizeof(w[0]));
+	free(w);
+	w = wbuf;
+    } else {
+	unsigned *np = realloc(w, (len + DMETAPH_PAD) * sizeof(w[0]));
+	if (!np) {
+	    DICO_LOG_MEMERR();
+	    free(w);
+	    return NULL;
+	}
+	w = np;
+    }
+    memset(w + len, 0, DMETAPH_PAD * sizeof(w[0]));
+    *plen = len;
+    return w;
+}
+
 static int
-double_metaphone_encode(double_metaphone_code code,
+double_metaphone_encode(double_metaphone_code *code,
 			char const *str, size_t max_length)
 {
+    unsigned wbuf[DMETAPH_WORD_MAX + DMETAPH_PAD];
     unsigned *buf;          /* STR converted to UTF */
     size_t current = 0;     /* Current position */
     size_t length, last;
-#define DMETAPH_ADD(c,a,b)			\
-    do {					\
-	if (double_metaphone_add(c,a,b))	\
-	    goto err;				\
-    } while (0)
+    int i;
+#define DMETAPH_ADD(c,a,b) double_metaphone_add(c,a,b)
     int slavo_germanic = -1; 
 #define IS_SLAVO_GERMANIC()						\
     ((slavo_germanic == -1)						\
      ? (slavo_germanic = is_slavo_germanic(buf)) : slavo_germanic)
     
-    if (utf8_mbstr_to_wc(str, &buf, NULL)) {
-	dico_log(L_ERR, errno, "%s: cannot convert \"%s\"", __func__, str);
+    buf = dmetaph_upcase(str, wbuf, &length);
+    if (!buf)
 	return -1;
-    }
-    length = utf8_wc_strlen(buf);
     last = length - 1;
-    
-    code[0] = metaph_code_create();
-    if (!code[0]) {
-	dico_log(L_ERR, 0, _("%s: not enough memory"), __func__);
-	free(buf);
-	return -1;
-    }
-    code[1] = NULL;
 
-    utf8_wc_strupper(buf);
+    code->code[0].length = 0;
+    code->alternate = 0;
     
     current = 0;
     if (looking_at(buf, current, 0, "GN|KN|PN|WR|PS"))
@@ -337,8 +217,9 @@ double_metaphone_encode(double_metaphone_code code,
 
     while (current < length
 	   && (max_length == 0
-	       || metaph_code_length(code[0]) < max_length
-	       || metaph_code_length(code[1]) < max_length)) {
+	       || code->code[0].length < max_length
+	       || !code->alternate
+	       || code->code[1].length < max_length)) {
 	switch (buf[current]) {
 	case 'A':
 	case 'E':
@@ -969,28 +850,32 @@ double_metaphone_encode(double_metaphone_code code,
 	}
     }
 
-    free(buf);
+    if (buf != wbuf)
+	free(buf);
 
-    if (max_length) {
+    for (i = 0; i < 1 + code->alternate; i++) {
 	/* Trim returned codes */
-	metaph_code_trim(code[0], max_length);
-	metaph_code_trim(code[1], max_length);
+	if (max_length && code->code[i].length > max_length)
+	    code->code[i].length = max_length;
+	if (code->code[i].length > DMETAPH_MAX_LENGTH) {
+	    dico_log(L_ERR, 0, "%s: code too long for \"%s\"",
+		     __func__, str);
+	    return -1;
+	}
     }
     
     return 0;
-err:
-    free(buf);
-    double_metaphone_free(code);
-    return -1;
 }
 
 static int
-double_metaphone_eq(double_metaphone_code a, double_metaphone_code b)
+double_metaphone_eq(double_metaphone_code const *a,
+		    double_metaphone_code const *b)
 {
-    return metaph_code_eq(a[0], b[0])
-	|| metaph_code_eq(a[1], b[1])
-	|| metaph_code_eq(a[0], b[1])
-	|| metaph_code_eq(a[1], b[0]);
+    return dmetaph_code_eq(&a->code[0], &b->code[0])
+	|| (a->alternate && b->alternate
+	    && dmetaph_code_eq(&a->code[1], &b->code[1]))
+	|| (b->alternate && dmetaph_code_eq(&a->code[0], &b->code[1]))
+	|| (a->alternate && dmetaph_code_eq(&a->code[1], &b->code[0]));
 }
 
 static size_t double_metaphone_length = 4;
@@ -1003,34 +888,66 @@ metaphone2_sel(int cmd, struct dico_key *key, const char *dict_word)
     
     switch (cmd) {
     case DICO_SELECT_BEGIN:
-	if (double_metaphone_encode(code, key->word, double_metaphone_length))
+	if (double_metaphone_encode(&code, key->word, double_metaphone_length))
 	    return 1;
 	key->call_data = malloc(sizeof code);
 	if (!key->call_data)
 	    return 1;
-	memcpy(key->call_data, code, sizeof(code));
+	memcpy(key->call_data, &code, sizeof(code));
 	break;
 
     case DICO_SELECT_RUN:
-	if (double_metaphone_encode(code, dict_word, double_metaphone_length))
+	if (double_metaphone_encode(&code, dict_word, double_metaphone_length))
 	    return 1;
-	res = double_metaphone_eq(*(double_metaphone_code*)key->call_data,
-				   code);
-	double_metaphone_free(code);
+	res = double_metaphone_eq(key->call_data, &code);
 	return res;
 
     case DICO_SELECT_END:
-	double_metaphone_free(*(double_metaphone_code*)key->call_data);
 	free(key->call_data);
 	break;
     }
     return 0;
 }
 
+/* Return the code as a newly allocated string. */
+static char *
+dmetaph_code_string(struct dmetaph_code const *code)
+{
+    char *str = malloc(code->length + 1);
+    if (str) {
+	memcpy(str, code->buf, code->length);
+	str[code->length] = 0;
+    }
+    return str;
+}
+
+/* Key derivation function: the keys are the primary and secondary
+   encodings of the word. */
+static int
+metaphone2_key(const char *word, char **keys)
+{
+    double_metaphone_code code;
+    int i, n = 0;
+
+    if (double_metaphone_encode(&code, word, double_metaphone_length))
+	return -1;
+    for (i = 0; i < 1 + code.alternate; i++) {
+	keys[n] = dmetaph_code_string(&code.code[i]);
+	if (!keys[n]) {
+	    while (n > 0)
+		free(keys[--n]);
+	    return -1;
+	}
+	n++;
+    }
+    return n;
+}
+
 static struct dico_strategy metaphone2_strat = {
-    "metaphone2",
-    "Match Double Metaphone encodings",
-    metaphone2_sel
+    .name = "metaphone2",
+    .descr = "Match Double Metaphone encodings",
+    .sel = metaphone2_sel,
+    .keyfn = metaphone2_key
 };
     
 static int
@@ -1045,6 +962,11 @@ metaphone2_init(int argc, char **argv)
 
     if (dico_parseopt(metaphone2_option, argc, argv, 0, NULL))
 	return 1;
+    if (size > DMETAPH_MAX_LENGTH) {
+	dico_log(L_WARN, 0, _("metaphone2: size too big, using %d"),
+		 DMETAPH_MAX_LENGTH);
+	size = DMETAPH_MAX_LENGTH;
+    }
     if (size > 0)
 	double_metaphone_length = size;
     
@@ -1069,30 +991,22 @@ metaphone2_run_test(int argc, char **argv)
     argc--;
     cmd = *argv++;
     if (strcmp(cmd, "build") == 0) {
-	struct metaph_code *code;
+	struct dmetaph_code code;
 	
-	code = metaph_code_create();
-	assert(code != NULL);
-	while (argc--) {
-	    int res = metaph_code_add(code, *argv++);
-	    assert(res == 0);
-	}
-	metaph_code_dump(code);
-	metaph_code_free(code);
+	code.length = 0;
+	while (argc--)
+	    dmetaph_code_add(&code, *argv++);
+	dmetaph_code_dump(&code);
     } else if (strcmp(cmd, "compare") == 0) {
-	struct metaph_code *a, *b;
-	int res;
+	struct dmetaph_code a, b;
 	
-	a = metaph_code_create();
-	assert(a != NULL);
+	a.length = 0;
 	while (argc--) {
 	    char *arg = *argv++;
 	    if (strcmp(arg, ":") == 0)
 		break;
-	    else {
-		res = metaph_code_add(a, arg);
-		assert(res == 0);
-	    }
+	    else
+		dmetaph_code_add(&a, arg);
 	}
 
 	if (argc <= 0) {
@@ -1100,16 +1014,48 @@ metaphone2_run_test(int argc, char **argv)
 	    return 1;
 	}
 	
-	b = metaph_code_create();
-	assert(b != NULL);
-	while (argc--) {
-	    res = metaph_code_add(b, *argv++);
-	    assert(res == 0);
+	b.length = 0;
+	while (argc--)
+	    dmetaph_code_add(&b, *argv++);
+	printf("%d\n", dmetaph_code_eq(&a, &b));
+    } else if (strcmp(cmd, "bench") == 0) {
+	unsigned long len = double_metaphone_length, count = 10000, n;
+	struct timeval start, end;
+	double elapsed;
+	int i;
+	
+	for (; argc > 0 && argv[0][0] == '-'; argc--, argv++) {
+	    char *p;
+	    if (strncmp(*argv, "-length=", 8) == 0)
+		len = strtoul(*argv + 8, &p, 10);
+	    else if (strncmp(*argv, "-count=", 7) == 0)
+		count = strtoul(*argv + 7, &p, 10);
+	    else {
+		dico_log(L_ERR, 0, "unknown option: %s", *argv);
+		return 1;
+	    }
+	    assert(*p == 0);
+	}
+	if (argc == 0) {
+	    dico_log(L_ERR, 0, "bad argument list");
+	    return 1;
+	}
+	gettimeofday(&start, NULL);
+	for (n = 0; n < count; n++) {
+	    for (i = 0; i < argc; i++) {
+		double_metaphone_code code;
+		if (double_metaphone_encode(&code, argv[i], len)) {
+		    dico_log(L_ERR, errno, "can't encode");
+		    return 1;
+		}
+	    }
 	}
-	res = metaph_code_eq(a, b);
-	metaph_code_free(a);
-	metaph_code_free(b);
-	printf("%d\n", res);
+	gettimeofday(&end, NULL);
+	elapsed = (end.tv_sec - start.tv_sec)
+	           + (end.tv_usec - start.tv_usec) / 1e6;
+	printf("%lu words in %.3f s: %.0f words/s\n",
+	       count * argc, elapsed,
+	       elapsed > 0 ? count * argc / elapsed : 0.0);
     } else if (strcmp(cmd, "encode") == 0) {
 	unsigned long len = 0;
 	if (strncmp(*argv, "-length=", 8) == 0) {
@@ -1123,41 +1069,35 @@ metaphone2_run_test(int argc, char **argv)
 	    char *arg = *argv++;
 	    double_metaphone_code code;
 	    
-	    if (double_metaphone_encode(code, arg, len))
+	    if (double_metaphone_encode(&code, arg, len))
 		dico_log(L_ERR, errno, "can't encode");
 	    else {
 		printf("%s: ", arg);
-		if (code[0]) {
-		    printf("'");
-		    metaph_code_print(code[0]);
-		    printf("'");
-		} else {
-		    printf("NULL");
-		}
+		printf("'%.*s'", (int) code.code[0].length, code.code[0].buf);
 		printf(" -- ");
-		if (code[1]) {
-		    printf("'");
-		    metaph_code_print(code[1]);
-		    printf("'");
-		} else {
+		if (code.alternate)
+		    printf("'%.*s'", (int) code.code[1].length,
+			   code.code[1].buf);
+		else
 		    printf("NULL");
-		}
 		putchar('\n');
-		double_metaphone_free(code);
 	    }
 	}
     } else {
 	dico_log(L_ERR, 0, "unrecognized unit test: %s", cmd);
 	dico_log(L_INFO, 0, "usage:");
 	printf("usage: %s build SEQ [SEQ...]\n"
-	       "   build a metaphone code block from the sequence of letters\n",
+	       "   build a metaphone code from the sequence of letters\n",
 	       modname);
 	printf("       %s compare SEQ [SEQ...] : SEQ [SEQ...]\n"
-	       "   build two blocks and compare them\n",
+	       "   build two codes and compare them\n",
 	       modname);
 	printf("       %s encode [-length=N] WORD [WORD...]\n"
 	       "   encode the supplied words\n",
 	       modname);
+	printf("       %s bench [-length=N] [-count=N] WORD [WORD...]\n"
+	       "   measure encoding throughput\n",
+	       modname);
 	return 1;
     }
     return 0;
@@ -25,6 +25,10 @@
 
    Returns at most <count> headwords whose prefix matches <string>,
    skipping <skip> first unique matches.
+
+   The strategy is flagged as DICO_STRAT_PREFIX_PAGE, so that modules
+   with sorted indexes handle it natively.  The selector below serves
+   the rest.
 */
 
 struct nprefix {
@@ -109,7 +113,10 @@ nprefix_sel(int cmd, dico_key_t key, const char *dict_word)
 }
 
 static struct dico_strategy nprefix_strat[] = {
-    { "nprefix", "Match prefixes, [skip#count#]prefix", nprefix_sel },
+    { .name = "nprefix",
+      .descr = "Match prefixes, [skip#count#]prefix",
+      .sel = nprefix_sel,
+      .flags = DICO_STRAT_PREFIX_PAGE },
     { NULL }
 };
 
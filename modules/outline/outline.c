@@ -47,9 +47,13 @@
 	command "outline";
    }
    database {
-        handler "outline <filename>";
+        handler "outline [index-file=<name>] [nowatch] <filename>";
 	...
    }
+
+   If index-file is given, the headword index is saved in that file and
+   reused on subsequent startups.  The database is reloaded when
+   <filename> changes, unless nowatch is given.
 */   
 
 
@@ -58,11 +62,26 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <ctype.h>
 #include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#ifdef HAVE_SYS_INOTIFY_H
+# include <sys/inotify.h>
+#endif
 #include <appi18n.h>
 #include <wordsplit.h>
 
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+# define ST_MTIME_NS(st) ((st).st_mtim.tv_nsec)
+#else
+# define ST_MTIME_NS(st) 0
+#endif
+
 static size_t compare_count;
 
 struct entry {
@@ -74,123 +93,661 @@ struct entry {
     struct entry *peer;
 };
 
+/* Top-level chapters with special meaning */
+enum {
+    META_INFO,
+    META_DESCR,
+    META_LANG,
+    META_MIME,
+    META_MAX
+};
+
+static char const *meta_name[] = {
+    "info",
+    "description",
+    "languages",
+    "mime"
+};
+
 struct outline_file {
-    char *name;
-    FILE *fp;
+    char *name;               /* Database file name */
+    char *idx_name;           /* Index file name, NULL if not used */
+    int watch;                /* Reload the file when it changes */
+    int watch_fd;             /* Inotify descriptor or -1 */
+    pid_t watch_pid;          /* PID of the process that created it */
+
+    char *base;               /* Database file mapped to memory */
+    size_t size;              /* Its size */
+    dev_t dev;                /* Device and inode of the mapped file */
+    ino_t ino;
+    time_t mtime;             /* Its modification time */
+    long mtime_ns;            /* Nanoseconds part of it */
+
+    char *idx_base;           /* Index file mapped to memory */
+    size_t idx_size;          /* Its size */
+    char *pool;               /* Headwords, unless read from the index */
+    
     size_t count;
     struct entry *index;
     struct entry *suf_index;
-    
-    struct entry *info_entry, *descr_entry, *lang_entry, *mime_entry;
+    size_t *runs;             /* Run index (for paginated prefix search) */
+    dico_search_index_t search; /* Search index (for exact search) */
+
+    struct entry meta[META_MAX]; /* Chapters; offset is -1 if missing */
+    char *meta_text[META_MAX];   /* Their texts, copied from the file */
 };
 
+#define outline_meta(file, n) \
+    ((file)->meta[n].offset == -1 ? NULL : &(file)->meta[n])
+
 #define STATE_INITIAL 0
 #define STATE_DICT    1
 
-static size_t
-trimnl(char *buf)
+static int
+compare_entry(const void *a, const void *b)
+{
+    const struct entry *epa = a;
+    const struct entry *epb = b;
+    compare_count++;
+    return utf8_strcasecmp(epa->word, epb->word);
+}
+
+static const char *
+entry_word(size_t n, void *closure)
 {
-    size_t len = strlen(buf);
-    if (len > 0 && buf[len - 1] == '\n')
-	buf[--len] = 0;
-    return len;
+    struct outline_file *file = closure;
+    return file->index[n].word;
 }
 
-static size_t
-trimws(char *buf)
+
+/* Scanning the database file */
+
+/* Return start of the line following the one at P. */
+static const char *
+next_line(const char *p, const char *end)
 {
-    size_t len = strlen(buf);
-    while (len > 0 && isspace(buf[len - 1]))
-	buf[--len] = 0;
-    return len;
+    const char *q = memchr(p, '\n', end - p);
+    return q ? q + 1 : end;
 }
-    
+
+/* Return start of the first header line at or after P. */
+static const char *
+find_header(const char *p, const char *end)
+{
+    while (p < end && *p != '*')
+	p = next_line(p, end);
+    return p;
+}
+
 static int
-find_header(struct outline_file *file, char *buf, size_t size, size_t *pread)
+meta_lookup(const char *word, size_t len)
 {
-    while (fgets(buf, size, file->fp)) {
-	size_t rdbytes = strlen(buf);
-	size_t len = trimnl(buf);
+    int i;
+
+    for (i = 0; i < META_MAX; i++)
+	if (strlen(meta_name[i]) == len
+	    && strncasecmp(meta_name[i], word, len) == 0)
+	    return i;
+    return -1;
+}
+
+/* Scan the mapped file and build the headword index. */
+static int
+outline_scan(struct outline_file *file)
+{
+    const char *p, *end = file->base + file->size;
+    int state = STATE_INITIAL;
+    size_t max = 0, poolsize = 0, i;
+    char *q;
+    
+    for (p = find_header(file->base, end); p < end; ) {
+	const char *eol, *word, *wend, *body;
+	int level, n;
+	struct entry ent;
 	
-	if (len > 0) {
-	    int level;
-
-	    for (level = 0; buf[level] == '*' && level < len; level++)
-		;
-	    if (level) {
-		*pread = rdbytes;
-		return level;
+	eol = memchr(p, '\n', end - p);
+	if (!eol)
+	    eol = end;
+	for (level = 0; p + level < eol && p[level] == '*'; level++)
+	    ;
+	for (word = p + level;
+	     word < eol && isspace(*(unsigned char*)word); word++)
+	    ;
+	for (wend = eol; wend > word && isspace(((unsigned char*)wend)[-1]);
+	     wend--)
+	    ;
+	/* The article begins after any empty lines */
+	for (body = eol < end ? eol + 1 : end; body < end && *body == '\n';
+	     body++)
+	    ;
+	p = find_header(body, end);
+
+	memset(&ent, 0, sizeof(ent));
+	ent.word = (char*) word;
+	ent.length = wend - word;
+	ent.offset = body - file->base;
+	ent.size = p - body;
+	
+	switch (state) {
+	case STATE_DICT:
+	    if (level == 2) {
+		if (file->count == max) {
+		    struct entry *np;
+		    size_t nmax = max ? 2 * max : 512;
+		    
+		    np = realloc(file->index, nmax * sizeof(np[0]));
+		    if (!np) {
+			dico_log(L_ERR, 0, "not enough memory");
+			return 1;
+		    }
+		    file->index = np;
+		    max = nmax;
+		}
+		file->index[file->count++] = ent;
+		poolsize += ent.length + 1;
+		break;
+	    } else if (level == 1) {
+		state = STATE_INITIAL;
+		/* FALL THROUGH */
+	    } else
+		break;
+
+	case STATE_INITIAL:
+	    if (level == 1) {
+		if ((n = meta_lookup(word, ent.length)) != -1) {
+		    ent.word = NULL;
+		    file->meta[n] = ent;
+		} else if (ent.length == 10
+			   && strncasecmp(word, "dictionary", 10) == 0)
+		    state = STATE_DICT;
 	    }
 	}
     }
+
+    /* Copy headwords to the pool */
+    file->pool = q = malloc(poolsize + 1);
+    if (!q) {
+	dico_log(L_ERR, 0, "not enough memory");
+	return 1;
+    }
+    for (i = 0; i < file->count; i++) {
+	struct entry *ep = &file->index[i];
+	memcpy(q, ep->word, ep->length);
+	q[ep->length] = 0;
+	ep->word = q;
+	ep->wordlen = utf8_strlen(q);
+	q += ep->length + 1;
+    }
+    
+    qsort(file->index, file->count, sizeof(file->index[0]), compare_entry);
     return 0;
 }
 
-static off_t
-skipws(struct outline_file *file, char *buf, size_t size)
+
+/* Persistent index.
+
+   The index is kept in a separate file, so that the database need not
+   be rescanned on each startup.  It begins with the magic string,
+   followed by IDX_HDR_MAX 32-bit words in little-endian order: size,
+   modification time (seconds and nanoseconds) and inode number of the
+   database file (two words each, except nanoseconds), number of
+   entries, size of the headword pool, and offset and size of each
+   META_MAX chapter (0xffffffff if the chapter is absent).  Then follow
+   the sorted entries, each consisting of IDX_ENTRY_WORDS 32-bit words:
+   offset of the headword in pool, its length in bytes and in characters,
+   offset and size of the article.  The pool of nul-terminated headwords
+   concludes the file.
+
+   The index is valid only if the recorded size, modification time and
+   inode match those of the database file.  Otherwise, it is rebuilt. */
+
+#define IDX_MAGIC "OUTLIDX2"
+#define IDX_MAGIC_LEN (sizeof(IDX_MAGIC) - 1)
+
+enum {
+    IDX_SIZE,
+    IDX_MTIME = IDX_SIZE + 2,
+    IDX_MTIME_NS = IDX_MTIME + 2,
+    IDX_INODE,
+    IDX_COUNT = IDX_INODE + 2,
+    IDX_POOLSIZE,
+    IDX_META,
+    IDX_HDR_MAX = IDX_META + 2 * META_MAX
+};
+
+enum {
+    IDX_ENT_WORD,
+    IDX_ENT_LENGTH,
+    IDX_ENT_WORDLEN,
+    IDX_ENT_OFFSET,
+    IDX_ENT_SIZE,
+    IDX_ENTRY_WORDS
+};
+
+#define IDX_HEADER_SIZE (IDX_MAGIC_LEN + 4 * IDX_HDR_MAX)
+#define IDX_ENTRY_SIZE (4 * IDX_ENTRY_WORDS)
+#define IDX_NONE 0xffffffff
+
+static inline uint32_t
+idx_get(const char *base, int n)
+{
+    const unsigned char *p = (const unsigned char *) base + 4 * n;
+    return (uint32_t) p[0]
+	   | ((uint32_t) p[1] << 8)
+	   | ((uint32_t) p[2] << 16)
+	   | ((uint32_t) p[3] << 24);
+}
+
+static inline uint64_t
+idx_get64(const char *base, int n)
 {
-    while (fgets(buf, size, file->fp)) {
-	size_t len = strlen(buf);
-	if (!(len == 1 && buf[0] == '\n')) {
-	    fseek(file->fp, -(off_t)len, SEEK_CUR);
-	    break;
-	}
-    }
-    return ftell(file->fp);
+    return idx_get(base, n) | ((uint64_t) idx_get(base, n + 1) << 32);
 }
 
-static struct entry *
-alloc_entry(const char *text, size_t len)
+static inline void
+idx_put(char *base, int n, uint32_t v)
 {
-    struct entry *ep = malloc(sizeof(*ep));
-    if (ep) {
-	memset(ep, 0, sizeof(*ep));
-	ep->word = malloc(len + 1);
-	if (!ep->word) {
-	    free(ep);
-	    return NULL;
+    unsigned char *p = (unsigned char *) base + 4 * n;
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+static inline void
+idx_put64(char *base, int n, uint64_t v)
+{
+    idx_put(base, n, v & 0xffffffff);
+    idx_put(base, n + 1, v >> 32);
+}
+
+/* Load the index from file.  Return 0 on success and 1 if the index
+   does not exist, is malformed or outdated. */
+static int
+outline_read_index(struct outline_file *file)
+{
+    int fd;
+    struct stat st;
+    char *base, *hdr, *pool;
+    struct entry meta[META_MAX];
+    uint32_t count, poolsize;
+    size_t i;
+    
+    fd = open(file->idx_name, O_RDONLY);
+    if (fd == -1)
+	return 1;
+    if (fstat(fd, &st) || st.st_size < IDX_HEADER_SIZE) {
+	close(fd);
+	return 1;
+    }
+    base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+	return 1;
+
+    hdr = base + IDX_MAGIC_LEN;
+    if (memcmp(base, IDX_MAGIC, IDX_MAGIC_LEN)
+	|| idx_get64(hdr, IDX_SIZE) != file->size
+	|| idx_get64(hdr, IDX_MTIME) != (uint64_t) file->mtime
+	|| idx_get(hdr, IDX_MTIME_NS) != (uint32_t) file->mtime_ns
+	|| idx_get64(hdr, IDX_INODE) != (uint64_t) file->ino)
+	goto invalid;
+
+    count = idx_get(hdr, IDX_COUNT);
+    poolsize = idx_get(hdr, IDX_POOLSIZE);
+    if (IDX_HEADER_SIZE + (uint64_t) count * IDX_ENTRY_SIZE + poolsize
+	  != st.st_size)
+	goto invalid;
+    pool = base + IDX_HEADER_SIZE + (size_t) count * IDX_ENTRY_SIZE;
+
+    for (i = 0; i < META_MAX; i++) {
+	uint32_t off = idx_get(hdr, IDX_META + 2 * i);
+	uint32_t size = idx_get(hdr, IDX_META + 2 * i + 1);
+	
+	memset(&meta[i], 0, sizeof(meta[i]));
+	if (off == IDX_NONE)
+	    meta[i].offset = -1;
+	else if ((uint64_t) off + size > file->size)
+	    goto invalid;
+	else {
+	    meta[i].offset = off;
+	    meta[i].size = size;
+	}
+    }
+    
+    file->index = calloc(count ? count : 1, sizeof(file->index[0]));
+    if (!file->index) {
+	dico_log(L_ERR, 0, "not enough memory");
+	goto invalid;
+    }
+    for (i = 0; i < count; i++) {
+	const char *rec = base + IDX_HEADER_SIZE + i * IDX_ENTRY_SIZE;
+	struct entry *ep = &file->index[i];
+	uint32_t word = idx_get(rec, IDX_ENT_WORD);
+
+	ep->length = idx_get(rec, IDX_ENT_LENGTH);
+	ep->wordlen = idx_get(rec, IDX_ENT_WORDLEN);
+	ep->offset = idx_get(rec, IDX_ENT_OFFSET);
+	ep->size = idx_get(rec, IDX_ENT_SIZE);
+	if ((uint64_t) word + ep->length >= poolsize
+	    || pool[word + ep->length] != 0
+	    || (uint64_t) ep->offset + ep->size > file->size) {
+	    free(file->index);
+	    file->index = NULL;
+	    goto invalid;
 	}
-	memcpy(ep->word, text, len);
-	ep->word[len] = 0;
-	ep->length = len; 
-	ep->wordlen = utf8_strlen(ep->word);
+	ep->word = pool + word;
+	ep->peer = NULL;
     }
-    return ep;
+    
+    file->count = count;
+    memcpy(file->meta, meta, sizeof(meta));
+    file->idx_base = base;
+    file->idx_size = st.st_size;
+    return 0;
+    
+ invalid:
+    munmap(base, st.st_size);
+    return 1;
 }
 
-static struct entry *
-read_entry(struct outline_file *file, int *plevel)
+/* Save the index built by outline_scan.  The file is written under
+   a temporary name and renamed, so that other processes never see
+   it incomplete. */
+static void
+outline_write_index(struct outline_file *file)
 {
-    char buf[128], *p;
-    struct entry *ep;
-    int level;
-    size_t rdbytes, len;
+    char *tmpname;
+    int fd;
+    FILE *fp;
+    char hdr[IDX_HEADER_SIZE], rec[IDX_ENTRY_SIZE];
+    size_t i;
+    uint32_t off;
+    int rc;
+    
+    if (file->size > IDX_NONE - 1)
+	return;
     
-    level = find_header(file, buf, sizeof(buf), &rdbytes);
+    tmpname = malloc(strlen(file->idx_name) + 8);
+    if (!tmpname) {
+	dico_log(L_ERR, 0, "not enough memory");
+	return;
+    }
+    strcat(strcpy(tmpname, file->idx_name), ".XXXXXX");
+    fd = mkstemp(tmpname);
+    if (fd == -1) {
+	dico_log(L_WARN, errno, _("cannot create index file %s"),
+		 file->idx_name);
+	free(tmpname);
+	return;
+    }
+    fchmod(fd, 0644);
+    fp = fdopen(fd, "w");
+    if (!fp) {
+	dico_log(L_WARN, errno, _("cannot create index file %s"),
+		 file->idx_name);
+	close(fd);
+	unlink(tmpname);
+	free(tmpname);
+	return;
+    }
 
-    if (level == 0)
-	return NULL;
+    memcpy(hdr, IDX_MAGIC, IDX_MAGIC_LEN);
+    idx_put64(hdr + IDX_MAGIC_LEN, IDX_SIZE, file->size);
+    idx_put64(hdr + IDX_MAGIC_LEN, IDX_MTIME, file->mtime);
+    idx_put(hdr + IDX_MAGIC_LEN, IDX_MTIME_NS, file->mtime_ns);
+    idx_put64(hdr + IDX_MAGIC_LEN, IDX_INODE, file->ino);
+    idx_put(hdr + IDX_MAGIC_LEN, IDX_COUNT, file->count);
+    for (i = 0, off = 0; i < file->count; i++)
+	off += file->index[i].length + 1;
+    idx_put(hdr + IDX_MAGIC_LEN, IDX_POOLSIZE, off);
+    for (i = 0; i < META_MAX; i++) {
+	struct entry *ep = outline_meta(file, i);
+	idx_put(hdr + IDX_MAGIC_LEN, IDX_META + 2 * i,
+		ep ? ep->offset : IDX_NONE);
+	idx_put(hdr + IDX_MAGIC_LEN, IDX_META + 2 * i + 1,
+		ep ? ep->size : 0);
+    }
+    fwrite(hdr, sizeof(hdr), 1, fp);
+
+    for (i = 0, off = 0; i < file->count; i++) {
+	struct entry *ep = &file->index[i];
+	idx_put(rec, IDX_ENT_WORD, off);
+	idx_put(rec, IDX_ENT_LENGTH, ep->length);
+	idx_put(rec, IDX_ENT_WORDLEN, ep->wordlen);
+	idx_put(rec, IDX_ENT_OFFSET, ep->offset);
+	idx_put(rec, IDX_ENT_SIZE, ep->size);
+	fwrite(rec, sizeof(rec), 1, fp);
+	off += ep->length + 1;
+    }
+    for (i = 0; i < file->count; i++)
+	fwrite(file->index[i].word, file->index[i].length + 1, 1, fp);
+
+    rc = ferror(fp);
+    if (fclose(fp) || rc) {
+	dico_log(L_WARN, errno, _("error writing index file %s"),
+		 file->idx_name);
+	unlink(tmpname);
+    } else if (rename(tmpname, file->idx_name)) {
+	dico_log(L_WARN, errno, _("cannot rename %s to %s"),
+		 tmpname, file->idx_name);
+	unlink(tmpname);
+    }
+    free(tmpname);
+}
 
-    *plevel = level;
-    for (p = buf + level; *p && isspace(*p); p++) 
-	;
+
+/* Loading and reloading */
 
-    len = trimws(p);
+static void
+outline_free_data(struct outline_file *file)
+{
+    size_t i;
 
-    ep = alloc_entry(p, len);
-    if (!ep)
-	return NULL;
+    if (file->suf_index) {
+	for (i = 0; i < file->count; i++)
+	    free(file->suf_index[i].word);
+	free(file->suf_index);
+	file->suf_index = NULL;
+    }
+    free(file->index);
+    file->index = NULL;
+    file->count = 0;
+    free(file->runs);
+    file->runs = NULL;
+    dico_search_index_free(file->search);
+    file->search = NULL;
+    free(file->pool);
+    file->pool = NULL;
+    for (i = 0; i < META_MAX; i++) {
+	free(file->meta_text[i]);
+	file->meta_text[i] = NULL;
+    }
+    if (file->idx_base) {
+	munmap(file->idx_base, file->idx_size);
+	file->idx_base = NULL;
+    }
+    if (file->base) {
+	munmap(file->base, file->size);
+	file->base = NULL;
+    }
+}
+
+/* Map the database file and load its index, rebuilding it if
+   necessary. */
+static int
+outline_load(struct outline_file *file)
+{
+    int fd;
+    struct stat st;
+    int i;
+    
+    fd = open(file->name, O_RDONLY);
+    if (fd == -1) {
+	dico_log(L_ERR, errno, _("cannot open file %s"), file->name);
+	return 1;
+    }
+    if (fstat(fd, &st)) {
+	dico_log(L_ERR, errno, _("cannot stat file %s"), file->name);
+	close(fd);
+	return 1;
+    }
+    file->dev = st.st_dev;
+    file->ino = st.st_ino;
+    file->mtime = st.st_mtime;
+    file->mtime_ns = ST_MTIME_NS(st);
+    file->size = st.st_size;
+    if (file->size) {
+	file->base = mmap(NULL, file->size, PROT_READ, MAP_SHARED, fd, 0);
+	if (file->base == MAP_FAILED) {
+	    dico_log(L_ERR, errno, _("cannot map file %s"), file->name);
+	    file->base = NULL;
+	    close(fd);
+	    return 1;
+	}
+    }
+    close(fd);
+
+    for (i = 0; i < META_MAX; i++) {
+	memset(&file->meta[i], 0, sizeof(file->meta[i]));
+	file->meta[i].offset = -1;
+    }
+    
+    if (!file->idx_name || outline_read_index(file)) {
+	if (outline_scan(file)) {
+	    outline_free_data(file);
+	    return 1;
+	}
+	if (file->idx_name)
+	    outline_write_index(file);
+    }
+
+    /* Keep the chapters in memory, so that the callbacks returning them
+       never access the mapping, which may be stale by then. */
+    for (i = 0; i < META_MAX; i++) {
+	struct entry *ep = outline_meta(file, i);
+	if (ep) {
+	    char *p = malloc(ep->size + 1);
+	    if (!p) {
+		dico_log(L_ERR, 0, "not enough memory");
+		outline_free_data(file);
+		return 1;
+	    }
+	    memcpy(p, file->base + ep->offset, ep->size);
+	    p[ep->size] = 0;
+	    file->meta_text[i] = p;
+	}
+    }
+    return 0;
+}
 
-    ep->offset = skipws(file, buf, sizeof(buf));
+static void
+outline_search_init(struct outline_file *file)
+{
+    file->search = dico_search_index_create(file->count, entry_word, file,
+					    DICO_SEARCH_CI);
+    if (!file->search)
+	dico_log(L_WARN, errno, _("%s: cannot build search index"),
+		 file->name);
+}
 
-    find_header(file, buf, sizeof(buf), &rdbytes);
-    fseek(file->fp, -(off_t)rdbytes, SEEK_CUR);
-    ep->size = ftell(file->fp) - ep->offset;
+#ifdef HAVE_SYS_INOTIFY_H
+/* Watch the directory rather than the file itself, so that replacing
+   the file by rename is noticed as well. */
+static void
+outline_watch_init(struct outline_file *file)
+{
+    char *dir, *p;
     
-    return ep;
+    file->watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (file->watch_fd == -1) {
+	dico_log(L_WARN, errno, _("%s: cannot initialize inotify"),
+		 file->name);
+	return;
+    }
+    p = strrchr(file->name, '/');
+    if (p)
+	dir = p == file->name ? strdup("/")
+	                      : strndup(file->name, p - file->name);
+    else
+	dir = strdup(".");
+    if (!dir
+	|| inotify_add_watch(file->watch_fd, dir,
+			     IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE
+			     | IN_DELETE | IN_ATTRIB) == -1) {
+	dico_log(L_WARN, errno, _("%s: cannot watch directory"),
+		 file->name);
+	close(file->watch_fd);
+	file->watch_fd = -1;
+    }
+    free(dir);
 }
 
-
+/* Return true if the database file might have changed since the last
+   call.  Dicod serves each connection in a subprocess, which inherits
+   the database refreshed by the master just before the fork.  Only the
+   master creates the inotify descriptor (if CREATE is set), so that
+   there is a single instance per database.  Other processes don't read
+   from it, lest they steal its events, and always stat the file
+   instead. */
+static int
+outline_watch_check(struct outline_file *file, int create)
+{
+    char buf[4096];
+    int changed = 0;
+    
+    if (file->watch_pid != getpid()) {
+	if (create && file->watch_pid == 0) {
+	    file->watch_pid = getpid();
+	    outline_watch_init(file);
+	}
+	return 1;
+    }
+    if (file->watch_fd == -1)
+	return 1;
+    while (read(file->watch_fd, buf, sizeof(buf)) > 0)
+	changed = 1;
+    return changed;
+}
+#else
+# define outline_watch_check(file, create) 1
+#endif
+
+/* Reload the database if its file was modified or replaced.  CREATE
+   is set when called from the master.  On failure, the old data remain
+   in use. */
+static void
+outline_check_reload(struct outline_file *file, int create)
+{
+    struct stat st;
+    struct outline_file tmp;
+
+    if (!file->watch || !outline_watch_check(file, create))
+	return;
+    if (stat(file->name, &st)
+	|| (st.st_dev == file->dev
+	    && st.st_ino == file->ino
+	    && st.st_size == file->size
+	    && st.st_mtime == file->mtime
+	    && ST_MTIME_NS(st) == file->mtime_ns))
+	return;
+
+    tmp = *file;
+    tmp.base = tmp.idx_base = tmp.pool = NULL;
+    tmp.count = 0;
+    tmp.index = tmp.suf_index = NULL;
+    tmp.runs = NULL;
+    tmp.search = NULL;
+    memset(tmp.meta_text, 0, sizeof(tmp.meta_text));
+    if (outline_load(&tmp) == 0) {
+	dico_log(L_INFO, 0, _("%s: database reloaded"), file->name);
+	outline_free_data(file);
+	*file = tmp;
+	outline_search_init(file);
+    }
+}
+
+
 enum result_type {
     result_match,
     result_match_list,
@@ -247,16 +804,6 @@ outline_init(int argc, char **argv)
     return 0;
 }
 
-
-static int
-compare_entry(const void *a, const void *b)
-{
-    const struct entry *epa = a;
-    const struct entry *epb = b;
-    compare_count++;
-    return utf8_strcasecmp(epa->word, epb->word);
-}
-
 
 static void
 revert_word(char *dst, const char *src, size_t len)
@@ -310,11 +857,15 @@ static int
 exact_match(struct outline_file *file, const char *word, struct result *res)
 {
     struct entry x, *ep;
+    size_t start = 0, end = file->count;
+    
     x.word = (char*) word;
     x.length = strlen(word);
     x.wordlen = utf8_strlen(word);
-    ep = bsearch(&x, file->index, file->count, sizeof(file->index[0]),
-		 compare_entry);
+    if (file->search)
+	dico_search_index_range(file->search, word, 0, &start, &end);
+    ep = bsearch(&x, file->index + start, end - start,
+		 sizeof(file->index[0]), compare_entry);
     if (ep) {
 	res->type = result_match;
 	res->v.ep = ep;
@@ -356,7 +907,7 @@ prefix_match(struct outline_file *file, const char *word, struct result *res)
 	    count++;
 	res->type = result_match;
 	res->v.ep = p + 1;
-	res->count = count;
+	res->count = dico_result_limit_clip(count);
 	return 0;
     }
     return 1;
@@ -423,8 +974,11 @@ suffix_match(struct outline_file *file, const char *word, struct result *res)
 		    epp[i] = p[i].peer;
 		qsort(epp, count, sizeof(epp[0]), compare_entry_ptr);
 	    
-		for (i = 0; i < count; i++)
+		for (i = 0; i < count; i++) {
+		    if (dico_result_limit_reached(dico_list_count(res->v.list)))
+			break;
 		    dico_list_append(res->v.list, epp[i]);
+		}
 		res->count = dico_list_count(res->v.list);
 		rc = 0;
 	    }
@@ -440,22 +994,13 @@ suffix_match(struct outline_file *file, const char *word, struct result *res)
 static int
 outline_free_db (dico_handle_t hp)
 {
-    size_t i;
     struct outline_file *file = (struct outline_file *) hp;
-    
-    fclose(file->fp);
+
+    outline_free_data(file);
+    if (file->watch_fd != -1)
+	close(file->watch_fd);
     free(file->name);
-    free(file->info_entry);
-    free(file->descr_entry);
-    free(file->lang_entry);
-    free(file->mime_entry);
-    for (i = 0; i < file->count; i++) {
-	free(file->index[i].word);
-	if (file->suf_index)
-	    free(file->suf_index[i].word);
-    }
-    free(file->index);
-    free(file->suf_index);
+    free(file->idx_name);
     free(file);
     return 0;
 }
@@ -463,103 +1008,58 @@ outline_free_db (dico_handle_t hp)
 static dico_handle_t
 outline_init_db(const char *dbname, int argc, char **argv)
 {
-    FILE *fp;
     struct outline_file *file;
-    dico_list_t list;
-    struct entry *ep;
-    int level;
-    int state;
-    size_t i, count;
-    dico_iterator_t itr;
-
-    if (argc != 2) {
-	dico_log(L_ERR, 0, _("outline_open: wrong number of arguments"));
+    int idx;
+    char *idx_name = NULL;
+    int watch = 1;
+    
+    struct dico_option init_db_option[] = {
+	{ DICO_OPTSTR(index-file), dico_opt_string, &idx_name },
+	{ DICO_OPTSTR(watch), dico_opt_bool, &watch },
+	{ NULL }
+    };
+
+    if (dico_parseopt(init_db_option, argc, argv, DICO_PARSEOPT_PERMUTE,
+		      &idx))
 	return NULL;
-    }
+    argc -= idx;
+    argv += idx;
     
-    fp = fopen(argv[1], "r");
-    if (!fp) {
-	dico_log(L_ERR, errno, _("cannot open file %s"), argv[1]);
+    if (argc != 1) {
+	dico_log(L_ERR, 0, _("outline_open: wrong number of arguments"));
+	free(idx_name);
 	return NULL;
     }
+    
     file = malloc(sizeof(*file));
     if (!file) {
 	dico_log(L_ERR, 0, "not enough memory");
-	fclose(fp);
+	free(idx_name);
 	return NULL;
     }
 
     memset(file, 0, sizeof(*file));
-    file->name = strdup(argv[1]);
-    file->fp = fp;
-    
-    list = dico_list_create();
-    if (!list) {
+    file->watch = watch;
+    file->watch_fd = -1;
+    file->name = strdup(argv[0]);
+    if (!file->name) {
 	dico_log(L_ERR, 0, "not enough memory");
-	fclose(fp);
+	free(idx_name);
 	free(file);
 	return NULL;
     }
+    file->idx_name = idx_name;
 
-    state = STATE_INITIAL;
-    while ((ep = read_entry(file, &level))) {
-	switch (state) {
-	case STATE_DICT:
-	    if (level == 2) {
-		dico_list_append(list, ep);
-		break;
-	    } else if (level == 1) {
-		state = STATE_INITIAL;
-		/* FALL THROUGH */
-	    } else {
-		free(ep);
-		break;
-	    }
-	    
-	case STATE_INITIAL:
-	    if (level == 1) {
-		if (strcasecmp(ep->word, "info") == 0) {
-		    file->info_entry = ep;
-		    break;
-		} else if (strcasecmp(ep->word, "description") == 0) {
-		    file->descr_entry = ep;
-		    break;
-		} else if (strcasecmp(ep->word, "languages") == 0) {
-		    file->lang_entry = ep;
-		    break;
-		} else if (strcasecmp(ep->word, "mime") == 0) {
-		    file->mime_entry = ep;
-		    break;
-		} else if (strcasecmp(ep->word, "dictionary") == 0)
-		    state = STATE_DICT;
-	    }
-	    free(ep);
-	    break;
-	}
-    }
-
-    file->count = count = dico_list_count(list);
-    file->index = calloc(count, sizeof(file->index[0]));
-    if (!file->index) {
-	dico_log(L_ERR, 0, "not enough memory");
+    if (outline_load(file)) {
 	outline_free_db((dico_handle_t)file);
 	return NULL;
     }
-
-    itr = dico_list_iterator(list);
-    for (i = 0, ep = dico_iterator_first(itr); ep;
-	 i++, ep = dico_iterator_next(itr)) {
-	file->index[i] = *ep;
-	free(ep);
-    }
-    dico_iterator_destroy(&itr);
-    dico_list_destroy(&list);
-    qsort(file->index, count, sizeof(file->index[0]), compare_entry);
+    outline_search_init(file);
     
     return (dico_handle_t) file;
 }
 
-
+
 static inline int
 isws(int c)
 {
@@ -567,14 +1067,13 @@ isws(int c)
 }
 
 static char *
-read_buf(struct outline_file *file, struct entry *ep, int trim)
+read_buf(const char *text, int trim)
 {
-    size_t size;
-    char *buf = malloc(ep->size + 1);
+    size_t size = strlen(text);
+    char *buf = malloc(size + 1);
     if (!buf)
 	return NULL;
-    fseek(file->fp, ep->offset, SEEK_SET);
-    size = fread(buf, 1, ep->size, file->fp);
+    memcpy(buf, text, size);
     if (trim && size > 0 && buf[size-1] == '\n') {
 	while (size > 0 && buf[size-1] == '\n') {
 	    --size;
@@ -591,8 +1090,10 @@ static char *
 outline_info(dico_handle_t hp)
 {
     struct outline_file *file = (struct outline_file *) hp;
-    if (file->info_entry) 
-	return read_buf(file, file->info_entry, 0);
+    char *text = file->meta_text[META_INFO];
+
+    if (text) 
+	return read_buf(text, 0);
     return NULL;
 }
 
@@ -600,10 +1101,12 @@ static char *
 outline_descr(dico_handle_t hp)
 {
     struct outline_file *file = (struct outline_file *) hp;
-    if (file->descr_entry) { 
-	char *buf = read_buf(file, file->descr_entry, 0);
-	char *p = strchr(buf, '\n');
-	if (p)
+    char *text = file->meta_text[META_DESCR];
+
+    if (text) { 
+	char *buf = read_buf(text, 0);
+	char *p;
+	if (buf && (p = strchr(buf, '\n')) != NULL)
 	    *p = 0;
 	return buf;
     }
@@ -614,15 +1117,15 @@ static int
 outline_lang(dico_handle_t hp, dico_list_t list[2])
 {
     struct outline_file *file = (struct outline_file *) hp;
+    char *text = file->meta_text[META_LANG];
 
     list[0] = list[1] = NULL;
-    if (file->lang_entry) {
+    if (text) {
 	int n = 0;
 	struct wordsplit ws;
-	char *buf = read_buf(file, file->lang_entry, 0);
 
 	ws.ws_delim = "\n";
-	if (wordsplit(buf, &ws, WRDSF_DEFFLAGS|WRDSF_DELIM) == 0) {
+	if (wordsplit(text, &ws, WRDSF_DEFFLAGS|WRDSF_DELIM) == 0) {
 	    if (ws.ws_wordc) {
 		int i;
 		for (i = 0; i < ws.ws_wordc; i++) {
@@ -688,13 +1191,18 @@ outline_match_all(dico_handle_t hp, dico_strategy_t strat, const char *word)
     }
     
     for (i = 0; i < file->count; i++) {
-	if (dico_key_match(&key, file->index[i].word))
+	if (dico_budget_check())
+	    break;
+	if (dico_key_match(&key, file->index[i].word)) {
+	    if (dico_result_limit_reached(dico_list_count(list)))
+		break;
 	    dico_list_append(list, &file->index[i]);
+	}
     }
 
     dico_key_deinit(&key);
     
-    compare_count = file->count;
+    compare_count = i;
 	
     count = dico_list_count(list);
     if (count == 0) {
@@ -713,10 +1221,93 @@ outline_match_all(dico_handle_t hp, dico_strategy_t strat, const char *word)
     return (dico_result_t) res;
 }
 
+static int
+compare_entry_uniq(const void *a, const void *b, void *closure)
+{
+    const struct entry *epa = a;
+    const struct entry *epb = b;
+    return utf8_strcasecmp(epa->word, epb->word);
+}
+
+/* Paginated prefix search.  Locate the prefix range with a binary
+   search and use the run index to skip the requested number of unique
+   headwords. */
+static dico_result_t
+outline_match_page(struct outline_file *file, struct dico_prefix_page *pg)
+{
+    struct entry x, *ep, *end = file->index + file->count;
+    int any = pg->prefix[0] == 0;
+    dico_list_t list;
+    struct result *res;
+
+    compare_count = 0;
+    if (any)
+	ep = file->index;
+    else {
+	x.word = (char*) pg->prefix;
+	x.length = strlen(pg->prefix);
+	x.wordlen = utf8_strlen(pg->prefix);
+	ep = bsearch(&x, file->index, file->count, sizeof(file->index[0]),
+		     compare_prefix);
+	if (!ep)
+	    return NULL;
+	while (ep > file->index && compare_prefix(&x, ep - 1) == 0)
+	    ep--;
+    }
+
+    if (pg->skip) {
+	if (!file->runs) {
+	    file->runs = dico_run_index_create(file->index, file->count,
+					       sizeof(file->index[0]),
+					       compare_entry_uniq, NULL);
+	    if (!file->runs)
+		return NULL;
+	}
+	ep = file->index + dico_run_index_seek(file->runs, file->count,
+					       ep - file->index, pg->skip);
+    }
+
+    list = dico_list_create();
+    if (!list) {
+	dico_log(L_ERR, 0, _("outline_match_page: not enough memory"));
+	return NULL;
+    }
+    dico_list_set_comparator(list, compare_entry_uniq, NULL);
+    dico_list_set_flags(list, DICO_LIST_COMPARE_TAIL);
+    
+    for (; ep < end && (any || compare_prefix(&x, ep) == 0); ep++) {
+	if (dico_prefix_page_full(pg, dico_list_count(list)))
+	    break;
+	dico_list_append(list, ep);
+    }
+
+    if (dico_list_count(list) == 0) {
+	dico_list_destroy(&list);
+	return NULL;
+    }
+
+    res = malloc(sizeof(*res));
+    if (!res) {
+	dico_list_destroy(&list);
+	return NULL;
+    }
+    res->file = file;
+    res->type = result_match_list;
+    res->count = dico_list_count(list);
+    res->v.list = list;
+    res->compare_count = compare_count;
+    return (dico_result_t) res;
+}
+
 static dico_result_t
 outline_match(dico_handle_t hp, const dico_strategy_t strat, const char *word)
 {
     entry_match_t match = find_matcher(strat->name);
+    struct dico_prefix_page pg;
+
+    outline_check_reload((struct outline_file *) hp, 0);
+    if (dico_prefix_page_parse(strat, word, &pg) == 0)
+	return outline_match_page((struct outline_file *) hp, &pg);
     if (match)
 	return outline_match0(hp, match, word);
     else if (strat->sel) 
@@ -730,6 +1321,7 @@ outline_define(dico_handle_t hp, const char *word)
     struct outline_file *file = (struct outline_file *) hp;
     struct result *res;
 
+    outline_check_reload(file, 0);
     compare_count = 0;
     res = malloc(sizeof(*res));
     if (!res)
@@ -748,21 +1340,7 @@ outline_define(dico_handle_t hp, const char *word)
 static void
 printdef(dico_stream_t str, struct outline_file *file, const struct entry *ep)
 {
-    FILE *fp = file->fp;
-    size_t size = ep->size;
-    char buf[128];
-    
-    fseek(fp, ep->offset, SEEK_SET);
-    while (size) {
-	size_t rdsize = size;
-	if (rdsize > sizeof(buf))
-	    rdsize = sizeof(buf);
-	rdsize = fread(buf, 1, rdsize, fp);
-	if (rdsize == 0)
-	    break;
-	dico_stream_write(str, buf, rdsize);
-	size -= rdsize;
-    }
+    dico_stream_write(str, file->base + ep->offset, ep->size);
 }
 
 static int
@@ -816,11 +1394,19 @@ static char *
 outline_db_mime_header(dico_handle_t hp)
 {
     struct outline_file *file = (struct outline_file *) hp;
-    if (file->mime_entry) 
-	return read_buf(file, file->mime_entry, 1);
+    char *text = file->meta_text[META_MIME];
+
+    if (text) 
+	return read_buf(text, 1);
     return NULL;
 }
 
+static void
+outline_refresh(dico_handle_t hp)
+{
+    outline_check_reload((struct outline_file *) hp, 1);
+}
+
 struct dico_database_module DICO_EXPORT(outline, module) = {
     .dico_version = DICO_MODULE_VERSION,
     .dico_capabilities = DICO_CAPA_NONE,
@@ -836,6 +1422,7 @@ struct dico_database_module DICO_EXPORT(outline, module) = {
     .dico_result_count = outline_result_count,
     .dico_compare_count = outline_compare_count,
     .dico_free_result = outline_free_result,
-    .dico_db_mime_header = outline_db_mime_header
+    .dico_db_mime_header = outline_db_mime_header,
+    .dico_db_refresh = outline_refresh
 };
     
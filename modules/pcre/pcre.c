@@ -17,30 +17,32 @@
 #include <config.h>
 #include <dico.h>
 #include <stdlib.h>
+#include <string.h>
 #include <ctype.h>
 #include <errno.h>
 #include <appi18n.h>
-#include <pcre.h>
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
 
 struct dico_pcre_flag
 {
     int c;
-    int flag;
+    uint32_t flag;
 };
 
 static struct dico_pcre_flag flagtab[] = {
-    { 'a', PCRE_ANCHORED }, /* Force pattern anchoring */
-    { 'e', PCRE_EXTENDED }, /* Ignore whitespace and # comments */
-    { 'i', PCRE_CASELESS }, /* Do caseless matching */
-    { 'G', PCRE_UNGREEDY }, /* Invert greediness of quantifiers */
+    { 'a', PCRE2_ANCHORED }, /* Force pattern anchoring */
+    { 'e', PCRE2_EXTENDED }, /* Ignore whitespace and # comments */
+    { 'i', PCRE2_CASELESS }, /* Do caseless matching */
+    { 'G', PCRE2_UNGREEDY }, /* Invert greediness of quantifiers */
     { 0 },
 };
 
 static int
-pcre_flag(int c, int *pflags)
+pcre_flag(int c, uint32_t *pflags)
 {
     struct dico_pcre_flag *p;
-    
+
     for (p = flagtab; p->c; p++) {
 	if (p->c == c) {
 	    *pflags |= p->flag;
@@ -52,16 +54,76 @@ pcre_flag(int c, int *pflags)
     }
     return 1;
 }
-    
-static pcre *
-compile_pattern(const char *pattern)
+
+/* Use JIT compilation, if available */
+static int pcre_jit = 1;
+/* Number of compiled patterns to keep in the cache */
+static long pcre_cache_size = 16;
+
+static pcre2_compile_context *compile_context;
+
+/* A compiled pattern.  The structure is shared between the pattern
+   cache and the keys using it. */
+struct pcre_pattern {
+    pcre2_code *code;               /* Compiled pattern */
+    struct dico_regex_prefilter pf; /* Prefilter */
+    unsigned refcnt;                /* Reference count */
+};
+
+/* Per-key data */
+struct pcre_data {
+    struct pcre_pattern *pat;
+    pcre2_match_data *md;
+};
+
+/* Most recently used patterns, keyed by the search word.  Each pattern
+   counts as one unit against the cache size. */
+static dico_cache_t pcre_cache;
+
+static void
+pattern_unref(struct pcre_pattern *pat)
+{
+    if (--pat->refcnt == 0) {
+	pcre2_code_free(pat->code);
+	dico_regex_prefilter_free(&pat->pf);
+	free(pat);
+    }
+}
+
+static void
+pattern_cache_free(void *data)
+{
+    pattern_unref(data);
+}
+
+/* Initialize the prefilter PF for PATTERN compiled with CFLAGS. */
+static int
+init_prefilter(struct dico_regex_prefilter *pf, const char *pattern,
+	       uint32_t cflags)
+{
+    int flags = DICO_REGEX_PCRE;
+
+    if (cflags & PCRE2_EXTENDED) {
+	/* Whitespace and comments are not analyzed */
+	memset(pf, 0, sizeof(*pf));
+	return 0;
+    }
+    if (cflags & PCRE2_CASELESS)
+	flags |= DICO_REGEX_ICASE;
+    if (cflags & PCRE2_ANCHORED)
+	flags |= DICO_REGEX_ANCHORED;
+    return dico_regex_prefilter_init(pf, pattern, flags);
+}
+
+static pcre2_code *
+compile_pattern(const char *pattern, struct dico_regex_prefilter *pf)
 {
-    int cflags = PCRE_UTF8|PCRE_NEWLINE_ANY;
-    const char *error;
-    int error_offset;
+    uint32_t cflags = PCRE2_UTF;
+    int error;
+    PCRE2_SIZE error_offset;
     char *tmp = NULL;
-    pcre *pre;
-	
+    pcre2_code *code;
+
     if (pattern[0] == '/') {
 	size_t len;
 	char *p;
@@ -81,7 +143,7 @@ compile_pattern(const char *pattern)
 		return NULL;
 	    }
 	}
-    
+
 	tmp = malloc(len + 1);
 	if (!tmp)
 	    return NULL;
@@ -89,14 +151,51 @@ compile_pattern(const char *pattern)
 	tmp[len] = 0;
 	pattern = tmp;
     }
-    pre = pcre_compile(pattern, cflags, &error, &error_offset, 0);
-    if (!pre) {
-	dico_log(L_ERR, 0, 
-		 _("pcre_compile(\"%s\") failed at offset %d: %s"),
-		 pattern, error_offset, error);
+    code = pcre2_compile((PCRE2_SPTR) pattern, PCRE2_ZERO_TERMINATED,
+			 cflags, &error, &error_offset, compile_context);
+    if (!code) {
+	PCRE2_UCHAR errbuf[256];
+	pcre2_get_error_message(error, errbuf, sizeof(errbuf));
+	dico_log(L_ERR, 0,
+		 _("pcre2_compile(\"%s\") failed at offset %lu: %s"),
+		 pattern, (unsigned long) error_offset, errbuf);
+    } else if (init_prefilter(pf, pattern, cflags)) {
+	DICO_LOG_MEMERR();
+	pcre2_code_free(code);
+	code = NULL;
+    } else if (pcre_jit) {
+	/* If JIT is not supported, the interpreter is used */
+	pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
     }
     free(tmp);
-    return pre;
+    return code;
+}
+
+/* Return the compiled pattern for WORD, compiling it if it is not
+   found in the cache.  The caller must unreference the returned
+   pattern when no longer needed. */
+static struct pcre_pattern *
+pattern_get(const char *word)
+{
+    struct pcre_pattern *pat;
+
+    pat = dico_cache_lookup(pcre_cache, word, strlen(word));
+    if (!pat) {
+	pat = calloc(1, sizeof(*pat));
+	if (!pat) {
+	    DICO_LOG_MEMERR();
+	    return NULL;
+	}
+	pat->code = compile_pattern(word, &pat->pf);
+	if (!pat->code) {
+	    free(pat);
+	    return NULL;
+	}
+	if (dico_cache_insert(pcre_cache, word, strlen(word), pat, 1) == 0)
+	    pat->refcnt++;
+    }
+    pat->refcnt++;
+    return pat;
 }
 
 static int
@@ -104,23 +203,41 @@ pcre_sel(int cmd, dico_key_t key, const char *dict_word)
 {
     int rc = 0;
     char const *word = key->word;
-    pcre *pre = key->call_data;
+    struct pcre_data *pd = key->call_data;
 
     switch (cmd) {
     case DICO_SELECT_BEGIN:
-	pre = compile_pattern(word);
-	if (!pre)
+	pd = malloc(sizeof(*pd));
+	if (!pd)
+	    return 1;
+	pd->pat = pattern_get(word);
+	if (!pd->pat) {
+	    free(pd);
+	    return 1;
+	}
+	/* A single ovector pair suffices: only the fact of the match
+	   matters. */
+	pd->md = pcre2_match_data_create(1, NULL);
+	if (!pd->md) {
+	    DICO_LOG_MEMERR();
+	    pattern_unref(pd->pat);
+	    free(pd);
 	    return 1;
-	key->call_data = pre;
+	}
+	key->call_data = pd;
+	key->prefix = pd->pat->pf.prefix;
 	break;
 
     case DICO_SELECT_RUN:
-	rc = pcre_exec(pre, 0, dict_word, strlen(dict_word), 0, 0,
-		       NULL, 0) >= 0;
+	rc = dico_regex_prefilter_match(&pd->pat->pf, dict_word)
+	      && pcre2_match(pd->pat->code, (PCRE2_SPTR) dict_word,
+			     PCRE2_ZERO_TERMINATED, 0, 0, pd->md, NULL) >= 0;
 	break;
-	
+
     case DICO_SELECT_END:
-	pcre_free(pre);
+	pcre2_match_data_free(pd->md);
+	pattern_unref(pd->pat);
+	free(pd);
 	break;
     }
     return rc;
@@ -135,6 +252,30 @@ static struct dico_strategy pcre_strat = {
 static int
 pcre_init(int argc, char **argv)
 {
+    struct dico_option init_option[] = {
+	{ DICO_OPTSTR(jit), dico_opt_bool, &pcre_jit },
+	{ DICO_OPTSTR(cache-size), dico_opt_long, &pcre_cache_size },
+	{ NULL }
+    };
+
+    if (dico_parseopt(init_option, argc, argv, 0, NULL))
+	return 1;
+
+    compile_context = pcre2_compile_context_create(NULL);
+    if (!compile_context) {
+	DICO_LOG_MEMERR();
+	return 1;
+    }
+    pcre2_set_newline(compile_context, PCRE2_NEWLINE_ANY);
+
+    if (pcre_cache_size > 0) {
+	pcre_cache = dico_cache_create(pcre_cache_size, pattern_cache_free);
+	if (!pcre_cache) {
+	    DICO_LOG_MEMERR();
+	    return 1;
+	}
+    }
+
     dico_strategy_add(&pcre_strat);
     return 0;
 }
@@ -144,4 +285,3 @@ struct dico_database_module DICO_EXPORT(pcre, module) = {
     DICO_CAPA_NODB,
     pcre_init,
 };
-
@@ -32,17 +32,15 @@ substr_sel(int cmd, struct dico_key *key, const char *dict_word)
     
     switch (cmd) {
     case DICO_SELECT_BEGIN:
-	if (utf8_mbstr_to_wc(key->word, &sample, NULL))
+	if (utf8_casefold_wc(key->word, &sample, NULL))
 	    return 1;
-	utf8_wc_strupper(sample);
 	key->call_data = sample;
 	break;
 	
     case DICO_SELECT_RUN:
 	sample = key->call_data;
-	if (utf8_mbstr_to_wc(dict_word, &tmp, NULL))
+	if (utf8_casefold_wc(dict_word, &tmp, NULL))
 	    return 0;
-	utf8_wc_strupper(tmp);
 	res = !!utf8_wc_strstr(tmp, sample);
 	free(tmp);
 	return res;
@@ -55,9 +53,10 @@ substr_sel(int cmd, struct dico_key *key, const char *dict_word)
 }
 
 static struct dico_strategy substr_strat = {
-    "substr",
-    "Match a substring anywhere in the headword",
-    substr_sel
+    .name = "substr",
+    .descr = "Match a substring anywhere in the headword",
+    .sel = substr_sel,
+    .flags = DICO_STRAT_SUBSTR
 };
 
 static int
@@ -16,8 +16,10 @@
 
 #include <config.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <sys/wait.h>
 #include <dico.h>
 #include <errno.h>
@@ -26,12 +28,23 @@
 
 #define WNDB_MERGE_DEFS 0x01
 
+/* Rendered definitions of a word.  The Nth definition occupies the
+   bytes from off[n] to off[n+1] of text. */
+struct wn_defs {
+    size_t size;                  /* Size of the allocated block */
+    size_t count;                 /* Number of definitions */
+    size_t len;                   /* Length of the text */
+    size_t *off;                  /* Offsets of the definitions */
+    char *text;                   /* Rendered text */
+};
+
 struct wndb {
     char *dbname;
     int flags;
     int pos;
     int optc;
     struct wn_option **optv;
+    dico_cache_t cache;           /* Cache of rendered definitions */
 };
 
 static int
@@ -45,6 +58,7 @@ static int
 wn_free_db(dico_handle_t hp)
 {
     struct wndb *wndb = (struct wndb *)hp;
+    dico_cache_destroy(&wndb->cache);
     free(wndb->dbname);
     free(wndb->optv);
     free(wndb);
@@ -53,6 +67,7 @@ wn_free_db(dico_handle_t hp)
 
 static void wn_register_strategies(void);
 static void wn_free_result(dico_result_t rp);
+static int wn_index_init(void);
 
 static int
 wn_init(int argc, char **argv)
@@ -79,6 +94,8 @@ wn_init(int argc, char **argv)
 	dico_log(L_ERR, 0, _("cannot open wordnet database"));
 	return 1;
     }
+    if (wn_index_init())
+	return 1;
 
     wn_register_strategies();
 
@@ -196,6 +213,7 @@ wn_init_db(const char *dbname, int argc, char **argv)
     struct wn_option **optv;
     int optc;
     int flags = 0;
+    long cache_size = 512 * 1024;
     static struct wn_option overview[2] = {
 	{ "overview", OVERVIEW, PM_ALL, "Overview", NULL, _wn_print_overview },
 	{ "overview", OVERVIEW, PM_ALL, "Overview", NULL, _wn_print_definition }
@@ -206,6 +224,7 @@ wn_init_db(const char *dbname, int argc, char **argv)
 	{ DICO_OPTSTR(pos), dico_opt_enum, &pos, { .enumstr = pos_choice } },
 	{ DICO_OPTSTR(merge-defs), dico_opt_bool, &flags,
 	  { .value = WNDB_MERGE_DEFS } },
+	{ DICO_OPTSTR(cache-size), dico_opt_long, &cache_size },
 	{ NULL }
     };
 
@@ -259,6 +278,14 @@ wn_init_db(const char *dbname, int argc, char **argv)
     wndb->pos = pos_trans[pos];
     wndb->optc = optc;
     wndb->optv = optv;
+    if (cache_size > 0) {
+	wndb->cache = dico_cache_create(cache_size, free);
+	if (!wndb->cache) {
+	    DICO_LOG_ERRNO();
+	    wn_free_db((dico_handle_t)wndb);
+	    return NULL;
+	}
+    }
 
     return (dico_handle_t)wndb;
 }
@@ -289,64 +316,7 @@ wn_lang(dico_handle_t hp, dico_list_t list[2])
     return 0;
 }
 
-struct wordbuf {
-    char *word;
-    size_t len;
-    size_t size;
-};
-#define WORDBUFINC 16
-#define INIT_WORDBUF { NULL, 0, 0 }
-#define wordbuf_start(wb) ((wb)->len=0)
-
-static int
-wordbuf_expand(struct wordbuf *wb, size_t len)
-{
-    if (len >= wb->size) {
-	size_t size = ((len + WORDBUFINC - 1) /  WORDBUFINC ) * WORDBUFINC;
-	char *newword = realloc(wb->word, size);
-	if (!newword) {
-            DICO_LOG_ERRNO();
-	    return 1;
-	}
-	wb->word = newword;
-	wb->size = size;
-    }
-    return 0;
-}
-
-static int
-wordbuf_grow(struct wordbuf *wb, int c)
-{
-    if (wordbuf_expand(wb, wb->len + 1))
-	return 1;
-    wb->word[wb->len++] = c;
-    return 0;
-}
-
-static int
-wordbuf_finish(struct wordbuf *wb)
-{
-    if (wordbuf_expand(wb, wb->len + 1))
-	return 1;
-    wb->word[wb->len] = 0;
-    return 0;
-}
-
-static void
-wordbuf_reverse(struct wordbuf *wb)
-{
-    int i, j;
-
-    if (wb->len == 0)
-	return;
-    for (i = 0, j = wb->len - 1; i < j; i++, j--) {
-	int c = wb->word[j];
-	wb->word[j] = wb->word[i];
-	wb->word[i] = c;
-    }
-}
 
-
 enum result_type {
     result_match,
     result_define
@@ -367,6 +337,7 @@ struct result {
     /* For definitions only: */
     char *searchword;
     dico_list_t rootlist; /* List of root synsets */
+    struct wn_defs *defs; /* Rendered definitions */
 };
 
 static int
@@ -446,12 +417,14 @@ wn_create_define_result(struct wndb *wndb, const char *searchword)
     if (!res->searchword) {
         DICO_LOG_ERRNO();
 	wn_free_result((dico_result_t) res);
+	return NULL;
     }
 
     res->rootlist = dico_list_create();
     if (!res->rootlist) {
         DICO_LOG_ERRNO();
 	wn_free_result((dico_result_t) res);
+	return NULL;
     }
     dico_list_set_free_item(res->rootlist, free_root_synset, NULL);
     
@@ -479,67 +452,279 @@ wn_match_result_add(struct result *res, const char *hw)
     return 0;
 }
 
-static void
-skipeol(FILE *fp)
+/* In-memory headword index.
+
+   The index file of each part of speech is mapped into memory when the
+   module is initialized.  Its headwords, with underscores replaced by
+   spaces, are kept in an array sorted with utf8_strcasecmp, along with
+   the offsets of their lines in the file.  A search index speeds up
+   lookups in the array. */
+
+struct wn_headword {
+    const char *word;           /* Headword */
+    size_t offset;              /* Offset of its line in the index file */
+};
+
+struct wn_index {
+    char *base;                 /* Mapped index file */
+    size_t size;                /* Its size */
+    char *pool;                 /* Storage for headwords */
+    struct wn_headword *hw;     /* Sorted array of headwords */
+    size_t count;               /* Number of elements in hw */
+    dico_search_index_t search; /* Search index */
+};
+
+static struct wn_index wn_index[NUMPARTS + 1];
+
+static int
+compare_headword(const void *a, const void *b, void *closure)
 {
-    int c;
-    while ((c = getc(fp)) != '\n' && c != EOF)
-	;
+    const struct wn_headword *hwa = a;
+    const struct wn_headword *hwb = b;
+    return utf8_strcasecmp(hwa->word, hwb->word);
 }
 
-static void
-skipheader(FILE *fp)
+static const char *
+headword_get(size_t n, void *closure)
 {
-    int c;
+    struct wn_index *idx = closure;
+    return idx->hw[n].word;
+}
 
-    while ((c = getc(fp)) == ' ')
-	skipeol(fp);
-    ungetc(c, fp);
+/* Return the length of the headword in the index line P..END. */
+static size_t
+headword_length(const char *p, const char *end)
+{
+    const char *q = memchr(p, ' ', end - p);
+    return q ? q - p : end - p;
 }
 
 static int
-getword(FILE *fp, struct wordbuf *wb)
+wn_index_load(struct wn_index *idx, int pos)
 {
-    int c;
-    size_t i;
+    int fd = fileno(indexfps[pos]);
+    struct stat st;
+    char *p, *end, *q;
+    size_t count, poolsize;
+
+    if (fstat(fd, &st)) {
+	dico_log(L_ERR, errno, _("cannot stat index file for %s"),
+		 partnames[pos]);
+	return 1;
+    }
+    if (st.st_size == 0)
+	return 0;
+    idx->base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (idx->base == MAP_FAILED) {
+	idx->base = NULL;
+	dico_log(L_ERR, errno, _("cannot map index file for %s"),
+		 partnames[pos]);
+	return 1;
+    }
+    idx->size = st.st_size;
+    end = idx->base + idx->size;
+
+    /* Count headwords, skipping the license header (lines beginning
+       with a space). */
+    count = poolsize = 0;
+    for (p = idx->base; p < end; p = q + 1) {
+	if (!(q = memchr(p, '\n', end - p)))
+	    q = end;
+	if (p == q || *p == ' ')
+	    continue;
+	count++;
+	poolsize += headword_length(p, q) + 1;
+    }
 
-    wordbuf_start(wb);
-    while ((c = getc(fp)) != EOF) {
-	if (c == ' ')
-	    break;
-	if (wordbuf_grow(wb, c))
-	    return -1;
+    idx->hw = calloc(count ? count : 1, sizeof(idx->hw[0]));
+    idx->pool = malloc(poolsize ? poolsize : 1);
+    if (!idx->hw || !idx->pool) {
+	DICO_LOG_MEMERR();
+	return 1;
     }
-    if (wb->len == 0 && c == EOF)
-	return -1;
-    if (wordbuf_finish(wb))
-	return -1;
-    for (i = 0; wb->word[i]; i++)
-	if (wb->word[i] == '_')
-	    wb->word[i] = ' ';
+
+    poolsize = 0;
+    for (p = idx->base; p < end; p = q + 1) {
+	char *word;
+	size_t i, len;
+
+	if (!(q = memchr(p, '\n', end - p)))
+	    q = end;
+	if (p == q || *p == ' ')
+	    continue;
+	len = headword_length(p, q);
+	word = idx->pool + poolsize;
+	for (i = 0; i < len; i++)
+	    word[i] = p[i] == '_' ? ' ' : p[i];
+	word[len] = 0;
+	poolsize += len + 1;
+	idx->hw[idx->count].word = word;
+	idx->hw[idx->count].offset = p - idx->base;
+	idx->count++;
+    }
+
+    /* Index files are sorted bytewise on the original headwords.
+       Replacing underscores changes that order. */
+    dico_psort(idx->hw, idx->count, sizeof(idx->hw[0]),
+	       compare_headword, NULL);
+    idx->search = dico_search_index_create(idx->count, headword_get, idx,
+					   DICO_SEARCH_CI);
+    if (!idx->search)
+	dico_log(L_WARN, errno, _("cannot build search index for %s"),
+		 partnames[pos]);
     return 0;
 }
 
+/* Headword table.
+
+   Selector-based matches examine each headword of the database.  To
+   avoid reading the index files and consulting the WordNet library for
+   each of them, the headwords of all parts of speech are merged into a
+   single sorted table without duplicates.  Each entry keeps the set of
+   parts of speech of the word and, for each of them, the bitmask of
+   searches available for it. */
+
+struct wn_entry {
+    const char *word;                /* Headword */
+    unsigned posmask;                /* Its parts of speech */
+    unsigned search[NUMPARTS + 1];   /* Searches available for each */
+};
+
+static struct wn_entry *wn_table;
+static size_t wn_table_count;
+
 static int
-lineback(FILE *fp, struct wordbuf *wb)
+compare_entry(const void *a, const void *b, void *closure)
 {
-    int c, i;
-    
-    wordbuf_start(wb);
-    while (fseek(fp, -2, SEEK_CUR) == 0) {
-	if ((c = getc(fp)) == '\n')
-	    break;
-	if (wordbuf_grow(wb, c))
-	    return -1;
+    const struct wn_entry *epa = a;
+    const struct wn_entry *epb = b;
+    return utf8_strcasecmp(epa->word, epb->word);
+}
+
+/* Return the start of the field following the one at P. */
+static const char *
+next_field(const char *p, const char *end)
+{
+    const char *q = memchr(p, ' ', end - p);
+    return q ? q + 1 : end;
+}
+
+/* Compute the bitmask of searches available for the headword whose
+   index line starts at P, the same way is_defined does.  Inherited
+   holonyms and meronyms are not accounted for, because that would
+   require reading the data file. */
+static unsigned
+index_line_search(const char *p, const char *end, int pos)
+{
+    unsigned search = bit(SIMPTR) | bit(FREQ) | bit(SYNS) | bit(WNGREP)
+	              | bit(OVERVIEW);
+    const char *eol = memchr(p, '\n', end - p);
+    long i, n;
+
+    if (eol)
+	end = eol;
+    /* Skip lemma, pos and synset_cnt, and get p_cnt */
+    for (i = 0; i < 3; i++)
+	p = next_field(p, end);
+    for (n = 0; p < end && *p >= '0' && *p <= '9'; p++)
+	n = n * 10 + *p - '0';
+    for (i = 0; i < n && p < end; i++) {
+	char sym[8];
+	size_t len;
+	int ptr;
+
+	p = next_field(p, end);
+	len = headword_length(p, end);
+	if (len >= sizeof(sym))
+	    continue;
+	memcpy(sym, p, len);
+	sym[len] = 0;
+	ptr = getptrtype(sym);
+	if (ptr <= LASTTYPE)
+	    search |= bit(ptr);
+	else if (ptr == INSTANCE)
+	    search |= bit(HYPERPTR);
+	else if (ptr == INSTANCES)
+	    search |= bit(HYPOPTR);
+	if (ptr == SIMPTR)
+	    search |= bit(ANTPTR);
     }
-    if (wordbuf_finish(wb))
-	return -1;
-    wordbuf_reverse(wb);
-    for (i = 0; wb->word[i]; i++) {
-	if (wb->word[i] == ' ')
-	    break;
-	else if (wb->word[i] == '_')
-	    wb->word[i] = ' ';
+    if ((pos == NOUN || pos == VERB) && (search & bit(HYPERPTR)))
+	search |= bit(COORDS);
+    if (pos == VERB)
+	search |= bit(RELATIVES) | bit(FRAMES);
+    return search;
+}
+
+static int
+wn_table_init(void)
+{
+    size_t i, j, n;
+    int pos;
+
+    for (n = 0, pos = 1; pos <= NUMPARTS; pos++)
+	n += wn_index[pos].count;
+    wn_table = calloc(n ? n : 1, sizeof(wn_table[0]));
+    if (!wn_table) {
+	DICO_LOG_MEMERR();
+	return 1;
+    }
+    for (n = 0, pos = 1; pos <= NUMPARTS; pos++) {
+	struct wn_index *idx = &wn_index[pos];
+
+	for (i = 0; i < idx->count; i++, n++) {
+	    wn_table[n].word = idx->hw[i].word;
+	    wn_table[n].posmask = POS_MASK(pos);
+	    wn_table[n].search[pos] =
+		index_line_search(idx->base + idx->hw[i].offset,
+				  idx->base + idx->size, pos);
+	}
+    }
+    dico_psort(wn_table, n, sizeof(wn_table[0]), compare_entry, NULL);
+
+    /* Merge entries for the same headword */
+    for (i = j = 0; i < n; i++) {
+	if (j > 0 && compare_entry(&wn_table[j-1], &wn_table[i], NULL) == 0) {
+	    wn_table[j-1].posmask |= wn_table[i].posmask;
+	    for (pos = 1; pos <= NUMPARTS; pos++)
+		wn_table[j-1].search[pos] |= wn_table[i].search[pos];
+	} else
+	    wn_table[j++] = wn_table[i];
+    }
+    wn_table_count = j;
+    return 0;
+}
+
+static int
+wn_index_init(void)
+{
+    int i;
+
+    for (i = 1; i <= NUMPARTS; i++)
+	if (wn_index_load(&wn_index[i], i))
+	    return 1;
+    return wn_table_init();
+}
+
+/* Return true if one of the searches configured for WNDB is defined
+   for the part of speech POS, SEARCH being the bitmask of searches
+   available for it. */
+static int
+wn_search_enabled(struct wndb *wndb, int pos, unsigned search)
+{
+    int j;
+
+    for (j = 0; j < wndb->optc; j++) {
+	int n;
+
+	if (!(POS_MASK(pos) & wndb->optv[j]->posmask))
+	    continue;
+
+	n = wndb->optv[j]->search;
+	if (n < 0)
+	    n = -n;
+	if (bit(n) & search)
+	    return 1;
     }
     return 0;
 }
@@ -547,89 +732,83 @@ lineback(FILE *fp, struct wordbuf *wb)
 static int
 wn_is_defined(struct wndb *wndb, char *searchword)
 {
-    int i, j;
+    int i;
     unsigned int search;
     
     for (i = 1; i <= NUMPARTS; i++) {
-	if ((search = is_defined(searchword, i)) != 0) {
-	    for (j = 0; j < wndb->optc; j++) {
-		int n;
-
-		if (!(POS_MASK(i) & wndb->optv[j]->posmask))
-		    continue;
-
-		n = wndb->optv[j]->search;
-		if (n < 0)
-		    n = -n;
-		if (bit(n) & search)
-		    return 1;
-	    }
-	}
+	if ((search = is_defined(searchword, i)) != 0
+	    && wn_search_enabled(wndb, i, search))
+	    return 1;
     }
     return 0;
 }
 
-static void
-wn_foreach_db(struct wndb *wndb, int dbn, char *searchword,
-	      struct dico_key *key, struct result *res)
+static int
+wn_entry_defined(struct wndb *wndb, struct wn_entry *ep)
 {
-    FILE *fp = indexfps[dbn];
-    struct wordbuf wb = INIT_WORDBUF;
-    dico_iterator_t itr;
-    char *word;
-    
-    fseek(fp, 0, SEEK_SET);
-    for (skipheader(fp); getword(fp, &wb) == 0; skipeol(fp)) {
-	res->compare_count++;
-	if (dico_key_match(key, wb.word)) {
-	    if (wn_match_result_add(res, wb.word))
-		break;
-	}
-    }
-    free(wb.word);
+    int i;
 
-    itr = dico_list_iterator(res->list);
-    for (word = dico_iterator_first(itr); word;
-	 word = dico_iterator_next(itr)) {
-	if (!wn_is_defined(wndb, word))
-	    dico_iterator_remove_current(itr, NULL);
+    for (i = 1; i <= NUMPARTS; i++) {
+	if ((ep->posmask & POS_MASK(i))
+	    && wn_search_enabled(wndb, i, ep->search[i]))
+	    return 1;
     }
-    dico_iterator_destroy(&itr);
+    return 0;
 }
 
 static struct result *
 wn_foreach(struct wndb *wndb, const dico_strategy_t strat, const char *word)
 {
-    struct result *res = wn_create_match_result(wndb);
+    struct result *res;
     struct dico_key key;
-    char *searchword;
-
-    searchword = strdup(word);
-    strtolower(strsubst(searchword, ' ', '_'));
+    unsigned posmask;
+    size_t i;
 
-    if (!searchword) {
-        DICO_LOG_MEMERR();
-	wn_free_result((dico_result_t) res);
+    res = wn_create_match_result(wndb);
+    if (!res)
 	return NULL;
-    }
-	       
     if (dico_key_init(&key, strat, word)) {
 	dico_log(L_ERR, 0, _("%s: key initialization failed"), __func__);
 	wn_free_result((dico_result_t) res);
-	free(searchword);
 	return NULL;
     }
+
+    switch (wndb->pos) {
+    case ALL_POS:
+	posmask = PM_ALL;
+	break;
+    case ADJSAT:
+	/* Satellites are listed in the adjective index */
+	posmask = POS_MASK(ADJ);
+	break;
+    default:
+	posmask = POS_MASK(wndb->pos);
+    }
 	       
-    if (wndb->pos == ALL_POS) {
-	int i;
+    for (i = 0; i < wn_table_count; i++) {
+	struct wn_entry *ep = &wn_table[i];
+	char *s;
 
-	for (i = 1; i <= NUMPARTS; i++)
-	    wn_foreach_db(wndb, i, searchword, &key, res);
-    } else
-	wn_foreach_db(wndb, wndb->pos, searchword, &key, res);
+	if (!(ep->posmask & posmask))
+	    continue;
+	if (dico_budget_check())
+	    break;
+	res->compare_count++;
+	if (!dico_key_match(&key, ep->word) || !wn_entry_defined(wndb, ep))
+	    continue;
+	if (dico_result_limit_reached(dico_list_count(res->list)))
+	    break;
+	/* The table is sorted and has no duplicates, so the word
+	   can be appended to the list. */
+	s = strdup(ep->word);
+	if (!s || dico_list_append(res->list, s)) {
+	    DICO_LOG_MEMERR();
+	    free(s);
+	    break;
+	}
+    }
     
     dico_key_deinit(&key);
-    free(searchword);
     
     if (dico_list_count(res->list) == 0) {
 	wn_free_result((dico_result_t) res);
@@ -638,45 +817,6 @@ wn_foreach(struct wndb *wndb, const dico_strategy_t strat, const char *word)
     return res;
 }
 
-static off_t
-wn_bsearch(FILE *fp, void *key, int (*cmp)(const char *a, void *b))
-{
-    long top, mid, bot, diff;
-    struct wordbuf wb = INIT_WORDBUF;
-    off_t last_match = -1;
-    
-    fseek(fp, 0L, SEEK_END);
-    top = 0;
-    bot = ftell(fp);
-    mid = (bot - top) / 2;
-
-    do {
-	fseek(fp, mid - 1, SEEK_SET);
-	if (mid != 1)
-	    skipeol(fp);
-	if (getword(fp, &wb))
-	    break;
-	if (cmp(wb.word, key) < 0) {
-	    top = mid;
-	    diff = (bot - top) / 2;
-	    mid = top + diff;
-	} else if (cmp(wb.word, key) > 0) {
-	    bot = mid;
-	    diff = (bot - top) / 2;
-	    mid = top + diff;
-	} else {
-	    /* Move back until first non-matching headword is found */
-	    do
-		last_match = ftell(fp);
-	    while (lineback(fp, &wb) == 0 && cmp(wb.word, key) == 0);
-	    break;
-	}
-    } while (diff);
-
-    free(wb.word);
-    return last_match;
-}
-
 static struct result *
 wn_exact_match(struct wndb *db, const char *hw)
 {
@@ -691,14 +831,17 @@ wn_exact_match(struct wndb *db, const char *hw)
 
 struct prefix {
     const char *str;
-    size_t len;
+    size_t len;                 /* Length of str in characters */
 };
 
 static int
-cmp_pref(const char *hw, void *key)
+compare_prefix(const void *a, const void *b, void *closure)
 {
-    struct prefix *pref = key;
-    return strncasecmp(hw, pref->str, pref->len);
+    const struct prefix *pfx = a;
+    const struct wn_headword *hw = b;
+    if (pfx->len == 0)
+	return 0;
+    return utf8_strncasecmp(pfx->str, hw->word, pfx->len);
 }
 
 static struct result *
@@ -707,29 +850,33 @@ wn_prefix_match(struct wndb *db, const char *hw)
     struct result *res;
     int i;
     struct prefix pfx;
-    struct wordbuf wb = INIT_WORDBUF;
     
     res = wn_create_match_result(db);
     if (!res)
 	return NULL;
     pfx.str = hw;
-    pfx.len = strlen(hw);
+    pfx.len = utf8_strlen(hw);
 
     for (i = 1; i <= NUMPARTS; i++) {
-	FILE *fp = indexfps[i];
-	off_t off;
-
-	off = wn_bsearch(fp, &pfx, cmp_pref);
-	if (off != -1) {
-	    fseek(fp, off, SEEK_SET);
-	    for (;getword(fp, &wb) == 0 && cmp_pref(wb.word, &pfx) == 0;
-		 skipeol(fp)) {
-		if (wn_match_result_add(res, wb.word))
+	struct wn_index *idx = &wn_index[i];
+	size_t start = 0, end = idx->count;
+	struct wn_headword *ep, *last;
+	
+	if (idx->search)
+	    dico_search_index_range(idx->search, hw, 1, &start, &end);
+	ep = dico_bsearch(&pfx, idx->hw + start, end - start,
+			  sizeof(idx->hw[0]), compare_prefix, NULL);
+	if (ep) {
+	    for (last = idx->hw + end;
+		 ep < last && compare_prefix(&pfx, ep, NULL) == 0; ep++) {
+		if (dico_result_limit_reached(dico_list_count(res->list))
+		    || wn_match_result_add(res, ep->word))
 		    break;
 	    }
 	}
+	if (dico_result_truncated())
+	    break;
     }
-    free(wb.word);
     if (dico_list_count(res->list) == 0) {
 	wn_free_result((dico_result_t) res);
 	return NULL;
@@ -854,8 +1001,10 @@ search_defns(struct wndb *wndb, int pos, struct result *res,
 		continue;
 	    ssp = findtheinfo_ds((char*)searchword, pos, wndb->optv[i]->search,
 				 sense);
-	    if (ssp)
+	    if (ssp) {
+		dico_list_append(res->rootlist, ssp);
 		dp->synset[i] = ssp;
+	    }
 	}
 	dico_list_append(res->list, dp);
     } while ((sp = sp->nextss));
@@ -863,41 +1012,6 @@ search_defns(struct wndb *wndb, int pos, struct result *res,
     return 1;
 }
 
-static dico_result_t
-wn_define(dico_handle_t hp, const char *word)
-{
-    struct wndb *wndb = (struct wndb *)hp;
-    struct result *res;
-    int i;
-    int found = 0;
-    char *copy;
-    
-    res = wn_create_define_result(wndb, word);
-    
-    copy = nornmalize_search_word(word);
-    if (!copy) {
-	wn_free_result((dico_result_t) res);
-	return NULL;
-    }
-
-    res->wndb = wndb;
-    res->type = result_define;
-    if (wndb->pos == ALL_POS) {
-	for (i = 1; i <= NUMPARTS; i++)
-	    found += search_defns(wndb, i, res, copy);
-    } else
-	found = search_defns(wndb, wndb->pos, res, copy);
-
-    if (!found) {
-	free(copy);
-	wn_free_result((dico_result_t) res);
-	return NULL;
-    }
-    free(copy);
-    
-    return (dico_result_t)res;
-}
-
 static void
 format_word(const char *word, dico_stream_t str)
 {
@@ -1002,7 +1116,8 @@ format_defn(struct defn *defn, struct result *res, dico_stream_t str)
     struct wndb *wndb = res->wndb;
 
     for (i = 0; i < wndb->optc; i++)
-	wndb->optv[i]->printer(wndb->optv[i], defn->synset[i], res, str);
+	if (defn->synset[i])
+	    wndb->optv[i]->printer(wndb->optv[i], defn->synset[i], res, str);
     return 0;
 }
 
@@ -1048,28 +1163,201 @@ format_all_defns(struct result *res, dico_stream_t str)
     }
 }
 
+/* Rendered definitions are cached by the search word.  Each database
+   has its own cache, because the rendering depends on its parameters. */
+
+static struct wn_defs *
+defs_alloc(size_t count, size_t len)
+{
+    struct wn_defs *defs;
+    size_t size = sizeof(*defs) + (count + 1) * sizeof(defs->off[0]) + len;
+
+    defs = malloc(size);
+    if (!defs) {
+	DICO_LOG_ERRNO();
+	return NULL;
+    }
+    defs->size = size;
+    defs->count = count;
+    defs->len = len;
+    defs->off = (size_t *) (defs + 1);
+    defs->text = (char *) (defs->off + count + 1);
+    return defs;
+}
+
+static struct wn_defs *
+defs_copy(struct wn_defs *src)
+{
+    struct wn_defs *defs = defs_alloc(src->count, src->len);
+    if (defs) {
+	memcpy(defs->off, src->off, (src->count + 1) * sizeof(src->off[0]));
+	memcpy(defs->text, src->text, src->len);
+    }
+    return defs;
+}
+
+/* A memory stream collecting rendered text */
+struct textbuf {
+    char *base;
+    size_t len;
+    size_t size;
+};
+
+static int
+textbuf_write(void *data, const char *buf, size_t size, size_t *pret)
+{
+    struct textbuf *tb = data;
+
+    if (tb->len + size > tb->size) {
+	size_t n = tb->size ? tb->size : 1024;
+	char *p;
+
+	while (tb->len + size > n)
+	    n *= 2;
+	p = realloc(tb->base, n);
+	if (!p)
+	    return ENOMEM;
+	tb->base = p;
+	tb->size = n;
+    }
+    memcpy(tb->base + tb->len, buf, size);
+    tb->len += size;
+    if (pret)
+	*pret = size;
+    return 0;
+}
+
+/* Look up the definitions of WORD in the WordNet database and render
+   them.  Return rendered definitions (possibly none), or NULL on
+   error. */
+static struct wn_defs *
+wn_render_defs(struct wndb *wndb, const char *word)
+{
+    struct result *res;
+    struct wn_defs *defs = NULL;
+    struct textbuf tb = { NULL, 0, 0 };
+    dico_stream_t str = NULL;
+    size_t i, count;
+    size_t *off = NULL;
+    char *copy;
+    
+    res = wn_create_define_result(wndb, word);
+    if (!res)
+	return NULL;
+    
+    copy = nornmalize_search_word(word);
+    if (!copy) {
+	wn_free_result((dico_result_t) res);
+	return NULL;
+    }
+
+    if (wndb->pos == ALL_POS) {
+	for (i = 1; i <= NUMPARTS; i++)
+	    search_defns(wndb, i, res, copy);
+    } else
+	search_defns(wndb, wndb->pos, res, copy);
+    free(copy);
+
+    count = dico_list_count(res->list);
+    if (count > 0 && (wndb->flags & WNDB_MERGE_DEFS))
+	count = 1;
+    off = calloc(count + 1, sizeof(off[0]));
+    res->itr = dico_list_iterator(res->list);
+    if (!off || !res->itr
+	|| dico_stream_create(&str, DICO_STREAM_WRITE, &tb)) {
+	DICO_LOG_ERRNO();
+	goto end;
+    }
+    dico_stream_set_write(str, textbuf_write);
+
+    for (i = 0; i < count; i++) {
+	off[i] = tb.len;
+	if (wndb->flags & WNDB_MERGE_DEFS)
+	    format_all_defns(res, str);
+	else
+	    format_defn(dico_iterator_item(res->itr, i), res, str);
+    }
+    off[count] = tb.len;
+    if (dico_stream_last_error(str)) {
+	DICO_LOG_MEMERR();
+	goto end;
+    }
+
+    defs = defs_alloc(count, tb.len);
+    if (defs) {
+	memcpy(defs->off, off, (count + 1) * sizeof(off[0]));
+	memcpy(defs->text, tb.base, tb.len);
+    }
+    
+ end:
+    dico_stream_destroy(&str);
+    free(tb.base);
+    free(off);
+    wn_free_result((dico_result_t) res);
+    return defs;
+}
+
+static dico_result_t
+wn_define(dico_handle_t hp, const char *word)
+{
+    struct wndb *wndb = (struct wndb *)hp;
+    struct result *res;
+    struct wn_defs *defs;
+
+    defs = dico_cache_lookup(wndb->cache, word, strlen(word));
+    if (defs)
+	defs = defs_copy(defs);
+    else {
+	struct wn_defs *copy;
+	
+	defs = wn_render_defs(wndb, word);
+	if (!defs)
+	    return NULL;
+	if (dico_cache_fits(wndb->cache, defs->size)
+	    && (copy = defs_copy(defs)) != NULL
+	    && dico_cache_insert(wndb->cache, word, strlen(word),
+				 copy, copy->size))
+	    free(copy);
+    }
+    if (!defs)
+	return NULL;
+    if (defs->count == 0) {
+	free(defs);
+	return NULL;
+    }
+    
+    res = calloc(1, sizeof(*res));
+    if (!res) {
+        DICO_LOG_ERRNO();
+	free(defs);
+	return NULL;
+    }
+    res->type = result_define;
+    res->wndb = wndb;
+    res->defs = defs;
+    return (dico_result_t)res;
+}
+
 int
 wn_output_result(dico_result_t rp, size_t n, dico_stream_t str)
 {
     struct result *res = (struct result *) rp;
     void *item;
     
-    if (!res->itr) {
-	res->itr = dico_list_iterator(res->list);
-	if (!res->itr)
-	    return 1;
-    }
-    item = dico_iterator_item(res->itr, n);
     switch (res->type) {
     case result_match:
+	if (!res->itr) {
+	    res->itr = dico_list_iterator(res->list);
+	    if (!res->itr)
+		return 1;
+	}
+	item = dico_iterator_item(res->itr, n);
 	dico_stream_write(str, item, strlen((char*)item));
 	break;
 
     case result_define:
-	if (res->wndb->flags & WNDB_MERGE_DEFS)
-	    format_all_defns(res, str);
-	else
-	    format_defn(item, res, str);
+	dico_stream_write(str, res->defs->text + res->defs->off[n],
+			  res->defs->off[n+1] - res->defs->off[n]);
 	break;
 	    
     default:
@@ -1082,8 +1370,8 @@ static size_t
 wn_result_count (dico_result_t rp)
 {
     struct result *res = (struct result *) rp;
-    if (res->type == result_define && (res->wndb->flags & WNDB_MERGE_DEFS))
-	    return 1;
+    if (res->type == result_define)
+	return res->defs->count;
     return dico_list_count(res->list);
 }
 
@@ -1103,6 +1391,7 @@ wn_free_result(dico_result_t rp)
     dico_iterator_destroy(&res->itr);
     dico_list_destroy(&res->rootlist);
     free(res->searchword);
+    free(res->defs);
     free(res);
 }
 
@@ -17,6 +17,7 @@
 #include <config.h>
 #include <xdico.h>
 #include <stdio.h>
+#include <string.h>
 #include <ctype.h>
 #include <libi18n.h>
 
@@ -26,6 +27,34 @@ stream_writez(dico_stream_t str, const char *buf)
     return dico_stream_write(str, buf, strlen(buf));
 }
 
+#define WRITEZV_MAX 16
+
+/* Write the strings given by the variable argument list, terminated by
+   NULL, to STR using as few write operations as possible. */
+int
+stream_writezv(dico_stream_t str, ...)
+{
+    struct iovec iov[WRITEZV_MAX];
+    int n = 0, rc = 0;
+    const char *s;
+    va_list ap;
+
+    va_start(ap, str);
+    while ((s = va_arg(ap, const char *)) != NULL) {
+	iov[n].iov_base = (void*) s;
+	iov[n].iov_len = strlen(s);
+	if (++n == WRITEZV_MAX) {
+	    if ((rc = dico_stream_writev(str, iov, n)))
+		break;
+	    n = 0;
+	}
+    }
+    va_end(ap);
+    if (rc == 0 && n)
+	rc = dico_stream_writev(str, iov, n);
+    return rc;
+}
+
 int
 stream_printf(dico_stream_t str, const char *fmt, ...)
 {